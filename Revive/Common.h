@@ -1,12 +1,13 @@
 #pragma once
 
 #include "microprofile.h"
+#include "TraceRecorder.h"
 
 #if 0
 #include <Windows.h>
 #define REV_TRACE(x) OutputDebugStringA("Revive: " #x "\n");
 #else
-#define REV_TRACE(x) MICROPROFILE_SCOPEI("Revive", #x, 0xff0000);
+#define REV_TRACE(x) REV_TRACE_SCOPE(x); MICROPROFILE_SCOPEI("Revive", #x, 0xff0000);
 #endif
 
 extern unsigned int g_MinorVersion;
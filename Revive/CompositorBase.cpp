@@ -52,23 +52,17 @@ CompositorBase::CompositorBase()
 	, m_OverlayCount(0)
 	, m_ActiveOverlays()
 	, m_FrameEvents()
+	, m_Pacer()
 #if MICROPROFILE_ENABLED
 	, m_ProfileTexture()
 #endif
 {
 	// We want to handle all graphics tasks explicitly instead of implicitly letting WaitGetPoses execute them
 	vr::VRCompositor()->SetExplicitTimingMode(vr::VRCompositorTimingMode_Explicit_ApplicationPerformsPostPresentHandoff);
-
-	// Create a ring buffer of events
-	for (int i = 0; i < MAX_QUEUE_AHEAD; i++)
-		m_FrameEvents[i] = CreateEvent(nullptr, true, i == 0, nullptr);
 }
 
 CompositorBase::~CompositorBase()
 {
-	for (int i = 0; i < MAX_QUEUE_AHEAD; i++)
-		CloseHandle(m_FrameEvents[i]);
-
 	if (m_MirrorTexture)
 		delete m_MirrorTexture;
 
@@ -77,7 +71,7 @@ CompositorBase::~CompositorBase()
 #endif
 }
 
-ovrResult CompositorBase::CreateTextureSwapChain(const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* out_TextureSwapChain)
+ovrResult CompositorBase::CreateTextureSwapChain(ovrSession session, const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* out_TextureSwapChain)
 {
 #if MICROPROFILE_ENABLED
 	if (!m_ProfileTexture)
@@ -92,8 +86,12 @@ ovrResult CompositorBase::CreateTextureSwapChain(const ovrTextureSwapChainDesc*
 	ovrTextureSwapChain swapChain = new ovrTextureSwapChainData(*desc);
 	swapChain->Identifier = m_ChainCount++;
 
+	// Titles that are sensitive to latency can use a shorter swapchain through their profile
+	static_assert(REV_COMPAT_MAX_SWAPCHAIN_DEPTH <= REV_SWAPCHAIN_MAX_LENGTH, "The swapchain depth must fit in the swapchain");
 	if (desc->StaticImage)
 		swapChain->Length = 1;
+	else if (session->Details->Profile.SwapchainDepth)
+		swapChain->Length = session->Details->Profile.SwapchainDepth;
 
 	for (int i = 0; i < swapChain->Length; i++)
 	{
@@ -131,6 +129,7 @@ ovrResult CompositorBase::CreateMirrorTexture(const ovrMirrorTextureDesc* desc,
 
 ovrResult CompositorBase::WaitToBeginFrame(ovrSession session, long long frameIndex)
 {
+	REV_TRACE_SCOPE(WaitToBeginFrame);
 	MICROPROFILE_SCOPE(WaitToBeginFrame);
 
 	bool timeout = false;
@@ -138,27 +137,41 @@ ovrResult CompositorBase::WaitToBeginFrame(ovrSession session, long long frameIn
 	{
 		// Wait on the last frame completion with a 500ms timeout
 		assert(frameIndex - session->FrameIndex < MAX_QUEUE_AHEAD);
-		timeout = WaitForSingleObject(m_FrameEvents[(frameIndex - 1) % MAX_QUEUE_AHEAD], 500) != WAIT_OBJECT_0;
+		timeout = !m_FrameEvents.Wait(frameIndex - 1, 500);
 	}
 
 	// Wait for the actual frame start
 	if (!session->Details->UseHack(SessionDetails::HACK_WAIT_ON_SUBMIT))
 	{
-		MICROPROFILE_SCOPE(WaitGetPoses);
-		vr::VRCompositor()->WaitGetPoses(nullptr, 0, nullptr, 0);
+		{
+			REV_TRACE_SCOPE(WaitGetPoses);
+			MICROPROFILE_SCOPE(WaitGetPoses);
+			vr::VRCompositor()->WaitGetPoses(nullptr, 0, nullptr, 0);
+		}
+
+		// Release the app just in time to finish before the compositor deadline
+		if (session->Details->Profile.FramePacing)
+			m_Pacer.WaitForRelease(session->Details->GetRefreshRate());
 	}
 	return timeout ? ovrError_Timeout : ovrSuccess;
 }
 
 ovrResult CompositorBase::BeginFrame(ovrSession session, long long frameIndex)
 {
+	REV_TRACE_SCOPE(BeginFrame);
 	MICROPROFILE_SCOPE(BeginFrame);
 
 	// Reset the event in the frame ring buffer
-	ResetEvent(m_FrameEvents[frameIndex % MAX_QUEUE_AHEAD]);
+	m_FrameEvents.Reset(frameIndex);
 
 	session->FrameIndex = frameIndex;
 	vr::VRCompositor()->SubmitExplicitTimingData();
+
+	// Let the session thread handle any pending events
+	SetEvent(session->SessionEvent);
+
+	// Poses queried during the previous frame are stale now
+	session->Input->InvalidateTrackingState();
 	return session->Input->UpdateInputState();
 }
 
@@ -174,11 +187,14 @@ const ovrLayer_Union& CompositorBase::ToUnion(const ovrLayerHeader* layerPtr)
 
 ovrResult CompositorBase::EndFrame(ovrSession session, long long frameIndex, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
 {
+	REV_TRACE_SCOPE(EndFrame);
 	MICROPROFILE_SCOPE(EndFrame);
 
 	if (layerCount == 0 || !layerPtrList || frameIndex < session->FrameIndex)
 		return ovrError_InvalidParameter;
 
+	m_Pacer.EndFrame();
+
 	const ovrLayerHeader* baseLayer = nullptr;
 	std::vector<vr::VROverlayHandle_t> activeOverlays;
 	for (uint32_t i = 0; i < layerCount; i++)
@@ -261,12 +277,22 @@ ovrResult CompositorBase::EndFrame(ovrSession session, long long frameIndex, ovr
 
 	if (session->Details->UseHack(SessionDetails::HACK_WAIT_ON_SUBMIT))
 	{
+		REV_TRACE_SCOPE(WaitGetPoses);
 		MICROPROFILE_SCOPE(WaitGetPoses);
 		vr::VRCompositor()->WaitGetPoses(nullptr, 0, nullptr, 0);
 	}
 
 	// Frame now completed so we can let anyone waiting on the next frame call WaitGetPoses
-	SetEvent(m_FrameEvents[frameIndex % MAX_QUEUE_AHEAD]);
+	m_FrameEvents.Signal(frameIndex);
+
+	// Feed the GPU time of the app to the performance scale once for every compositor frame
+	vr::Compositor_FrameTiming timing = { sizeof(vr::Compositor_FrameTiming) };
+	if (vr::VRCompositor()->GetFrameTiming(&timing, 0) && timing.m_nFrameIndex != session->PerfScaleFrame)
+	{
+		float gpuTime = (timing.m_flPreSubmitGpuMs + timing.m_flPostSubmitGpuMs) / 1000.0f;
+		session->PerfScale.AddFrame(gpuTime, 1.0f / session->Details->GetRefreshRate());
+		session->PerfScaleFrame = timing.m_nFrameIndex;
+	}
 
 	if (m_MirrorTexture && error == vr::VRCompositorError_None)
 		RenderMirrorTexture(m_MirrorTexture);
@@ -327,6 +353,7 @@ vr::VRTextureBounds_t CompositorBase::ViewportToTextureBounds(ovrRecti viewport,
 
 void CompositorBase::BlitLayers(const ovrLayerHeader* dstLayer, const ovrLayerHeader* srcLayer)
 {
+	REV_TRACE_SCOPE(BlitLayers);
 	MICROPROFILE_SCOPE(BlitLayers);
 
 	const ovrLayer_Union& dst = ToUnion(dstLayer);
@@ -379,6 +406,7 @@ void CompositorBase::BlitLayers(const ovrLayerHeader* dstLayer, const ovrLayerHe
 
 vr::VRCompositorError CompositorBase::SubmitLayer(ovrSession session, const ovrLayerHeader* baseLayer)
 {
+	REV_TRACE_SCOPE(SubmitLayer);
 	MICROPROFILE_SCOPE(SubmitLayer);
 
 	const ovrLayer_Union& layer = ToUnion(baseLayer);
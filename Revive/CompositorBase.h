@@ -1,13 +1,14 @@
 #pragma once
 
 #include "TextureBase.h"
+#include "FrameEventRing.h"
+#include "FramePacer.h"
 #include "OVR_CAPI.h"
 
 #include <openvr.h>
+#include <atomic>
 #include <vector>
 
-#define MAX_QUEUE_AHEAD 5
-
 class CompositorBase
 {
 public:
@@ -19,7 +20,7 @@ public:
 	virtual TextureBase* CreateTexture() = 0;
 
 	// Texture Swapchain
-	ovrResult CreateTextureSwapChain(const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* out_TextureSwapChain);
+	ovrResult CreateTextureSwapChain(ovrSession session, const ovrTextureSwapChainDesc* desc, ovrTextureSwapChain* out_TextureSwapChain);
 	virtual void RenderTextureSwapChain(vr::EVREye eye, TextureBase* src, TextureBase* dst, ovrRecti viewport, vr::VRTextureBounds_t bounds, vr::HmdVector4_t quad) = 0;
 
 	// Mirror Texture
@@ -51,7 +52,10 @@ private:
 	std::vector<vr::VROverlayHandle_t> m_ActiveOverlays;
 
 	// Call order enforcement
-	void* m_FrameEvents[MAX_QUEUE_AHEAD];
+	FrameEventRing m_FrameEvents;
+
+	// Frame pacing
+	FramePacer m_Pacer;
 
 #if MICROPROFILE_ENABLED
 	// Microprofile
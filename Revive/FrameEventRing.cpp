@@ -0,0 +1,70 @@
+#include "FrameEventRing.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+#endif
+
+static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t), "The frame events are waited on as plain words");
+
+static void WaitOnEvent(std::atomic_uint32_t& event, uint32_t pending, unsigned long timeout)
+{
+#ifdef _WIN32
+	WaitOnAddress(&event, (PVOID)&pending, sizeof(pending), timeout);
+#else
+	// The futex only blocks if the event still holds the pending value
+	timespec ts = { (time_t)(timeout / 1000), (long)(timeout % 1000) * 1000000 };
+	syscall(SYS_futex, (uint32_t*)&event, FUTEX_WAIT_PRIVATE, pending, &ts, nullptr, 0);
+#endif
+}
+
+static void WakeEvent(std::atomic_uint32_t& event)
+{
+#ifdef _WIN32
+	WakeByAddressAll(&event);
+#else
+	syscall(SYS_futex, (uint32_t*)&event, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+FrameEventRing::FrameEventRing()
+{
+	for (int i = 0; i < MAX_QUEUE_AHEAD; i++)
+		m_Events[i].store(i == 0, std::memory_order_relaxed);
+}
+
+void FrameEventRing::Reset(long long frameIndex)
+{
+	GetEvent(frameIndex).store(0, std::memory_order_release);
+}
+
+void FrameEventRing::Signal(long long frameIndex)
+{
+	std::atomic_uint32_t& event = GetEvent(frameIndex);
+	event.store(1, std::memory_order_release);
+	WakeEvent(event);
+}
+
+bool FrameEventRing::Wait(long long frameIndex, unsigned long timeout)
+{
+	// Wait in user-space until the frame is signaled, this only enters the kernel if we need to block
+	const uint32_t pending = 0;
+	std::atomic_uint32_t& event = GetEvent(frameIndex);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (event.load(std::memory_order_acquire) == pending)
+	{
+		unsigned long elapsed = (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		if (elapsed >= timeout)
+			return false;
+		WaitOnEvent(event, pending, timeout - elapsed);
+	}
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#define MAX_QUEUE_AHEAD 5
+
+// Call order enforcement, a ring buffer of frame completion flags. Waiting spins on the flag in
+// user-space and only enters the kernel to block, using WaitOnAddress on Windows and a futex on Linux.
+class FrameEventRing
+{
+public:
+	// Only the frame before the first one is complete
+	FrameEventRing();
+
+	// Marks the frame as in progress, called when the frame begins
+	void Reset(long long frameIndex);
+
+	// Marks the frame as complete and wakes up all threads waiting on it
+	void Signal(long long frameIndex);
+
+	// Returns false if the frame didn't complete within the timeout in milliseconds
+	bool Wait(long long frameIndex, unsigned long timeout);
+
+private:
+	std::atomic_uint32_t m_Events[MAX_QUEUE_AHEAD];
+
+	std::atomic_uint32_t& GetEvent(long long frameIndex) { return m_Events[frameIndex % MAX_QUEUE_AHEAD]; }
+};
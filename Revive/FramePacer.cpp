@@ -0,0 +1,79 @@
+#include "FramePacer.h"
+#include "Common.h"
+#include "OVR_CAPI.h"
+
+#include <Windows.h>
+#include <openvr.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+FramePacer::FramePacer()
+	: m_Timer(nullptr)
+	, m_Model()
+	, m_ReleaseTime(0.0)
+{
+	// High-resolution timers are only supported since Windows 10 1803
+	m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!m_Timer)
+		m_Timer = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+}
+
+FramePacer::~FramePacer()
+{
+	CloseHandle(m_Timer);
+}
+
+void FramePacer::WaitForRelease(float refreshRate)
+{
+	{
+		std::lock_guard<std::mutex> lk(m_Mutex);
+		m_ReleaseTime = 0.0;
+	}
+
+	float secondsSinceVsync;
+	uint64_t vsyncCounter;
+	if (refreshRate <= 0.0f || !vr::VRSystem()->GetTimeSinceLastVsync(&secondsSinceVsync, &vsyncCounter))
+		return;
+
+	// The GPU work of the app has to complete before the deadline as well
+	vr::Compositor_FrameTiming timing = { sizeof(vr::Compositor_FrameTiming) };
+	bool hasTiming = vr::VRCompositor()->GetFrameTiming(&timing, 0);
+
+	double delay;
+	{
+		std::lock_guard<std::mutex> lk(m_Mutex);
+
+		// Stop pacing for a while if a vsync was skipped, the app needs all the time it can get
+		if (m_Model.AddVsync(vsyncCounter))
+			MICROPROFILE_COUNTER_ADD("Compositor/PacingBackoffs", 1);
+		if (hasTiming)
+			m_Model.AddGpuTime(timing.m_flTotalRenderGpuMs / 1000.0);
+		delay = m_Model.GetDelay(1.0 / refreshRate, secondsSinceVsync);
+	}
+
+	if (delay > 0.0)
+	{
+		REV_TRACE_SCOPE(PaceFrame);
+		MICROPROFILE_SCOPEI("Compositor", "PaceFrame", 0x00ff00);
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -(LONGLONG)(delay * 1.0e7);
+		SetWaitableTimer(m_Timer, &dueTime, 0, nullptr, nullptr, FALSE);
+		WaitForSingleObject(m_Timer, INFINITE);
+	}
+
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	m_ReleaseTime = ovr_GetTimeInSeconds();
+}
+
+void FramePacer::EndFrame()
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	if (m_ReleaseTime <= 0.0)
+		return;
+
+	// Track the CPU time from the release until the frame is submitted
+	m_Model.AddCpuTime(ovr_GetTimeInSeconds() - m_ReleaseTime);
+	m_ReleaseTime = 0.0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "FramePacingModel.h"
+
+#include <mutex>
+
+// Tracks the app frame time and the compositor vsync history to decide when to release the app
+// thread, so it finishes its frame just before the compositor deadline instead of idling after it.
+// WaitForRelease and EndFrame may be called from different threads.
+class FramePacer
+{
+public:
+	FramePacer();
+	~FramePacer();
+
+	// Holds back the app thread after the compositor started the frame
+	void WaitForRelease(float refreshRate);
+	void EndFrame();
+
+private:
+	void* m_Timer;
+
+	// Protects the model and the release time, but isn't held while waiting
+	std::mutex m_Mutex;
+	FramePacingModel m_Model;
+	double m_ReleaseTime;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+
+// Minimum number of frames to measure before pacing
+#define REV_PACING_MIN_FRAMES 30
+// Number of frames to stop pacing after a missed frame
+#define REV_PACING_BACKOFF_FRAMES 90
+// Time the compositor needs after the app submitted its frame
+#define REV_PACING_MARGIN 0.002
+// Weight of the latest frame in the moving averages
+#define REV_PACING_ALPHA 0.1
+// Shortest delay that's worth the wakeup
+#define REV_PACING_MIN_DELAY 0.0005
+
+// The decisions of the frame pacer without any timers or runtime calls, so it can be simulated.
+// All times are in seconds.
+class FramePacingModel
+{
+public:
+	FramePacingModel()
+		: m_CpuTimeMean(0.0)
+		, m_CpuTimeVar(0.0)
+		, m_GpuTimeMean(0.0)
+		, m_Frames(0)
+		, m_LastVsyncCounter(0)
+		, m_Backoff(0)
+	{
+	}
+
+	// Returns true if a vsync was skipped since the last frame, which stops pacing for a while
+	bool AddVsync(uint64_t vsyncCounter)
+	{
+		bool missed = m_LastVsyncCounter > 0 && vsyncCounter - m_LastVsyncCounter > 1;
+		if (missed)
+			m_Backoff = REV_PACING_BACKOFF_FRAMES;
+		m_LastVsyncCounter = vsyncCounter;
+		return missed;
+	}
+
+	void AddGpuTime(double gpuTime)
+	{
+		m_GpuTimeMean += REV_PACING_ALPHA * (gpuTime - m_GpuTimeMean);
+	}
+
+	// The CPU time from the release of the app until it submitted the frame
+	void AddCpuTime(double cpuTime)
+	{
+		double diff = cpuTime - m_CpuTimeMean;
+		m_CpuTimeMean += REV_PACING_ALPHA * diff;
+		m_CpuTimeVar = (1.0 - REV_PACING_ALPHA) * (m_CpuTimeVar + REV_PACING_ALPHA * diff * diff);
+		m_Frames++;
+	}
+
+	// Returns how long the app should be held back, called once per frame after the compositor started it
+	double GetDelay(double period, double secondsSinceVsync)
+	{
+		if (m_Backoff > 0)
+		{
+			m_Backoff--;
+			return 0.0;
+		}
+
+		if (m_Frames < REV_PACING_MIN_FRAMES)
+			return 0.0;
+
+		// The frame we're starting now will be displayed on the vsync after the next one
+		double deadline = (period - secondsSinceVsync) + period - REV_PACING_MARGIN;
+		double cost = m_CpuTimeMean + 3.0 * sqrt(m_CpuTimeVar) + m_GpuTimeMean;
+		double delay = std::min(deadline - cost, period / 2.0);
+		return delay > REV_PACING_MIN_DELAY ? delay : 0.0;
+	}
+
+private:
+	// Exponential moving averages of the frame cost
+	double m_CpuTimeMean;
+	double m_CpuTimeVar;
+	double m_GpuTimeMean;
+	uint32_t m_Frames;
+
+	// Vsync history
+	uint64_t m_LastVsyncCounter;
+	uint32_t m_Backoff;
+};
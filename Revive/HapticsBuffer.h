@@ -1,11 +1,9 @@
 #pragma once
 
 #include "OVR_CAPI.h"
+#include "HapticsSegment.h"
 
 #include <atomic>
-#include <mutex>
-
-#define REV_HAPTICS_SAMPLE_RATE 320
 
 class HapticsBuffer
 {
@@ -16,6 +14,7 @@ public:
 	void AddSamples(const ovrHapticsBuffer* buffer);
 	void SetConstant(float frequency, float amplitude);
 	float GetSample();
+	bool PeekSegment(const HapticsEnvelope& envelope, HapticsSegment* outSegment);
 	ovrHapticsPlaybackState GetState();
 
 private:
@@ -24,11 +23,10 @@ private:
 	std::atomic_uint8_t m_WriteIndex;
 	uint8_t m_Buffer[OVR_HAPTICS_BUFFER_SAMPLES_MAX];
 
-	// Constant feedback, uses locks
-	std::mutex m_ConstantMutex;
+	// Constant feedback, lock-less as well since a torn update only lasts a single sample
 	std::atomic_uint16_t m_ConstantTimeout;
-	float m_Frequency;
-	float m_Amplitude;
+	std::atomic<float> m_Frequency;
+	std::atomic<float> m_Amplitude;
 };
 
 static_assert(OVR_HAPTICS_BUFFER_SAMPLES_MAX == 256, "The Haptics Buffer is designed for 256 samples");
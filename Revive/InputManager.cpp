@@ -1,4 +1,5 @@
 #include "InputManager.h"
+#include "Common.h"
 #include "Session.h"
 #include "SessionDetails.h"
 #include "CompositorBase.h"
@@ -230,16 +231,32 @@ ovrPoseStatef InputManager::TrackedDevicePoseToOVRPose(vr::TrackedDevicePose_t p
 
 void InputManager::GetTrackingState(ovrSession session, ovrTrackingState* outState, double absTime)
 {
-	if (session->Details->UseHack(SessionDetails::HACK_WAIT_IN_TRACKING_STATE))
+	bool waitPoses = session->Details->UseHack(SessionDetails::HACK_WAIT_IN_TRACKING_STATE);
+	if (waitPoses)
 		vr::VRCompositor()->WaitGetPoses(nullptr, 0, nullptr, 0);
 
+	// Return the same state for repeated queries within the same frame, a time of zero means "now"
+	// and waiting for poses changes the result so we can't cache those
+	vr::ETrackingUniverseOrigin origin = session->TrackingOrigin;
+	bool cacheable = absTime > 0.0f && !waitPoses;
+	int64_t cacheTime = int64_t(absTime * 1.0e9);
+	uint32_t epoch = m_TrackingCache.Epoch();
+	if (cacheable)
+	{
+		if (m_TrackingCache.Get(cacheTime, (uint64_t)origin, outState))
+		{
+			MICROPROFILE_COUNTER_ADD("Tracking/PoseCacheHits", 1);
+			return;
+		}
+		MICROPROFILE_COUNTER_ADD("Tracking/PoseCacheMisses", 1);
+	}
+
 	// Calculate the relative prediction time
 	float relTime = 0.0f;
 	if (absTime > 0.0f)
 		relTime = float(absTime - ovr_GetTimeInSeconds());
 
 	// Get the device poses
-	vr::ETrackingUniverseOrigin origin = session->TrackingOrigin;
 	vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
 	if (absTime > 0.0f && session->Details->UseHack(SessionDetails::HACK_STRICT_POSES))
 	{
@@ -285,6 +302,9 @@ void InputManager::GetTrackingState(ovrSession session, ovrTrackingState* outSta
 	// TODO: Calibrate the origin ourselves instead of relying on OpenVR.
 	outState->CalibratedOrigin.Orientation = OVR::Quatf::Identity();
 	outState->CalibratedOrigin.Position = OVR::Vector3f();
+
+	if (cacheable)
+		m_TrackingCache.Put(epoch, cacheTime, (uint64_t)origin, *outState);
 }
 
 ovrResult InputManager::GetDevicePoses(ovrTrackedDeviceType* deviceTypes, int deviceCount, double absTime, ovrPoseStatef* outDevicePoses)
@@ -357,27 +377,9 @@ OVR::Vector2f InputManager::InputDevice::ApplyDeadzone(OVR::Vector2f axis, float
 	}
 }
 
-void InputManager::OculusTouch::HapticsThread(OculusTouch* device)
-{
-	std::chrono::microseconds freq(std::chrono::seconds(1));
-	freq /= REV_HAPTICS_SAMPLE_RATE;
-
-	while (device->m_bHapticsRunning)
-	{
-		vr::TrackedDeviceIndex_t touch = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(device->Role);
-
-		float sample = (device->m_Haptics.GetSample() + device->m_Haptics.GetSample()) / 2.0f;
-		if (sample > 0.0f)
-			vr::VRSystem()->TriggerHapticPulse(touch, 0, (uint16_t)(freq.count() * sample));
-
-		std::this_thread::sleep_for(freq);
-	}
-}
-
 InputManager::OculusTouch::OculusTouch(vr::VRActionSetHandle_t actionSet, vr::ETrackedControllerRole role)
 	: InputDevice(actionSet)
 	, Role(role)
-	, m_bHapticsRunning(true)
 {
 	/** Returns a handle for any path in the input system. E.g. /user/hand/right */
 	vr::VRInput()->GetInputSourceHandle(role == vr::TrackedControllerRole_RightHand ? "/user/hand/right" : "/user/hand/left", &Handle);
@@ -406,13 +408,18 @@ InputManager::OculusTouch::OculusTouch(vr::VRActionSetHandle_t actionSet, vr::ET
 
 #undef GET_HANDED_ACTION
 
-	m_HapticsThread = std::thread(HapticsThread, this);
+	// Legacy haptic pulses can't be longer than a single sample, so they can't be coalesced
+	HapticsEnvelope envelope = { 1, 1, 0, false };
+	HapticsScheduler::Get().AddOutput(&m_Haptics, envelope, [role](const HapticsSegment& segment)
+	{
+		vr::TrackedDeviceIndex_t touch = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(role);
+		vr::VRSystem()->TriggerHapticPulse(touch, 0, (uint16_t)(segment.Amplitude * 1000000 / REV_HAPTICS_SAMPLE_RATE));
+	});
 }
 
 InputManager::OculusTouch::~OculusTouch()
 {
-	m_bHapticsRunning = false;
-	m_HapticsThread.join();
+	HapticsScheduler::Get().RemoveOutput(&m_Haptics);
 }
 
 ovrControllerType InputManager::OculusTouch::GetType()
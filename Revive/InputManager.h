@@ -1,6 +1,8 @@
 #pragma once
 
 #include "HapticsBuffer.h"
+#include "HapticsScheduler.h"
+#include "TrackingCache.h"
 #include "OVR_CAPI.h"
 #include "Extras/OVR_Math.h"
 
@@ -76,8 +78,8 @@ public:
 		virtual bool IsConnected() const;
 		virtual bool GetInputState(ovrSession session, ovrInputState* inputState);
 
-		virtual void SetVibration(float frequency, float amplitude) { m_Haptics.SetConstant(frequency, amplitude); }
-		virtual void SubmitVibration(const ovrHapticsBuffer* buffer) { m_Haptics.AddSamples(buffer); }
+		virtual void SetVibration(float frequency, float amplitude) { m_Haptics.SetConstant(frequency, amplitude); HapticsScheduler::Get().Wake(); }
+		virtual void SubmitVibration(const ovrHapticsBuffer* buffer) { m_Haptics.AddSamples(buffer); HapticsScheduler::Get().Wake(); }
 		virtual void GetVibrationState(ovrHapticsPlaybackState* outState) { *outState = m_Haptics.GetState(); }
 
 		vr::ETrackedControllerRole Role;
@@ -105,10 +107,6 @@ public:
 		vr::VRActionHandle_t m_Button_HandTrigger;
 
 		HapticsBuffer m_Haptics;
-		std::atomic_bool m_bHapticsRunning;
-
-		std::thread m_HapticsThread;
-		static void HapticsThread(OculusTouch* device);
 	};
 
 	class OculusRemote : public InputDevice
@@ -180,6 +178,7 @@ public:
 	ovrResult GetControllerVibrationState(ovrSession session, ovrControllerType controllerType, ovrHapticsPlaybackState* outState);
 
 	void GetTrackingState(ovrSession session, ovrTrackingState* outState, double absTime);
+	void InvalidateTrackingState() { m_TrackingCache.Invalidate(); }
 	ovrResult GetDevicePoses(ovrTrackedDeviceType* deviceTypes, int deviceCount, double absTime, ovrPoseStatef* outDevicePoses);
 
 protected:
@@ -188,6 +187,7 @@ protected:
 private:
 	ovrPoseStatef m_LastPoses[vr::k_unMaxTrackedDeviceCount];
 	ovrPoseStatef m_LastHandPose[ovrHand_Count];
+	TrackingCache<ovrTrackingState> m_TrackingCache;
 	vr::VRInputValueHandle_t m_Hands[ovrHand_Count];
 	vr::VRActionHandle_t m_ActionPose;
 
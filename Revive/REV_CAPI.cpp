@@ -144,6 +144,7 @@ OVR_PUBLIC_FUNCTION(void) ovr_Shutdown()
 
 	g_Sessions.clear();
 	vr::VR_Shutdown();
+	TraceRecorder::Get().Dump("Shutdown");
 	MicroProfileShutdown();
 	g_InitError = vr::VRInitError_Init_NotInitialized;
 }
@@ -369,6 +370,11 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, d
 	if (!session)
 		return state;
 
+	// Some titles need a different prediction than they ask for
+	if (absTime > 0.0)
+		absTime += session->Details->Profile.PredictionOffset;
+
+	session->Spikes.CountTrackingQuery();
 	session->Input->GetTrackingState(session, &state, absTime);
 	return state;
 }
@@ -380,6 +386,9 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetDevicePoses(ovrSession session, ovrTracked
 	if (!session)
 		return ovrError_InvalidSession;
 
+	if (absTime > 0.0)
+		absTime += session->Details->Profile.PredictionOffset;
+
 	return session->Input->GetDevicePoses(deviceTypes, deviceCount, absTime, outDevicePoses);
 }
 
@@ -516,6 +525,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, ovrControll
 	if (!inputState)
 		return ovrError_InvalidParameter;
 
+	session->Spikes.CountInputQuery();
 	ovrInputState state = { 0 };
 	ovrResult result = session->Input->GetInputState(session, controllerType, &state);
 
@@ -780,6 +790,8 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CommitTextureSwapChain(ovrSession session, ov
 		return ovrError_TextureSwapChainFull;
 
 	chain->Commit();
+	if (session)
+		session->Spikes.CountCommit();
 
 	if (chain->Overlay != vr::k_ulOverlayHandleInvalid)
 	{
@@ -873,6 +885,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_WaitToBeginFrame(ovrSession session, long lon
 	if (!session || !session->Compositor)
 		return ovrError_InvalidSession;
 
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_WAIT);
 	return session->Compositor->WaitToBeginFrame(session, frameIndex);
 }
 
@@ -884,6 +897,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_BeginFrame(ovrSession session, long long fram
 	if (!session || !session->Compositor)
 		return ovrError_InvalidSession;
 
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_BEGIN);
 	return session->Compositor->BeginFrame(session, frameIndex);
 }
 
@@ -897,6 +911,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_EndFrame(ovrSession session, long long frameI
 		return ovrError_InvalidSession;
 
 	// Use our own intermediate compositor to convert the frame to OpenVR.
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_END, frameIndex, layerCount);
 	return session->Compositor->EndFrame(session, frameIndex, layerPtrList, layerCount);
 }
 
@@ -913,12 +928,22 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame2(ovrSession session, long long fr
 		frameIndex = session->FrameIndex;
 
 	// Use our own intermediate compositor to convert the frame to OpenVR.
-	ovrResult result = session->Compositor->EndFrame(session, frameIndex, layerPtrList, layerCount);
+	ovrResult result;
+	{
+		SpikeScope spike(session->Spikes, SpikeDetector::CALL_END, frameIndex, layerCount);
+		result = session->Compositor->EndFrame(session, frameIndex, layerPtrList, layerCount);
+	}
+
 	if (OVR_SUCCESS(result))
 	{
 		// Begin the next frame
 		if (!session->Details->UseHack(SessionDetails::HACK_WAIT_IN_TRACKING_STATE))
+		{
+			SpikeScope spike(session->Spikes, SpikeDetector::CALL_WAIT);
 			session->Compositor->WaitToBeginFrame(session, frameIndex + 1);
+		}
+
+		SpikeScope spike(session->Spikes, SpikeDetector::CALL_BEGIN);
 		session->Compositor->BeginFrame(session, frameIndex + 1);
 	}
 
@@ -972,8 +997,6 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats
 
 	ovrPerfStatsPerCompositorFrame FrameStats[ovrMaxProvidedFrameStats];
 
-	// TODO: Implement performance scale heuristics
-	float AdaptiveGpuPerformanceScale = 1.0f;
 	ovrBool AnyFrameStatsDropped = (session->FrameIndex - session->StatsIndex) > ovrMaxProvidedFrameStats;
 	ovrBool ReprojectionEnabled = false;
 	int FrameStatsCount = AnyFrameStatsDropped ? ovrMaxProvidedFrameStats : int(session->FrameIndex - session->StatsIndex);
@@ -1034,6 +1057,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats
 		if (TimingStats[i].m_nReprojectionFlags & vr::VRCompositor_ReprojectionAsync)
 			ReprojectionEnabled = ovrTrue;
 	}
+	float AdaptiveGpuPerformanceScale = session->PerfScale.GetScale();
 
 	// We need to make sure we don't write outside of the bounds of the struct in older version of the runtime
 	if (g_MinorVersion < 11)
@@ -1127,7 +1151,11 @@ OVR_PUBLIC_FUNCTION(int) ovr_GetInt(ovrSession session, const char* propertyName
 	REV_TRACE(ovr_GetInt);
 
 	if (strcmp("TextureSwapChainDepth", propertyName) == 0)
+	{
+		if (session && session->Details->Profile.SwapchainDepth)
+			return session->Details->Profile.SwapchainDepth;
 		return REV_SWAPCHAIN_MAX_LENGTH;
+	}
 
 	return defaultVal;
 }
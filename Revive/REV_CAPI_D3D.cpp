@@ -29,7 +29,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session,
 	if (session->Compositor->GetAPI() != vr::TextureType_DirectX)
 		return ovrError_RuntimeException;
 
-	return session->Compositor->CreateTextureSwapChain(desc, out_TextureSwapChain);
+	return session->Compositor->CreateTextureSwapChain(session, desc, out_TextureSwapChain);
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferDX(ovrSession session,
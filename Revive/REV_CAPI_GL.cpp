@@ -23,7 +23,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainGL(ovrSession session,
 	if (session->Compositor->GetAPI() != vr::TextureType_OpenGL)
 		return ovrError_RuntimeException;
 
-	return session->Compositor->CreateTextureSwapChain(desc, out_TextureSwapChain);
+	return session->Compositor->CreateTextureSwapChain(session, desc, out_TextureSwapChain);
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetTextureSwapChainBufferGL(ovrSession session,
@@ -227,7 +227,7 @@ ovr_CreateTextureSwapChainVk(
 	if (session->Compositor->GetAPI() != vr::TextureType_Vulkan)
 		return ovrError_RuntimeException;
 
-	return session->Compositor->CreateTextureSwapChain(desc, out_TextureSwapChain);
+	return session->Compositor->CreateTextureSwapChain(session, desc, out_TextureSwapChain);
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult)
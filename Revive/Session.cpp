@@ -1,6 +1,7 @@
 #include "Session.h"
 #include "CompositorBase.h"
 #include "SessionDetails.h"
+#include "SessionEvents.h"
 #include "InputManager.h"
 
 #include <Windows.h>
@@ -8,30 +9,26 @@
 
 void SessionThreadFunc(ovrSession session)
 {
-	std::chrono::microseconds freq(std::chrono::milliseconds(10));
 	DWORD procId = GetCurrentProcessId();
+	uint32_t interval = REV_EVENT_POLL_MIN_INTERVAL;
 
 	while (session->Running)
 	{
+		SessionEventBatch batch = {};
+
 		vr::VREvent_t vrEvent;
 		while (vr::VRSystem()->PollNextEvent(&vrEvent, sizeof(vrEvent)))
 		{
-			switch (vrEvent.eventType)
-			{
-			case vr::VREvent_TrackedDeviceActivated:
-			case vr::VREvent_TrackedDeviceDeactivated:
+			vr::ETrackedDeviceClass deviceClass = vr::TrackedDeviceClass_Invalid;
+			if (NeedsDeviceClass(vrEvent))
 			{
-				vr::ETrackedDeviceClass deviceClass = vr::VRSystem()->GetTrackedDeviceClass(vrEvent.trackedDeviceIndex);
-				if (deviceClass == vr::TrackedDeviceClass_Controller)
-					session->Input->UpdateConnectedControllers();
-				else if (deviceClass == vr::TrackedDeviceClass_TrackingReference)
-					session->Details->UpdateTrackerDesc();
+				deviceClass = vr::VRSystem()->GetTrackedDeviceClass(vrEvent.trackedDeviceIndex);
 				assert(deviceClass != vr::TrackedDeviceClass_HMD);
 			}
-			break;
-			case vr::VREvent_TrackedDeviceRoleChanged:
-				session->Input->UpdateConnectedControllers();
-			break;
+			AddSessionEvent(batch, vrEvent, deviceClass);
+
+			switch (vrEvent.eventType)
+			{
 			case vr::VREvent_SceneApplicationChanged:
 			{
 				SessionStatusBits status = session->SessionStatus;
@@ -79,18 +76,27 @@ void SessionThreadFunc(ovrSession session)
 #endif
 		}
 
-		std::this_thread::sleep_for(freq);
+		if (batch.UpdateControllers)
+			session->Input->UpdateConnectedControllers();
+		if (batch.UpdateTrackers)
+			session->Details->UpdateTrackerDesc();
+
+		interval = GetEventPollInterval(interval, batch.Received);
+		WaitForSingleObject(session->SessionEvent, interval);
 	}
 }
 
 ovrHmdStruct::ovrHmdStruct()
 	: Running(true)
+	, SessionEvent(CreateEvent(nullptr, false, false, nullptr))
 	, SessionStatus()
 	, StringBuffer()
 	, TrackingOrigin(vr::TrackingUniverseSeated)
 	, FrameIndex(0)
 	, StatsIndex(0)
 	, BaseStats()
+	, PerfScale()
+	, PerfScaleFrame(0)
 	, Compositor(nullptr)
 	, Input(new InputManager())
 	, Details(new SessionDetails())
@@ -112,6 +118,8 @@ ovrHmdStruct::ovrHmdStruct()
 ovrHmdStruct::~ovrHmdStruct()
 {
 	Running = false;
+	SetEvent(SessionEvent);
 	if (SessionThread.joinable())
 		SessionThread.join();
+	CloseHandle(SessionEvent);
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "PerformanceScale.h"
+#include "SpikeDetector.h"
+
 #include <OVR_CAPI.h>
 #include <openvr.h>
 #include <memory>
@@ -28,9 +31,10 @@ struct ovrHmdStruct
 {
 	uint32_t MinorVersion;
 
-	// Session thread
+	// Session thread, the event is signalled every frame so events are handled without delay
 	std::thread SessionThread;
 	std::atomic_bool Running;
+	void* SessionEvent;
 
 	// Session status
 	std::atomic<SessionStatusBits> SessionStatus;
@@ -41,6 +45,9 @@ struct ovrHmdStruct
 	std::atomic_llong FrameIndex;
 	long long StatsIndex;
 	vr::Compositor_CumulativeStats BaseStats;
+	PerformanceScale PerfScale;
+	uint32_t PerfScaleFrame; // Last compositor frame fed to the performance scale
+	SpikeDetector Spikes;
 
 	// Revive interfaces
 	std::unique_ptr<CompositorBase> Compositor;
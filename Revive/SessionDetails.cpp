@@ -1,4 +1,5 @@
 #include "SessionDetails.h"
+#include "Compatibility.h"
 #include "REV_Math.h"
 
 #include <Windows.h>
@@ -16,8 +17,15 @@ SessionDetails::HackInfo SessionDetails::m_known_hacks[] = {
 	{ "DCVR-Win64-Shipping.exe", nullptr, HACK_DISABLE_STATS, true }
 };
 
+const char* SessionDetails::m_hack_names[] = {
+#define REV_HACK_NAME(name) #name,
+	REV_SESSION_HACKS(REV_HACK_NAME)
+#undef REV_HACK_NAME
+};
+
 SessionDetails::SessionDetails()
 	: TrackerCount(0)
+	, m_hacks(0)
 	, fVsyncToPhotons(0.0f)
 	, HmdDesc()
 	, RenderDesc()
@@ -33,19 +41,20 @@ SessionDetails::SessionDetails()
 	vr::VRSystem()->GetStringTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd,
 		vr::Prop_TrackingSystemName_String, driver.data(), size);
 
+	static_assert(HACK_COUNT <= 64, "The hacks need to fit in the hack mask");
+	static_assert(sizeof(m_hack_names) / sizeof(const char*) == HACK_COUNT, "Every hack needs a name");
+
+	// Compile the hacks into a mask once, so checking them on the hot paths is cheap
 	for (auto& hack : m_known_hacks)
-	{
-		if ((!hack.m_filename || _stricmp(filename, hack.m_filename) == 0) &&
-			(!hack.m_driver || strcmp(driver.data(), hack.m_driver) == 0))
-		{
-			if (hack.m_usehack)
-				m_hacks.emplace(hack.m_hack, hack);
-		}
-		else if (!hack.m_usehack)
-		{
-			m_hacks.emplace(hack.m_hack, hack);
-		}
-	}
+		AddHack(hack, filename, driver.data());
+
+	// Additional hacks can be added without rebuilding through the compatibility file, the driver
+	// doesn't report a version so overrides with a version range are rejected
+	std::vector<std::string> errors;
+	const JsonValue* compat = GetCompatibilityFile(&errors);
+	if (compat)
+		m_hacks = ApplyCompatibility(*compat, m_hacks, filename, driver.data(), nullptr, m_hack_names, HACK_COUNT, &Profile, &errors);
+	LogCompatibilityErrors(errors);
 
 	UpdateHmdDesc();
 	UpdateTrackerDesc();
@@ -55,9 +64,17 @@ SessionDetails::~SessionDetails()
 {
 }
 
-bool SessionDetails::UseHack(Hack hack)
+bool SessionDetails::MatchHack(const HackInfo& hack, const char* filename, const char* driver)
+{
+	return (!hack.m_filename || _stricmp(filename, hack.m_filename) == 0) &&
+		(!hack.m_driver || strcmp(driver, hack.m_driver) == 0);
+}
+
+void SessionDetails::AddHack(const HackInfo& hack, const char* filename, const char* driver)
 {
-	return m_hacks.find(hack) != m_hacks.end();
+	// Table entries that don't use the hack enable it for everything they don't match
+	if (MatchHack(hack, filename, driver) == hack.m_usehack)
+		m_hacks |= 1ull << hack.m_hack;
 }
 
 void SessionDetails::UpdateHmdDesc()
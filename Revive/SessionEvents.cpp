@@ -0,0 +1,35 @@
+#include "SessionEvents.h"
+
+#include <algorithm>
+
+bool NeedsDeviceClass(const vr::VREvent_t& event)
+{
+	return event.eventType == vr::VREvent_TrackedDeviceActivated ||
+		event.eventType == vr::VREvent_TrackedDeviceDeactivated;
+}
+
+void AddSessionEvent(SessionEventBatch& batch, const vr::VREvent_t& event, vr::ETrackedDeviceClass deviceClass)
+{
+	batch.Received = true;
+	switch (event.eventType)
+	{
+	case vr::VREvent_TrackedDeviceActivated:
+	case vr::VREvent_TrackedDeviceDeactivated:
+		if (deviceClass == vr::TrackedDeviceClass_Controller)
+			batch.UpdateControllers = true;
+		else if (deviceClass == vr::TrackedDeviceClass_TrackingReference)
+			batch.UpdateTrackers = true;
+		break;
+	case vr::VREvent_TrackedDeviceRoleChanged:
+		batch.UpdateControllers = true;
+		break;
+	}
+}
+
+uint32_t GetEventPollInterval(uint32_t interval, bool received)
+{
+	// Poll again soon while events are arriving, otherwise back off until the next frame wakes us
+	if (received)
+		return REV_EVENT_POLL_MIN_INTERVAL;
+	return std::min(std::max(interval, (uint32_t)REV_EVENT_POLL_MIN_INTERVAL) * 2, (uint32_t)REV_EVENT_POLL_MAX_INTERVAL);
+}
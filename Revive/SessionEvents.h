@@ -0,0 +1,26 @@
+#pragma once
+
+#include <openvr.h>
+#include <stdint.h>
+
+// Event polling interval in milliseconds, it backs off to the maximum while no events arrive
+#define REV_EVENT_POLL_MIN_INTERVAL 1
+#define REV_EVENT_POLL_MAX_INTERVAL 50
+
+// The device updates needed after a batch of events. Device changes come in bursts, so they're
+// coalesced and only applied once all pending events are handled.
+struct SessionEventBatch
+{
+	bool Received;
+	bool UpdateControllers;
+	bool UpdateTrackers;
+};
+
+// Whether the event needs the class of its device, which is only queried for the events that need it
+bool NeedsDeviceClass(const vr::VREvent_t& event);
+
+// Adds an event to the batch, deviceClass is only used if NeedsDeviceClass returned true
+void AddSessionEvent(SessionEventBatch& batch, const vr::VREvent_t& event, vr::ETrackedDeviceClass deviceClass);
+
+// Returns the time to wait before polling again, after a batch with or without events
+uint32_t GetEventPollInterval(uint32_t interval, bool received);
@@ -0,0 +1,127 @@
+#include "CallRecorder.h"
+
+#include <Windows.h>
+#include <stdlib.h>
+
+CallRecorder& CallRecorder::Get()
+{
+	static CallRecorder instance;
+	return instance;
+}
+
+CallRecorder::CallRecorder()
+	: m_File(nullptr)
+	, m_MinorVersion(0)
+{
+}
+
+CallRecorder::~CallRecorder()
+{
+	Close();
+}
+
+bool CallRecorder::Open(uint32_t minorVersion)
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	if (m_File)
+		return true;
+
+	const char* path = getenv("REVIVE_RECORD_FILE");
+	if (!path || path[0] == '\0')
+		return false;
+
+	m_File = fopen(path, "wb");
+	if (!m_File)
+		return false;
+	setvbuf(m_File, nullptr, _IOFBF, REV_RECORD_BUFFER_SIZE);
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+
+	RecordFileHeader header;
+	header.Magic = REV_RECORD_FILE_MAGIC;
+	header.Version = REV_RECORD_FILE_VERSION;
+	header.MinorVersion = (uint16_t)minorVersion;
+	header.Frequency = freq.QuadPart;
+	header.PointerSize = sizeof(void*);
+	header.Reserved = 0;
+	fwrite(&header, sizeof(header), 1, m_File);
+	m_MinorVersion = minorVersion;
+	return true;
+}
+
+void CallRecorder::Close()
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	if (m_File)
+		fclose(m_File);
+	m_File = nullptr;
+}
+
+void CallRecorder::WriteHeader(RecordCall call, uint32_t size)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	RecordHeader header;
+	header.Call = call;
+	header.Reserved = 0;
+	header.Size = size;
+	header.Timestamp = now.QuadPart;
+	fwrite(&header, sizeof(header), 1, m_File);
+}
+
+void CallRecorder::Record(RecordCall call, const void* data, uint32_t size)
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	if (!m_File)
+		return;
+
+	WriteHeader(call, size);
+	fwrite(data, size, 1, m_File);
+}
+
+uint32_t CallRecorder::GetLayerSize(const ovrLayerHeader* layer) const
+{
+	if (!layer)
+		return 0;
+
+	uint32_t size = 0;
+	switch (layer->Type)
+	{
+		case ovrLayerType_EyeFov: size = sizeof(ovrLayerEyeFov); break;
+		case ovrLayerType_EyeFovDepth: size = sizeof(ovrLayerEyeFovDepth); break;
+		case ovrLayerType_EyeMatrix: size = sizeof(ovrLayerEyeMatrix); break;
+		case ovrLayerType_EyeFovMultires: size = sizeof(ovrLayerEyeFovMultires); break;
+		case ovrLayerType_Quad: size = sizeof(ovrLayerQuad); break;
+		case ovrLayerType_Cylinder: size = sizeof(ovrLayerCylinder); break;
+		case ovrLayerType_Cube: size = sizeof(ovrLayerCube); break;
+		default: size = sizeof(ovrLayerHeader); break;
+	}
+
+	// Older versions don't have the reserved data in the header
+	if (m_MinorVersion < 25)
+		size -= sizeof(ovrLayerHeader::Reserved);
+	return size;
+}
+
+void CallRecorder::RecordEndFrame(long long frameIndex, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	if (!m_File)
+		return;
+
+	uint32_t size = sizeof(frameIndex) + sizeof(uint32_t);
+	for (unsigned int i = 0; i < layerCount; i++)
+		size += sizeof(uint32_t) + GetLayerSize(layerPtrList[i]);
+
+	WriteHeader(RECORD_END_FRAME, size);
+	fwrite(&frameIndex, sizeof(frameIndex), 1, m_File);
+	fwrite(&layerCount, sizeof(uint32_t), 1, m_File);
+	for (unsigned int i = 0; i < layerCount; i++)
+	{
+		uint32_t layerSize = GetLayerSize(layerPtrList[i]);
+		fwrite(&layerSize, sizeof(layerSize), 1, m_File);
+		fwrite(layerPtrList[i], layerSize, 1, m_File);
+	}
+}
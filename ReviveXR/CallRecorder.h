@@ -0,0 +1,71 @@
+#pragma once
+
+#include "OVR_CAPI.h"
+
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+
+// Size of the file buffer, so the frame loop rarely has to wait on the disk
+#define REV_RECORD_BUFFER_SIZE (1 << 20)
+
+// Recordings are little-endian and consist of a RecordFileHeader followed by a sequence of
+// RecordHeader structures, each followed by Size bytes of call arguments. The layers are stored
+// as they were passed by the app, so their texture handles have the recorded pointer size.
+#define REV_RECORD_FILE_MAGIC 0x43525652 // 'RVRC'
+#define REV_RECORD_FILE_VERSION 2
+
+enum RecordCall : uint16_t
+{
+	RECORD_WAIT_TO_BEGIN_FRAME,	// long long frameIndex
+	RECORD_BEGIN_FRAME,			// long long frameIndex
+	RECORD_END_FRAME,			// long long frameIndex, uint32_t layerCount, layerCount * (uint32_t size, layer)
+	RECORD_COMMIT_SWAP_CHAIN,	// uint64_t chain
+	RECORD_GET_TRACKING_STATE,	// double absTime
+	RECORD_GET_INPUT_STATE,		// uint32_t controllerType
+};
+
+struct RecordFileHeader
+{
+	uint32_t Magic;
+	uint16_t Version;
+	uint16_t MinorVersion;	// Layers before version 1.25 have no reserved header data
+	int64_t Frequency;		// Timestamp ticks per second
+	uint32_t PointerSize;	// Size of the pointers in the layers, added in version 2
+	uint32_t Reserved;
+};
+
+struct RecordHeader
+{
+	uint16_t Call;
+	uint16_t Reserved;
+	uint32_t Size;
+	int64_t Timestamp;
+};
+
+// Serializes the arguments of the hot ovr_* calls, including the layer payloads, to a binary log so
+// an app session can be analyzed offline. The recorder is only enabled when the REVIVE_RECORD_FILE
+// environment variable is set.
+class CallRecorder
+{
+public:
+	static CallRecorder& Get();
+
+	bool Open(uint32_t minorVersion);
+	void Close();
+	bool IsEnabled() const { return m_File != nullptr; }
+
+	void Record(RecordCall call, const void* data, uint32_t size);
+	void RecordEndFrame(long long frameIndex, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount);
+
+private:
+	CallRecorder();
+	~CallRecorder();
+
+	void WriteHeader(RecordCall call, uint32_t size);
+	uint32_t GetLayerSize(const ovrLayerHeader* layer) const;
+
+	std::mutex m_Mutex;
+	FILE* m_File;
+	uint32_t m_MinorVersion;
+};
@@ -2,6 +2,7 @@
 
 #include "OVR_CAPI.h"
 #include "microprofile.h"
+#include "TraceRecorder.h"
 
 #include <openxr/openxr.h>
 #include <openxr/openxr_reflection.h>
@@ -12,7 +13,7 @@
 #include <Windows.h>
 #define REV_TRACE(x) OutputDebugStringA("Revive: " #x "\n");
 #else
-#define REV_TRACE(x) MICROPROFILE_SCOPEI("Revive", #x, 0xff0000);
+#define REV_TRACE(x) REV_TRACE_SCOPE(x); MICROPROFILE_SCOPEI("Revive", #x, 0xff0000);
 #endif
 
 #define XR_ENUM_CASE_STR(name, val) case name: return L#name;
@@ -29,6 +30,8 @@ extern XrResult g_LastResult;
 
 #ifdef NDEBUG
 #define assertmsg(expression, message) ((void)0)
+#elif !defined(_WIN32)
+#define assertmsg(expression, message) assert(expression)
 #else
 #define assertmsg(expression, message) (void)(                                                       \
             (!!(expression)) ||                                                              \
@@ -0,0 +1,240 @@
+#include "CompositionLayers.h"
+#include "Common.h"
+#include "SwapChain.h"
+#include "XR_Math.h"
+
+#include <openxr/openxr.h>
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+// FNV-1a hash of the layer data, used to detect layers that are unchanged since the last frame
+static uint64_t HashLayer(const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Copies the cached translation if the layer data in [begin, end) is unchanged, otherwise stores the
+// layer data so the caller can translate the layer and store the result in the cache
+static bool LookupLayer(LayerArena& arena, LayerCache& cache, XrStructureType type, const ovrLayer_Union* layer,
+	size_t begin, size_t end, XrCompositionLayerUnion& out)
+{
+	const char* source = (const char*)layer + begin;
+	char* cached = (char*)&cache.Source + begin;
+	size_t size = end - begin;
+
+	// The hash only rejects changed layers quickly, a collision must not submit a stale pose or rect
+	uint64_t hash = HashLayer(source, size);
+	if (cache.Layer.Header.type == type && cache.Hash == hash && memcmp(cached, source, size) == 0)
+	{
+		MICROPROFILE_COUNTER_ADD("Layers/CacheHits", 1);
+		arena.CacheHits++;
+		out = cache.Layer;
+		return true;
+	}
+
+	MICROPROFILE_COUNTER_ADD("Layers/CacheMisses", 1);
+	arena.CacheMisses++;
+	cache.Hash = hash;
+	memcpy(cached, source, size);
+	return false;
+}
+
+// The layer data from the color texture up to the end of the last member, so the trailing padding isn't compared
+#define LAYER_DATA(type, last) offsetof(type, ColorTexture), offsetof(type, last) + sizeof(((type*)nullptr)->last)
+
+uint32_t TranslateLayers(LayerArena& arena, const LayerTranslationInfo& info, const ovrViewScaleDesc* viewScaleDesc,
+	ovrLayerHeader const * const * layerPtrList, unsigned int layerCount, double* sampleTime)
+{
+	uint32_t numLayers = 0;
+	for (unsigned int i = 0; i < layerCount; i++)
+	{
+		ovrLayer_Union* layer = (ovrLayer_Union*)layerPtrList[i];
+
+		if (!layer)
+			continue;
+
+		ovrLayerType type = layer->Header.Type;
+		const bool upsideDown = layer->Header.Flags & ovrLayerFlag_TextureOriginAtBottomLeft;
+		const bool headLocked = layer->Header.Flags & ovrLayerFlag_HeadLocked;
+
+		// Version 1.25 introduced a 128-byte reserved parameter, so on older versions the actual data
+		// falls within this reserved parameter and we need to move the pointer back into the actual data area.
+		// NOTE: Do not read the header after this operation as it will fall outside of the layer memory.
+		if (info.MinorVersion < 25)
+			layer = (ovrLayer_Union*)((char*)layer - sizeof(ovrLayerHeader::Reserved));
+
+		// The oculus runtime is very tolerant of invalid viewports, so this lambda ensures we submit valid ones.
+		auto ClampRect = [](ovrRecti rect, ovrTextureSwapChain chain)
+		{
+			OVR::Sizei chainSize(chain->Desc.Width, chain->Desc.Height);
+
+			if (rect.Size.w <= 0 || rect.Size.h <= 0)
+				return XR::Recti(OVR::Vector2i::Max(rect.Pos, OVR::Vector2i()), chainSize);
+
+			return XR::Recti(OVR::Vector2i::Max(rect.Pos, OVR::Vector2i()),
+				OVR::Sizei::Min(rect.Size, chainSize));
+		};
+
+		XrCompositionLayerUnion& newLayer = arena.Data[numLayers];
+
+		if (type == ovrLayerType_EyeFov || type == ovrLayerType_EyeMatrix || type == ovrLayerType_EyeFovDepth)
+		{
+			XrCompositionLayerProjection& projection = newLayer.Projection;
+			projection = XR_TYPE(COMPOSITION_LAYER_PROJECTION);
+
+			// The sensor sample time of the first eye layer marks when the app sampled the pose it rendered with
+			double layerSampleTime = type == ovrLayerType_EyeMatrix ? layer->EyeMatrix.SensorSampleTime : layer->EyeFov.SensorSampleTime;
+			if (*sampleTime <= 0.0)
+				*sampleTime = layerSampleTime;
+
+			ovrTextureSwapChain texture = nullptr;
+			XrCompositionLayerProjectionViewStereo& viewData = arena.Views[numLayers];
+			int i;
+			for (i = 0; i < ovrEye_Count; i++)
+			{
+				if (layer->EyeFov.ColorTexture[i])
+					texture = layer->EyeFov.ColorTexture[i];
+
+				if (!texture)
+					break;
+
+				XrCompositionLayerProjectionView& view = viewData.Views[i];
+				view = XR_TYPE(COMPOSITION_LAYER_PROJECTION_VIEW);
+
+				if (type == ovrLayerType_EyeMatrix)
+				{
+					// RenderPose is the first member that's differently aligned
+					view.pose = XR::Posef(layer->EyeMatrix.RenderPose[i]);
+					view.fov = XR::Matrix4f(layer->EyeMatrix.Matrix[i]);
+				}
+				else
+				{
+					view.pose = XR::Posef(layer->EyeFov.RenderPose[i]);
+
+					// The Climb specifies an invalid fov in the first frame, ignore the layer
+					XR::FovPort Fov(layer->EyeFov.Fov[i]);
+					if (Fov.GetMaxSideTan() > 0.0f)
+						view.fov = Fov;
+					else
+						break;
+				}
+
+				// Flip the field-of-view to flip the image, invert the check for OpenGL
+				if (texture->Images->type == XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR ? !upsideDown : upsideDown)
+					OVR::OVRMath_Swap(view.fov.angleUp, view.fov.angleDown);
+
+				if (type == ovrLayerType_EyeFovDepth && info.CompositionDepth)
+				{
+					XrCompositionLayerDepthInfoKHR& depthInfo = viewData.DepthInfo[i];
+					depthInfo = XR_TYPE(COMPOSITION_LAYER_DEPTH_INFO_KHR);
+
+					ovrTextureSwapChain depthTexture = layer->EyeFovDepth.DepthTexture[i];
+					depthInfo.subImage.swapchain = depthTexture->Swapchain;
+					depthInfo.subImage.imageRect = ClampRect(layer->EyeFovDepth.Viewport[i], depthTexture);
+					depthInfo.subImage.imageArrayIndex = 0;
+
+					const ovrTimewarpProjectionDesc& projDesc = layer->EyeFovDepth.ProjectionDesc;
+					depthInfo.minDepth = 0.0f;
+					depthInfo.maxDepth = 1.0f;
+					depthInfo.nearZ = projDesc.Projection23 / projDesc.Projection22;
+					depthInfo.farZ = projDesc.Projection23 / (1.0f + projDesc.Projection22);
+
+					if (viewScaleDesc)
+					{
+						depthInfo.nearZ *= viewScaleDesc->HmdSpaceToWorldScaleInMeters;
+						depthInfo.farZ *= viewScaleDesc->HmdSpaceToWorldScaleInMeters;
+					}
+
+					view.next = &depthInfo;
+				}
+
+				view.subImage.swapchain = texture->Swapchain;
+				view.subImage.imageRect = ClampRect(layer->EyeFov.Viewport[i], texture);
+				view.subImage.imageArrayIndex = 0;
+			}
+
+			// Verify all views were initialized without errors, otherwise ignore the layer
+			if (i < ovrEye_Count)
+				continue;
+
+			projection.viewCount = ovrEye_Count;
+			projection.views = viewData.Views;
+		}
+		else if (type == ovrLayerType_Quad)
+		{
+			ovrTextureSwapChain texture = layer->Quad.ColorTexture;
+			if (!texture)
+				continue;
+
+			// Reuse the previous translation if the layer hasn't changed since the last frame
+			if (!LookupLayer(arena, texture->Cache, XR_TYPE_COMPOSITION_LAYER_QUAD, layer,
+				LAYER_DATA(ovrLayerQuad, QuadSize), newLayer))
+			{
+				XrCompositionLayerQuad& quad = newLayer.Quad;
+				quad = XR_TYPE(COMPOSITION_LAYER_QUAD);
+				quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+				quad.subImage.swapchain = texture->Swapchain;
+				quad.subImage.imageRect = ClampRect(layer->Quad.Viewport, texture);
+				quad.subImage.imageArrayIndex = 0;
+				quad.pose = XR::Posef(layer->Quad.QuadPoseCenter);
+				quad.size = XR::Vector2f(layer->Quad.QuadSize);
+				texture->Cache.Layer = newLayer;
+			}
+		}
+		else if (type == ovrLayerType_Cylinder && info.CompositionCylinder)
+		{
+			ovrTextureSwapChain texture = layer->Cylinder.ColorTexture;
+			if (!texture)
+				continue;
+
+			if (!LookupLayer(arena, texture->Cache, XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR, layer,
+				LAYER_DATA(ovrLayerCylinder, CylinderAspectRatio), newLayer))
+			{
+				XrCompositionLayerCylinderKHR& cylinder = newLayer.Cylinder;
+				cylinder = XR_TYPE(COMPOSITION_LAYER_CYLINDER_KHR);
+				cylinder.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+				cylinder.subImage.swapchain = texture->Swapchain;
+				cylinder.subImage.imageRect = ClampRect(layer->Cylinder.Viewport, texture);
+				cylinder.subImage.imageArrayIndex = 0;
+				cylinder.pose = XR::Posef(layer->Cylinder.CylinderPoseCenter);
+				cylinder.radius = layer->Cylinder.CylinderRadius;
+				cylinder.centralAngle = layer->Cylinder.CylinderAngle;
+				cylinder.aspectRatio = layer->Cylinder.CylinderAspectRatio;
+				texture->Cache.Layer = newLayer;
+			}
+		}
+		else if (type == ovrLayerType_Cube && info.CompositionCube)
+		{
+			if (!layer->Cube.CubeMapTexture)
+				continue;
+
+			XrCompositionLayerCubeKHR& cube = newLayer.Cube;
+			cube = XR_TYPE(COMPOSITION_LAYER_CUBE_KHR);
+			cube.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+			cube.swapchain = layer->Cube.CubeMapTexture->Swapchain;
+			cube.imageArrayIndex = 0;
+			cube.orientation = XR::Quatf(layer->Cube.Orientation);
+		}
+		else
+		{
+			// Layer type not recognized or disabled, ignore the layer
+			assert(type == ovrLayerType_Disabled);
+			continue;
+		}
+
+		XrCompositionLayerBaseHeader& header = newLayer.Header;
+		header.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+		header.space = headLocked ? info.ViewSpace : info.WorldSpace;
+
+		arena.Headers[numLayers++] = &newLayer.Header;
+	}
+	return numLayers;
+}
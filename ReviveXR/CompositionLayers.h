@@ -0,0 +1,58 @@
+#pragma once
+
+#include "OVR_CAPI.h"
+
+#include <openxr/openxr.h>
+#include <stdint.h>
+
+union XrCompositionLayerUnion
+{
+	XrCompositionLayerBaseHeader Header;
+	XrCompositionLayerProjection Projection;
+	XrCompositionLayerQuad Quad;
+	XrCompositionLayerCylinderKHR Cylinder;
+	XrCompositionLayerCubeKHR Cube;
+};
+
+struct XrCompositionLayerProjectionViewStereo
+{
+	XrCompositionLayerProjectionView Views[ovrEye_Count];
+	XrCompositionLayerDepthInfoKHR DepthInfo[ovrEye_Count];
+};
+
+// The last quad or cylinder layer translated from a swapchain, so an unchanged HUD layer isn't translated again
+struct LayerCache
+{
+	uint64_t Hash;			// Hash of the source data, a hit is confirmed by comparing the source data
+	ovrLayer_Union Source;	// Only the data after the header is stored, the flags are resolved every frame
+	XrCompositionLayerUnion Layer;
+};
+
+// Layer translation storage, owned by the session and reused every frame so ovr_EndFrame doesn't allocate
+struct LayerArena
+{
+	XrCompositionLayerUnion Data[ovrMaxLayerCount];
+	XrCompositionLayerProjectionViewStereo Views[ovrMaxLayerCount];
+	XrCompositionLayerBaseHeader* Headers[ovrMaxLayerCount];
+
+	// Statistics of the per-swapchain layer cache
+	uint64_t CacheHits;
+	uint64_t CacheMisses;
+};
+
+// The runtime and session state the translation depends on
+struct LayerTranslationInfo
+{
+	uint32_t MinorVersion;
+	bool CompositionDepth;
+	bool CompositionCube;
+	bool CompositionCylinder;
+	XrSpace ViewSpace;	// Head-locked layers
+	XrSpace WorldSpace;	// All other layers, the local or stage space depending on the tracking origin
+};
+
+// Translates the layers into the arena and returns how many of its headers should be submitted,
+// invalid and disabled layers are skipped. The sensor sample time of the first eye layer is stored
+// in sampleTime, unless it was already set earlier in the frame.
+uint32_t TranslateLayers(LayerArena& arena, const LayerTranslationInfo& info, const ovrViewScaleDesc* viewScaleDesc,
+	ovrLayerHeader const * const * layerPtrList, unsigned int layerCount, double* sampleTime);
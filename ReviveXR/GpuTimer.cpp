@@ -0,0 +1,102 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer(ID3D11Device* pDevice)
+	: m_Context()
+	, m_Multithread()
+	, m_WasProtected(FALSE)
+	, m_Frames()
+	, m_Begun(0)
+	, m_Ended(0)
+	, m_Read(0)
+{
+	pDevice->GetImmediateContext(&m_Context);
+
+	// The app may render on another thread while we issue the queries, so the context has to be protected
+	if (SUCCEEDED(m_Context.As(&m_Multithread)))
+		m_WasProtected = m_Multithread->SetMultithreadProtected(TRUE);
+
+	D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+	for (Frame& frame : m_Frames)
+	{
+		pDevice->CreateQuery(&disjointDesc, &frame.Disjoint);
+		pDevice->CreateQuery(&timestampDesc, &frame.Begin);
+		pDevice->CreateQuery(&timestampDesc, &frame.End);
+	}
+}
+
+GpuTimer::~GpuTimer()
+{
+	if (m_Multithread && !m_WasProtected)
+		m_Multithread->SetMultithreadProtected(FALSE);
+}
+
+void GpuTimer::Begin()
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+
+	// Skip the frame if all queries are still in flight or the last frame was never ended
+	if (m_Begun != m_Ended || m_Begun - m_Read >= REV_GPU_TIMER_FRAMES)
+		return;
+
+	Frame& frame = m_Frames[m_Begun % REV_GPU_TIMER_FRAMES];
+	if (!frame.Disjoint || !frame.Begin || !frame.End)
+		return;
+
+	ContextLock lock(m_Multithread.Get());
+	m_Context->Begin(frame.Disjoint.Get());
+	m_Context->End(frame.Begin.Get());
+	frame.Thread = GetCurrentThreadId();
+	m_Begun++;
+}
+
+void GpuTimer::End()
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+
+	if (m_Ended == m_Begun)
+		return;
+
+	// The queries still have to be ended so they can be reused, but a frame that ended on another
+	// thread measured the work of whichever thread happened to use the context in between
+	Frame& frame = m_Frames[m_Ended % REV_GPU_TIMER_FRAMES];
+	frame.Valid = frame.Thread == GetCurrentThreadId();
+
+	ContextLock lock(m_Multithread.Get());
+	m_Context->End(frame.End.Get());
+	m_Context->End(frame.Disjoint.Get());
+	m_Ended++;
+}
+
+bool GpuTimer::GetTime(float* outTime)
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	ContextLock lock(m_Multithread.Get());
+
+	while (m_Read != m_Ended)
+	{
+		Frame& frame = m_Frames[m_Read % REV_GPU_TIMER_FRAMES];
+		if (!frame.Valid)
+		{
+			m_Read++;
+			continue;
+		}
+
+		// Don't flush, the results will be there in a later frame
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+		UINT64 begin, end;
+		if (m_Context->GetData(frame.Disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			m_Context->GetData(frame.Begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			m_Context->GetData(frame.End.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+			return false;
+		m_Read++;
+
+		// The timestamps are unreliable if the GPU clock changed during the frame
+		if (!disjoint.Disjoint && end > begin)
+		{
+			*outTime = float(double(end - begin) / double(disjoint.Frequency));
+			return true;
+		}
+	}
+	return false;
+}
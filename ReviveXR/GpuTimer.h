@@ -0,0 +1,57 @@
+#pragma once
+
+#include <d3d11_4.h>
+#include <wrl/client.h>
+#include <mutex>
+#include <stdint.h>
+
+// Number of frames that can be in flight before their results are read back
+#define REV_GPU_TIMER_FRAMES 4
+
+// Measures the GPU time of the app between BeginFrame and EndFrame with timestamp queries.
+// The results are only read once the GPU is done with them, so the timer never stalls the app.
+// BeginFrame and EndFrame may be called on different threads, so the timer enables the multithread
+// protection of the immediate context and only measures frames that began and ended on the same thread.
+class GpuTimer
+{
+public:
+	GpuTimer(ID3D11Device* pDevice);
+	~GpuTimer();
+
+	void Begin();
+	void End();
+
+	// Returns the GPU time in seconds of the oldest frame that finished, if any
+	bool GetTime(float* outTime);
+
+private:
+	struct Frame
+	{
+		Microsoft::WRL::ComPtr<ID3D11Query> Disjoint;
+		Microsoft::WRL::ComPtr<ID3D11Query> Begin;
+		Microsoft::WRL::ComPtr<ID3D11Query> End;
+		DWORD Thread;	// Thread that began the frame
+		bool Valid;		// Whether the frame also ended on that thread
+	};
+
+	// Holds the context lock while the queries are issued
+	class ContextLock
+	{
+	public:
+		ContextLock(ID3D11Multithread* multithread) : m_Multithread(multithread) { if (m_Multithread) m_Multithread->Enter(); }
+		~ContextLock() { if (m_Multithread) m_Multithread->Leave(); }
+
+	private:
+		ID3D11Multithread* m_Multithread;
+	};
+
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_Context;
+	Microsoft::WRL::ComPtr<ID3D11Multithread> m_Multithread;
+	BOOL m_WasProtected;
+
+	std::mutex m_Mutex;
+	Frame m_Frames[REV_GPU_TIMER_FRAMES];
+	uint32_t m_Begun;
+	uint32_t m_Ended;
+	uint32_t m_Read;
+};
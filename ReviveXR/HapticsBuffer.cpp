@@ -1,5 +1,10 @@
 #include "HapticsBuffer.h"
 
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
 HapticsBuffer::HapticsBuffer()
 	: m_ReadIndex(0xFF)
 	, m_WriteIndex(0)
@@ -9,44 +14,102 @@ HapticsBuffer::HapticsBuffer()
 
 void HapticsBuffer::AddSamples(const ovrHapticsBuffer* buffer)
 {
-	uint8_t* samples = (uint8_t*)buffer->Samples;
-
-	for (int i = 0; i < buffer->SamplesCount; i++)
-	{
-		if (m_WriteIndex == m_ReadIndex)
-			return;
+	// The write index can't pass the read index, so only fill up the free space
+	uint8_t write = m_WriteIndex.load(std::memory_order_relaxed);
+	uint8_t read = m_ReadIndex.load(std::memory_order_acquire);
+	int count = std::min(buffer->SamplesCount, (int)(uint8_t)(read - write));
+	if (count <= 0)
+		return;
 
-		m_Buffer[m_WriteIndex] = samples[i];
+	// Copy the samples in at most two contiguous blocks around the end of the ring
+	const uint8_t* samples = (const uint8_t*)buffer->Samples;
+	int first = std::min(count, OVR_HAPTICS_BUFFER_SAMPLES_MAX - write);
+	memcpy(&m_Buffer[write], samples, first);
+	memcpy(m_Buffer, samples + first, count - first);
 
-		// We increment the atomic here as a memory barrier
-		// Index will overflow correctly, so no need for a modulo operator
-		m_WriteIndex++;
-	}
+	// Publish all samples at once, the index will overflow correctly
+	m_WriteIndex.store((uint8_t)(write + count), std::memory_order_release);
 }
 
 float HapticsBuffer::GetSample()
 {
 	// We can't pass the write index, so the buffer is now empty
-	if (m_ReadIndex + 1 == m_WriteIndex)
+	uint8_t read = m_ReadIndex.load(std::memory_order_relaxed) + 1;
+	if (read == m_WriteIndex.load(std::memory_order_acquire))
 		return 0.0f;
 
 	// Index will overflow correctly, so no need for a modulo operator
-	uint8_t sample = m_Buffer[++m_ReadIndex];
+	uint8_t sample = m_Buffer[read];
+	m_ReadIndex.store(read, std::memory_order_release);
 
 	return sample / 255.0f;
 }
 
+bool HapticsBuffer::PeekSegment(const HapticsEnvelope& envelope, HapticsSegment* outSegment)
+{
+	uint8_t read = m_ReadIndex.load(std::memory_order_relaxed) + 1;
+	unsigned int queued = (uint8_t)(m_WriteIndex.load(std::memory_order_acquire) - read);
+	if (queued == 0)
+		return false;
+
+	// Merge blocks with a similar level and the same pulse pattern into a single segment,
+	// without consuming the samples. Pulses are counted as rising edges within a block, so
+	// the blocks need to be long enough to tell the pulse frequencies apart.
+	unsigned int blockSamples = std::max(envelope.BlockSamples, 1u);
+	if (envelope.UseFrequency)
+		blockSamples = std::max(blockSamples, (unsigned int)REV_HAPTICS_FREQUENCY_BLOCK);
+	unsigned int maxSamples = std::min(std::max(envelope.MaxSamples, 1u), queued);
+	unsigned int samples = 0, edges = 0, firstEdges = 0;
+	uint64_t sumSquares = 0;
+	float firstLevel = 0.0f;
+	while (samples < maxSamples)
+	{
+		unsigned int length = std::min(blockSamples, maxSamples - samples);
+
+		uint64_t blockSquares = 0;
+		unsigned int blockEdges = 0;
+		uint8_t last = m_Buffer[(uint8_t)(read + samples + length - 1)];
+		for (unsigned int i = 0; i < length; i++)
+		{
+			uint8_t sample = m_Buffer[(uint8_t)(read + samples + i)];
+			if (sample > 0 && last == 0)
+				blockEdges++;
+			blockSquares += sample * sample;
+			last = sample;
+		}
+
+		// Compare the RMS level of the blocks, a single spike shouldn't start a new segment
+		float level = sqrtf(float(blockSquares) / length);
+		if (samples == 0)
+		{
+			firstEdges = blockEdges;
+			firstLevel = level;
+		}
+		else if (blockEdges != firstEdges || fabsf(level - firstLevel) > envelope.Tolerance)
+		{
+			break;
+		}
+
+		sumSquares += blockSquares;
+		edges += blockEdges;
+		samples += length;
+	}
+
+	// The pulse frequency is resolved over the whole segment rather than a single block
+	outSegment->Amplitude = sqrtf(float(sumSquares) / samples) / 255.0f;
+	outSegment->Frequency = (envelope.UseFrequency && edges > 0) ? float(edges * REV_HAPTICS_SAMPLE_RATE) / samples : 0.0f;
+	outSegment->Samples = samples;
+	return true;
+}
+
 ovrHapticsPlaybackState HapticsBuffer::GetState()
 {
 	ovrHapticsPlaybackState state = { 0 };
 
-	for (uint8_t i = m_WriteIndex; i != m_ReadIndex; i++)
-		state.RemainingQueueSpace++;
-	state.RemainingQueueSpace++;
-
-	for (uint8_t i = m_ReadIndex; i != m_WriteIndex; i++)
-		state.SamplesQueued++;
-	state.SamplesQueued--;
+	// The read index points at the last consumed sample, so one slot of the ring is always unused
+	uint8_t queued = m_WriteIndex.load(std::memory_order_acquire) - m_ReadIndex.load(std::memory_order_acquire) - 1;
+	state.SamplesQueued = queued;
+	state.RemainingQueueSpace = (OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1) - queued;
 
 	return state;
 }
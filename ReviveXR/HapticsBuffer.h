@@ -1,11 +1,9 @@
 #pragma once
 
 #include "OVR_CAPI.h"
+#include "HapticsSegment.h"
 
 #include <atomic>
-#include <mutex>
-
-#define REV_HAPTICS_SAMPLE_RATE 320
 
 class HapticsBuffer
 {
@@ -15,6 +13,7 @@ public:
 
 	void AddSamples(const ovrHapticsBuffer* buffer);
 	float GetSample();
+	bool PeekSegment(const HapticsEnvelope& envelope, HapticsSegment* outSegment);
 	ovrHapticsPlaybackState GetState();
 
 private:
@@ -4,6 +4,7 @@
 #include "Runtime.h"
 #include "OVR_CAPI.h"
 #include "XR_Math.h"
+#include "TouchInput.h"
 #ifdef _DEBUG
 #include "Debug.h"
 #endif
@@ -18,10 +19,18 @@ XrPath InputManager::s_SubActionPaths[ovrHand_Count] = { XR_NULL_PATH, XR_NULL_P
 
 InputManager::InputManager(XrInstance instance)
 	: m_InputDevices()
+	, m_LastSyncTime(0.0)
+	, m_ResyncThreshold(0.0)
+	, m_Locations()
 {
 	s_SubActionPaths[ovrHand_Left] = GetXrPath("/user/hand/left");
 	s_SubActionPaths[ovrHand_Right] = GetXrPath("/user/hand/right");
 
+	// Opt-in low-latency mode, re-sync actions if the last sync is older than the given milliseconds
+	const char* resync = getenv("REVIVE_INPUT_RESYNC_MS");
+	if (resync)
+		m_ResyncThreshold = atof(resync) / 1000.0;
+
 	m_InputDevices.push_back(new OculusTouch(instance));
 	m_InputDevices.push_back(new XboxGamepad(instance));
 	m_InputDevices.push_back(new OculusRemote(instance));
@@ -65,14 +74,52 @@ ovrResult InputManager::SetControllerVibration(ovrSession session, ovrController
 	return ovrSuccess;
 }
 
-ovrResult InputManager::GetInputState(ovrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+void InputManager::InvalidateActionState()
 {
-	memset(inputState, 0, sizeof(ovrInputState));
+	std::lock_guard<std::mutex> lk(m_SyncMutex);
+	m_LastSyncTime = 0.0;
+}
+
+ovrResult InputManager::SyncActions(ovrSession session)
+{
+	std::lock_guard<std::mutex> lk(m_SyncMutex);
+
+	// The input state may already have been queried since the frame was waited on
+	if (m_LastSyncTime > 0.0)
+		return ovrSuccess;
+	return UpdateActionState(session);
+}
+
+ovrResult InputManager::UpdateActionState(ovrSession session)
+{
+	REV_TRACE_SCOPE(SyncActions);
+	MICROPROFILE_SCOPEI("Revive", "SyncActions", 0x00ff00);
 
 	XrActionsSyncInfo syncInfo = XR_TYPE(ACTIONS_SYNC_INFO);
 	syncInfo.countActiveActionSets = (uint32_t)m_ActionSets.size();
 	syncInfo.activeActionSets = m_ActionSets.data();
 	CHK_XR(xrSyncActions(session->Session, &syncInfo));
+	m_LastSyncTime = ovr_GetTimeInSeconds();
+
+	// Read the state of all actions once after syncing, this is also where
+	// edge-triggered actions are consumed so they're only seen once per sync
+	for (InputDevice* device : m_InputDevices)
+		device->UpdateState(session->Session);
+
+	return ovrSuccess;
+}
+
+ovrResult InputManager::GetInputState(ovrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+{
+	memset(inputState, 0, sizeof(ovrInputState));
+
+	std::lock_guard<std::mutex> lk(m_SyncMutex);
+
+	// Actions are synced once per frame by whichever comes first after the frame is waited on,
+	// this or BeginFrame. In low-latency mode they're also re-synced when the last sync is too old
+	double age = ovr_GetTimeInSeconds() - m_LastSyncTime;
+	if (m_LastSyncTime <= 0.0 || (m_ResyncThreshold > 0.0 && age > m_ResyncThreshold))
+		CHK_OVR(UpdateActionState(session));
 
 	uint32_t types = 0;
 	for (InputDevice* device : m_InputDevices)
@@ -136,7 +183,7 @@ ovrTouchHapticsDesc InputManager::GetTouchHapticsDesc(ovrControllerType controll
 	return desc;
 }
 
-unsigned int InputManager::SpaceRelationToPoseState(const XrSpaceLocation& location, double time, ovrPoseStatef& lastPoseState, ovrPoseStatef& outPoseState)
+unsigned int InputManager::SpaceRelationToPoseState(const XrSpaceLocation& location, const XrSpaceVelocity& velocity, double time, ovrPoseStatef& lastPoseState, ovrPoseStatef& outPoseState)
 {
 	unsigned int flags = 0;
 
@@ -162,11 +209,9 @@ unsigned int InputManager::SpaceRelationToPoseState(const XrSpaceLocation& locat
 		outPoseState.ThePose.Position = XR::Vector3f::Zero();
 	}
 
-	XrSpaceVelocity *spaceVelocity = (XrSpaceVelocity *) location.next;
-
-	if (spaceVelocity->velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT)
+	if (velocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT)
    {
-		XR::Vector3f currav(spaceVelocity->angularVelocity);
+		XR::Vector3f currav(velocity.angularVelocity);
 		outPoseState.AngularVelocity = currav;
 		outPoseState.AngularAcceleration = time > lastPoseState.TimeInSeconds ? (currav - XR::Vector3f(lastPoseState.AngularVelocity)) / float(time - lastPoseState.TimeInSeconds) : lastPoseState.AngularAcceleration;
 	}
@@ -176,9 +221,9 @@ unsigned int InputManager::SpaceRelationToPoseState(const XrSpaceLocation& locat
 		outPoseState.AngularAcceleration = XR::Vector3f::Zero();
 	}
 
-	if (spaceVelocity->velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT)
+	if (velocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT)
    {
-		XR::Vector3f currlv(spaceVelocity->linearVelocity);
+		XR::Vector3f currlv(velocity.linearVelocity);
 		outPoseState.LinearVelocity = currlv;
 		outPoseState.LinearAcceleration = time > lastPoseState.TimeInSeconds ? (currlv - XR::Vector3f(lastPoseState.LinearVelocity)) / float(time - lastPoseState.TimeInSeconds) : lastPoseState.LinearAcceleration;
 	}
@@ -193,6 +238,83 @@ unsigned int InputManager::SpaceRelationToPoseState(const XrSpaceLocation& locat
 	return flags;
 }
 
+void InputManager::InvalidateTrackingState()
+{
+	std::lock_guard<std::mutex> lk(m_LocationsMutex);
+	m_Locations = SpaceLocations();
+}
+
+ovrResult InputManager::LocateSpaces(ovrSession session, XrSpace baseSpace, XrTime displayTime, SpaceLocations* out_Locations)
+{
+	std::lock_guard<std::mutex> lk(m_LocationsMutex);
+
+	// Games query the same predicted display time many times per frame, so reuse the last result
+	if (m_Locations.Time == displayTime && m_Locations.BaseSpace == baseSpace)
+	{
+		MICROPROFILE_COUNTER_ADD("Tracking/LocateHits", 1);
+		*out_Locations = m_Locations;
+		return ovrSuccess;
+	}
+	MICROPROFILE_COUNTER_ADD("Tracking/LocateMisses", 1);
+
+	XrSpace spaces[REV_TRACKED_SPACE_COUNT] = { session->ViewSpace };
+	uint32_t spaceCount = 1;
+	for (uint32_t i = 0; i < ovrHand_Count && i < m_ActionSpaces.size(); i++)
+		spaces[spaceCount++] = m_ActionSpaces[i];
+
+	SpaceLocations locations = {};
+	if (Runtime::Get().LocateSpaces)
+	{
+		XR_FUNCTION(session->Instance, LocateSpacesKHR);
+
+		XrSpaceLocationDataKHR locationData[REV_TRACKED_SPACE_COUNT];
+		XrSpaceVelocityDataKHR velocityData[REV_TRACKED_SPACE_COUNT];
+		XrSpaceVelocitiesKHR velocities = XR_TYPE(SPACE_VELOCITIES_KHR);
+		velocities.velocityCount = spaceCount;
+		velocities.velocities = velocityData;
+		XrSpaceLocationsKHR spaceLocations = XR_TYPE(SPACE_LOCATIONS_KHR);
+		spaceLocations.next = &velocities;
+		spaceLocations.locationCount = spaceCount;
+		spaceLocations.locations = locationData;
+
+		XrSpacesLocateInfoKHR locateInfo = XR_TYPE(SPACES_LOCATE_INFO_KHR);
+		locateInfo.baseSpace = baseSpace;
+		locateInfo.time = displayTime;
+		locateInfo.spaceCount = spaceCount;
+		locateInfo.spaces = spaces;
+		CHK_XR(LocateSpacesKHR(session->Session, &locateInfo, &spaceLocations));
+
+		for (uint32_t i = 0; i < spaceCount; i++)
+		{
+			locations.Locations[i] = XR_TYPE(SPACE_LOCATION);
+			locations.Locations[i].locationFlags = locationData[i].locationFlags;
+			locations.Locations[i].pose = locationData[i].pose;
+			locations.Velocities[i] = XR_TYPE(SPACE_VELOCITY);
+			locations.Velocities[i].velocityFlags = velocityData[i].velocityFlags;
+			locations.Velocities[i].linearVelocity = velocityData[i].linearVelocity;
+			locations.Velocities[i].angularVelocity = velocityData[i].angularVelocity;
+			locations.Valid[i] = true;
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0; i < spaceCount; i++)
+		{
+			locations.Locations[i] = XR_TYPE(SPACE_LOCATION);
+			locations.Velocities[i] = XR_TYPE(SPACE_VELOCITY);
+			locations.Locations[i].next = &locations.Velocities[i];
+			locations.Valid[i] = XR_SUCCEEDED(xrLocateSpace(spaces[i], baseSpace, displayTime, &locations.Locations[i]));
+			locations.Locations[i].next = nullptr;
+		}
+	}
+
+	locations.Time = displayTime;
+	locations.BaseSpace = baseSpace;
+	m_Locations = locations;
+	*out_Locations = locations;
+	return ovrSuccess;
+}
+
 #ifdef PLOT_TRACKING
 ReviveTrackingPlotter trackingPlotter(1000);
 #endif
@@ -204,23 +326,22 @@ void InputManager::GetTrackingState(ovrSession session, ovrTrackingState* outSta
 	if (!session->Session)
 		return;
 
-	XrSpaceLocation location = XR_TYPE(SPACE_LOCATION);
-	XrSpaceVelocity velocity = XR_TYPE(SPACE_VELOCITY);
-	location.next = &velocity;
 	XrTime displayTime = absTime <= 0.0 ? (*session->CurrentFrame).predictedDisplayTime : AbsTimeToXrTime(session->Instance, absTime);
 	XrSpace space = (session->TrackingSpace == XR_REFERENCE_SPACE_TYPE_STAGE) ? session->StageSpace : session->LocalSpace;
 
+	SpaceLocations locations;
+	if (OVR_FAILURE(LocateSpaces(session, space, displayTime, &locations)))
+		return;
+
 	// Get space relation for the head
-	if (XR_SUCCEEDED(xrLocateSpace(session->ViewSpace, space, displayTime, &location)))
-		outState->StatusFlags = SpaceRelationToPoseState(location, absTime, m_LastTrackingState.HeadPose, outState->HeadPose);
+	if (locations.Valid[0])
+		outState->StatusFlags = SpaceRelationToPoseState(locations.Locations[0], locations.Velocities[0], absTime, m_LastTrackingState.HeadPose, outState->HeadPose);
 
 	// Convert the hand poses
 	for (uint32_t i = 0; i < ovrHand_Count; i++)
 	{
-		XrSpaceLocation handLocation = XR_TYPE(SPACE_LOCATION);
-		handLocation.next = &velocity;
-		if (i < m_ActionSpaces.size() && XR_SUCCEEDED(xrLocateSpace(m_ActionSpaces[i], space, displayTime, &handLocation)))
-			outState->HandStatusFlags[i] = SpaceRelationToPoseState(handLocation, absTime, m_LastTrackingState.HandPoses[i], outState->HandPoses[i]);
+		if (locations.Valid[1 + i])
+			outState->HandStatusFlags[i] = SpaceRelationToPoseState(locations.Locations[1 + i], locations.Velocities[1 + i], absTime, m_LastTrackingState.HandPoses[i], outState->HandPoses[i]);
 	}
 
 #ifdef PLOT_TRACKING
@@ -231,7 +352,7 @@ void InputManager::GetTrackingState(ovrSession session, ovrTrackingState* outSta
 
 	m_LastTrackingState = *outState;
 
-	outState->CalibratedOrigin = session->CalibratedOrigin;
+	outState->CalibratedOrigin = session->GetCalibratedOrigin();
 }
 
 ovrResult InputManager::GetDevicePoses(ovrSession session, ovrTrackedDeviceType* deviceTypes, int deviceCount, double absTime, ovrPoseStatef* outDevicePoses)
@@ -239,39 +360,34 @@ ovrResult InputManager::GetDevicePoses(ovrSession session, ovrTrackedDeviceType*
 	XrTime displayTime = absTime <= 0.0 ? (*session->CurrentFrame).predictedDisplayTime : AbsTimeToXrTime(session->Instance, absTime);
 	XrSpace space = (session->TrackingSpace == XR_REFERENCE_SPACE_TYPE_STAGE) ? session->StageSpace : session->LocalSpace;
 
-	XrSpaceLocation location = XR_TYPE(SPACE_LOCATION);
-	XrSpaceVelocity velocity = XR_TYPE(SPACE_VELOCITY);
-	location.next = &velocity;
+	SpaceLocations locations;
+	CHK_OVR(LocateSpaces(session, space, displayTime, &locations));
+
 	for (int i = 0; i < deviceCount; i++)
 	{
-		// Get the space for device types we recognize
-		XrSpace space = XR_NULL_HANDLE;
-      ovrPoseStatef* pLastState = nullptr;
+		// Get the location for device types we recognize
+		int index = -1;
+		ovrPoseStatef* pLastState = nullptr;
 		switch (deviceTypes[i])
 		{
 		case ovrTrackedDevice_HMD:
-			space = session->ViewSpace;
-         pLastState = &m_LastTrackingState.HeadPose;
+			index = 0;
+			pLastState = &m_LastTrackingState.HeadPose;
 			break;
 		case ovrTrackedDevice_LTouch:
-			space = m_ActionSpaces[ovrHand_Left];
-         pLastState = &m_LastTrackingState.HandPoses[ovrHand_Left];
+			index = 1 + ovrHand_Left;
+			pLastState = &m_LastTrackingState.HandPoses[ovrHand_Left];
 			break;
 		case ovrTrackedDevice_RTouch:
-			space = m_ActionSpaces[ovrHand_Right];
-         pLastState = &m_LastTrackingState.HandPoses[ovrHand_Right];
+			index = 1 + ovrHand_Right;
+			pLastState = &m_LastTrackingState.HandPoses[ovrHand_Right];
 			break;
 		}
 
-		if (space && pLastState)
-		{
-			CHK_XR(xrLocateSpace(m_ActionSpaces[i], space, displayTime, &location));
-			SpaceRelationToPoseState(location, absTime, *pLastState, outDevicePoses[i]);
-		}
+		if (index >= 0 && locations.Valid[index])
+			SpaceRelationToPoseState(locations.Locations[index], locations.Velocities[index], absTime, *pLastState, outDevicePoses[i]);
 		else
-		{
 			outDevicePoses[i] = ovrPoseStatef{ OVR::Posef::Identity() };
-		}
 	}
 
 	return ovrSuccess;
@@ -380,25 +496,6 @@ InputManager::InputDevice::~InputDevice()
 	assert(XR_SUCCEEDED(rs));
 }
 
-ovrVector2f InputManager::InputDevice::ApplyDeadzone(ovrVector2f axis, float deadZone)
-{
-	XR::Vector2f vector(axis);
-	float mag = vector.Length();
-	if (mag > deadZone)
-	{
-		// scale such that output magnitude is in the range[0, 1]
-		float legalRange = 1.0f - deadZone;
-		float normalizedMag = std::min(1.0f, (mag - deadZone) / legalRange);
-		float scale = normalizedMag / mag;
-		return vector * scale;
-	}
-	else
-	{
-		// stick is in the inner dead zone
-		return OVR::Vector2f();
-	}
-}
-
 ovrButton InputManager::InputDevice::TrackpadToDPad(ovrVector2f trackpad)
 {
 	if (trackpad.y < trackpad.x) {
@@ -415,34 +512,6 @@ ovrButton InputManager::InputDevice::TrackpadToDPad(ovrVector2f trackpad)
 	}
 }
 
-void InputManager::OculusTouch::HapticsThread(XrSession session, OculusTouch* device)
-{
-	std::chrono::microseconds freq(std::chrono::seconds(1));
-	freq /= REV_HAPTICS_SAMPLE_RATE;
-
-	while (device->m_bHapticsRunning)
-	{
-		for (int i = 0; i < ovrHand_Count; i++)
-		{
-			float amplitude = device->m_HapticsBuffer[i].GetSample();
-			if (amplitude > 0.0f)
-			{
-				XrHapticActionInfo info = XR_TYPE(HAPTIC_ACTION_INFO);
-				info.action = device->m_Vibration;
-				info.subactionPath = s_SubActionPaths[i];
-				XrHapticVibration vibration = XR_TYPE(HAPTIC_VIBRATION);
-				vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
-				vibration.amplitude = amplitude;
-				vibration.duration = (XrDuration)std::chrono::nanoseconds(freq).count();
-				XrResult rs = xrApplyHapticFeedback(session, &info, (XrHapticBaseHeader*)&vibration);
-				assert(XR_SUCCEEDED(rs));
-			}
-		}
-
-		std::this_thread::sleep_for(freq);
-	}
-}
-
 InputManager::OculusTouch::OculusTouch(XrInstance instance)
 	: InputDevice(instance, "touch", "Oculus Touch")
 	, m_bHapticsRunning(false)
@@ -461,6 +530,7 @@ InputManager::OculusTouch::OculusTouch(XrInstance instance)
 	, m_Thumbstick(this, XR_ACTION_TYPE_VECTOR2F_INPUT, "thumbstick", "Thumbstick", true)
 	, m_Pose(this, XR_ACTION_TYPE_POSE_INPUT, "pose", "Controller pose", true)
 	, m_Vibration(this, XR_ACTION_TYPE_VIBRATION_OUTPUT, "vibration", "Vibration", true)
+	, m_Snapshot()
 {
 	if (Runtime::Get().UseHack(Runtime::HACK_WMR_PROFILE))
 		m_Trackpad_Buttons = Action(this, XR_ACTION_TYPE_FLOAT_INPUT, "trackpad-buttons", "Trackpad Buttons", true);
@@ -468,18 +538,48 @@ InputManager::OculusTouch::OculusTouch(XrInstance instance)
 
 InputManager::OculusTouch::~OculusTouch()
 {
-	m_bHapticsRunning = false;
-	if (m_HapticsThread.joinable())
-		m_HapticsThread.join();
+	if (m_bHapticsRunning)
+	{
+		for (int i = 0; i < ovrHand_Count; i++)
+			HapticsScheduler::Get().RemoveOutput(&m_HapticsBuffer[i]);
+	}
 }
 
 void InputManager::OculusTouch::StartHaptics(XrSession session)
 {
-	if (m_bHapticsRunning)
+	if (m_bHapticsRunning.exchange(true))
 		return;
 
-	m_bHapticsRunning = true;
-	m_HapticsThread = std::thread(HapticsThread, session, this);
+	// Tune the conversion to vibration segments to the actuators of the interaction profile:
+	// Touch and Index controllers have responsive actuators that can follow pulse patterns,
+	// while the rumble motors of WMR controllers only follow a coarse amplitude envelope.
+	HapticsEnvelope envelope = { 16, 32, 8, true };
+	if (Runtime::Get().UseHack(Runtime::HACK_VALVE_INDEX_PROFILE))
+		envelope = { 16, 32, 16, true };
+	else if (Runtime::Get().UseHack(Runtime::HACK_WMR_PROFILE))
+		envelope = { 8, 64, 32, false };
+
+	// The compatibility profile can retune the envelope for titles with unusual haptics
+	if (Runtime::Get().Profile.OverrideHaptics)
+		envelope = Runtime::Get().Profile.Haptics;
+
+	for (int i = 0; i < ovrHand_Count; i++)
+	{
+		XrAction action = m_Vibration;
+		XrPath subactionPath = s_SubActionPaths[i];
+		HapticsScheduler::Get().AddOutput(&m_HapticsBuffer[i], envelope, [session, action, subactionPath](const HapticsSegment& segment)
+		{
+			XrHapticActionInfo info = XR_TYPE(HAPTIC_ACTION_INFO);
+			info.action = action;
+			info.subactionPath = subactionPath;
+			XrHapticVibration vibration = XR_TYPE(HAPTIC_VIBRATION);
+			vibration.frequency = segment.Frequency > 0.0f ? segment.Frequency : XR_FREQUENCY_UNSPECIFIED;
+			vibration.amplitude = segment.Amplitude;
+			vibration.duration = (XrDuration)segment.Samples * 1000000000 / REV_HAPTICS_SAMPLE_RATE;
+			XrResult rs = xrApplyHapticFeedback(session, &info, (XrHapticBaseHeader*)&vibration);
+			assert(XR_SUCCEEDED(rs));
+		});
+	}
 }
 
 XrPath InputManager::OculusTouch::GetSuggestedBindings(std::vector<XrActionSuggestedBinding>& outBindings) const
@@ -584,94 +684,34 @@ bool InputManager::OculusTouch::IsConnected() const
 	return true;
 }
 
-bool InputManager::OculusTouch::GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+void InputManager::OculusTouch::UpdateState(XrSession session)
 {
-	if (m_Button_Enter.GetDigital(session))
-		inputState->Buttons |= ovrButton_Enter;
+	bool wmrProfile = Runtime::Get().UseHack(Runtime::HACK_WMR_PROFILE);
 
-	// In most games this doesn't really do anything,
-	// because it would normally open the dashboard.
-	if (m_Button_Home.GetDigital(session))
-		inputState->Buttons |= ovrButton_Home;
+	m_Snapshot.Button_Enter = m_Button_Enter.GetDigital(session);
+	m_Snapshot.Button_Home = m_Button_Home.GetDigital(session);
 
 	for (int i = 0; i < ovrHand_Count; i++)
 	{
 		ovrHandType hand = (ovrHandType)i;
-		unsigned int buttons = 0, touches = 0;
-
-		if (Runtime::Get().UseHack(Runtime::HACK_WMR_PROFILE))
-		{
-			if (m_Button_AX.GetDigital(session, hand) || m_Button_BY.GetDigital(session, hand))
-			{
-				if (m_Trackpad_Buttons.GetAnalog(session, hand) > 0.0f)
-					buttons |= ovrButton_B;
-				else
-					buttons |= ovrButton_A;
-			}
-
-			if (m_Touch_AX.GetDigital(session, hand) || m_Touch_BY.GetDigital(session, hand))
-			{
-				if (m_Trackpad_Buttons.GetAnalog(session, hand) > 0.0f)
-					touches |= ovrTouch_B;
-				else
-					touches |= ovrTouch_A;
-			}
-		}
-		else
-		{
-			if (m_Button_AX.GetDigital(session, hand))
-				buttons |= ovrButton_A;
-
-			if (m_Touch_AX.GetDigital(session, hand))
-				touches |= ovrTouch_A;
-
-			if (m_Button_BY.GetDigital(session, hand))
-				buttons |= ovrButton_B;
-
-			if (m_Touch_BY.GetDigital(session, hand))
-				touches |= ovrTouch_B;
-		}
-
-		if (m_Button_Thumb.GetDigital(session, hand))
-			buttons |= ovrButton_RThumb;
-
-		if (m_Touch_Thumb.GetDigital(session, hand))
-			touches |= ovrTouch_RThumb;
-
-		if (m_Touch_ThumbRest.GetDigital(session, hand))
-			touches |= ovrTouch_RThumbRest;
-
-		if (m_Touch_IndexTrigger.GetDigital(session, hand))
-			touches |= ovrTouch_RIndexTrigger;
-
-		inputState->ThumbstickNoDeadzone[i] = m_Thumbstick.GetVector(session, hand);
-		inputState->IndexTriggerNoDeadzone[i] = m_IndexTrigger.GetAnalog(session, hand);
-		inputState->HandTriggerNoDeadzone[i] = m_HandTrigger.GetAnalog(session, hand);
-
-		// Derive gestures from touch flags
-		if (inputState->HandTriggerNoDeadzone[i] > 0.5f)
-		{
-			if (!(touches & ovrTouch_RIndexTrigger))
-				touches |= ovrTouch_RIndexPointing;
-
-			if (!(touches & ~(ovrTouch_RIndexTrigger | ovrTouch_RIndexPointing)))
-				touches |= ovrTouch_RThumbUp;
-		}
-
-		// Apply deadzones where needed
-		inputState->Thumbstick[i] = ApplyDeadzone(inputState->ThumbstickNoDeadzone[i], 0.24f);
-		inputState->IndexTrigger[i] = inputState->IndexTriggerNoDeadzone[i];
-		inputState->HandTrigger[i] = inputState->HandTriggerNoDeadzone[i];
-
-		// We have no way to get raw values
-		inputState->ThumbstickRaw[i] = inputState->ThumbstickNoDeadzone[i];
-		inputState->IndexTriggerRaw[i] = inputState->IndexTriggerNoDeadzone[i];
-		inputState->HandTriggerRaw[i] = inputState->HandTriggerNoDeadzone[i];
-
-		inputState->Buttons |= (hand == ovrHand_Left) ? buttons << 8 : buttons;
-		inputState->Touches |= (hand == ovrHand_Left) ? touches << 8 : touches;
+		m_Snapshot.Button_AX[i] = m_Button_AX.GetDigital(session, hand);
+		m_Snapshot.Button_BY[i] = m_Button_BY.GetDigital(session, hand);
+		m_Snapshot.Button_Thumb[i] = m_Button_Thumb.GetDigital(session, hand);
+		m_Snapshot.Touch_AX[i] = m_Touch_AX.GetDigital(session, hand);
+		m_Snapshot.Touch_BY[i] = m_Touch_BY.GetDigital(session, hand);
+		m_Snapshot.Touch_Thumb[i] = m_Touch_Thumb.GetDigital(session, hand);
+		m_Snapshot.Touch_ThumbRest[i] = m_Touch_ThumbRest.GetDigital(session, hand);
+		m_Snapshot.Touch_IndexTrigger[i] = m_Touch_IndexTrigger.GetDigital(session, hand);
+		m_Snapshot.IndexTrigger[i] = m_IndexTrigger.GetAnalog(session, hand);
+		m_Snapshot.HandTrigger[i] = m_HandTrigger.GetAnalog(session, hand);
+		m_Snapshot.Trackpad_Buttons[i] = wmrProfile ? m_Trackpad_Buttons.GetAnalog(session, hand) : 0.0f;
+		m_Snapshot.Thumbstick[i] = m_Thumbstick.GetVector(session, hand);
 	}
+}
 
+bool InputManager::OculusTouch::GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+{
+	TouchSnapshotToInputState(m_Snapshot, Runtime::Get().UseHack(Runtime::HACK_WMR_PROFILE), inputState);
 	return true;
 }
 
@@ -710,6 +750,7 @@ void InputManager::OculusTouch::SubmitVibration(ovrControllerType controllerType
 		m_HapticsBuffer[ovrHand_Left].AddSamples(buffer);
 	if (controllerType & ovrControllerType_RTouch)
 		m_HapticsBuffer[ovrHand_Right].AddSamples(buffer);
+	HapticsScheduler::Get().Wake();
 }
 
 InputManager::OculusRemote::OculusRemote(XrInstance instance)
@@ -732,13 +773,16 @@ bool InputManager::OculusRemote::IsConnected() const
 	return m_IsConnected;
 }
 
-bool InputManager::OculusRemote::GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+void InputManager::OculusRemote::UpdateState(XrSession session)
 {
-	unsigned int buttons;
-
 	// Allow the user to enable/disable the remote
 	if (m_Toggle_Connected.IsPressed(session))
 		m_IsConnected = !m_IsConnected;
+}
+
+bool InputManager::OculusRemote::GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState)
+{
+	unsigned int buttons;
 
 	if (m_Button_Up.GetDigital(session))
 		buttons |= ovrButton_Up;
@@ -921,6 +965,13 @@ void InputManager::XboxGamepad::GetActiveSets(std::vector<XrActiveActionSet>& ou
 
 ovrResult InputManager::AttachSession(XrSession session)
 {
+	InvalidateTrackingState();
+
+	{
+		std::lock_guard<std::mutex> lk(m_SyncMutex);
+		m_LastSyncTime = 0.0;
+	}
+
 	for (XrSpace space : m_ActionSpaces)
 		CHK_XR(xrDestroySpace(space));
 	m_ActionSpaces.clear();
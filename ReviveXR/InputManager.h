@@ -3,6 +3,8 @@
 #include "Common.h"
 #include "OVR_CAPI.h"
 #include "HapticsBuffer.h"
+#include "HapticsScheduler.h"
+#include "TouchInput.h"
 
 #include <openxr/openxr.h>
 #include <thread>
@@ -10,6 +12,9 @@
 #include <atomic>
 #include <mutex>
 
+// The head and both hands
+#define REV_TRACKED_SPACE_COUNT (1 + ovrHand_Count)
+
 class Runtime;
 
 class InputManager
@@ -24,6 +29,7 @@ public:
 		// Input
 		virtual ovrControllerType GetType() const = 0;
 		virtual bool IsConnected() const = 0;
+		virtual void UpdateState(XrSession session) { }
 		virtual bool GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState) = 0;
 
 		// Bindings
@@ -40,7 +46,6 @@ public:
 		XrActionSet ActionSet() const { return m_ActionSet; }
 
 	protected:
-		static ovrVector2f ApplyDeadzone(ovrVector2f axis, float deadZone);
 		static ovrButton TrackpadToDPad(ovrVector2f trackpad);
 
 		XrActionSet m_ActionSet;
@@ -74,6 +79,7 @@ public:
 
 		virtual ovrControllerType GetType() const override;
 		virtual bool IsConnected() const override;
+		virtual void UpdateState(XrSession session) override;
 		virtual bool GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState) override;
 		virtual XrPath GetSuggestedBindings(std::vector<XrActionSuggestedBinding>& outBindings) const override;
 		virtual void GetActionSpaces(XrSession session, std::vector<XrSpace>& outSpaces) const override;
@@ -106,11 +112,12 @@ public:
 
 		Action m_Pose;
 		Action m_Vibration;
+
+		// State of all input actions, read once after every action sync
+		TouchActionSnapshot m_Snapshot;
+
 		std::atomic_bool m_bHapticsRunning;
 		HapticsBuffer m_HapticsBuffer[ovrHand_Count];
-
-		std::thread m_HapticsThread;
-		static void HapticsThread(XrSession session, OculusTouch* device);
 	};
 
 	class OculusRemote : public InputDevice
@@ -121,6 +128,7 @@ public:
 
 		virtual ovrControllerType GetType() const override { return ovrControllerType_Remote; }
 		virtual bool IsConnected() const override;
+		virtual void UpdateState(XrSession session) override;
 		virtual bool GetInputState(XrSession session, ovrControllerType controllerType, ovrInputState* inputState) override;
 		virtual void GetActiveSets(std::vector<XrActiveActionSet>& outSets) const override;
 
@@ -178,6 +186,8 @@ public:
 	~InputManager();
 
 	ovrResult AttachSession(XrSession session);
+	void InvalidateActionState();
+	ovrResult SyncActions(ovrSession session);
 
 	static ovrTouchHapticsDesc GetTouchHapticsDesc(ovrControllerType controllerType);
 	ovrResult SetControllerVibration(ovrSession session, ovrControllerType controllerType, float frequency, float amplitude);
@@ -186,6 +196,7 @@ public:
 	ovrResult GetControllerVibrationState(ovrSession session, ovrControllerType controllerType, ovrHapticsPlaybackState* outState);
 
 	void GetTrackingState(ovrSession session, ovrTrackingState* outState, double absTime);
+	void InvalidateTrackingState();
 	ovrResult GetDevicePoses(ovrSession session, ovrTrackedDeviceType* deviceTypes, int deviceCount, double absTime, ovrPoseStatef* outDevicePoses);
 
 protected:
@@ -196,8 +207,28 @@ protected:
 	std::vector<XrSpace> m_ActionSpaces;
 	std::vector<XrActiveActionSet> m_ActionSets;
 
+	// Actions are synced once per frame, either when the input state is queried or in BeginFrame.
+	// In low-latency mode they're also re-synced when the last sync is older than the threshold
+	std::mutex m_SyncMutex;
+	double m_LastSyncTime;
+	double m_ResyncThreshold;
+	ovrResult UpdateActionState(ovrSession session);
+
 	ovrTrackingState m_LastTrackingState;
 
-	static unsigned int SpaceRelationToPoseState(const XrSpaceLocation& location, double time, ovrPoseStatef& lastPoseState, ovrPoseStatef& outPoseState);
+	// Locations of the head and hands, memoized for the last display time and base space until the next frame begins
+	struct SpaceLocations
+	{
+		XrTime Time;
+		XrSpace BaseSpace;
+		bool Valid[REV_TRACKED_SPACE_COUNT];
+		XrSpaceLocation Locations[REV_TRACKED_SPACE_COUNT];
+		XrSpaceVelocity Velocities[REV_TRACKED_SPACE_COUNT];
+	};
+	std::mutex m_LocationsMutex;
+	SpaceLocations m_Locations;
+
+	ovrResult LocateSpaces(ovrSession session, XrSpace baseSpace, XrTime displayTime, SpaceLocations* out_Locations);
+	static unsigned int SpaceRelationToPoseState(const XrSpaceLocation& location, const XrSpaceVelocity& velocity, double time, ovrPoseStatef& lastPoseState, ovrPoseStatef& outPoseState);
 };
 
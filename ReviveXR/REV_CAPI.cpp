@@ -5,10 +5,13 @@
 #include "version.h"
 
 #include "Common.h"
+#include "CompositionLayers.h"
 #include "Session.h"
 #include "Runtime.h"
 #include "InputManager.h"
 #include "SwapChain.h"
+#include "CallRecorder.h"
+#include "GpuTimer.h"
 
 #include <Windows.h>
 #include <openxr/openxr.h>
@@ -71,6 +74,9 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params)
 	DetachDetours();
 	ovrResult rs = Runtime::Get().CreateInstance(&g_Instance, params);
 	AttachDetours();
+
+	if (OVR_SUCCESS(rs))
+		CallRecorder::Get().Open(Runtime::Get().MinorVersion);
 	return rs;
 }
 
@@ -94,6 +100,8 @@ OVR_PUBLIC_FUNCTION(void) ovr_Shutdown()
 	assert(XR_SUCCEEDED(rs));
 	g_Instance = XR_NULL_HANDLE;
 
+	TraceRecorder::Get().Dump("Shutdown");
+	CallRecorder::Get().Close();
 	MicroProfileShutdown();
 }
 
@@ -237,73 +245,8 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessi
 	if (!sessionStatus)
 		return ovrError_InvalidParameter;
 
-	SessionStatusBits& status = session->SessionStatus;
-	XrEventDataBuffer event = XR_TYPE(EVENT_DATA_BUFFER);
-	while (xrPollEvent(session->Instance, &event) == XR_SUCCESS)
-	{
-		switch (event.type)
-		{
-		case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
-		{
-			const XrEventDataSessionStateChanged& stateChanged =
-				reinterpret_cast<XrEventDataSessionStateChanged&>(event);
-			if (stateChanged.session == session->Session)
-			{
-				switch (stateChanged.state)
-				{
-				case XR_SESSION_STATE_IDLE:
-					status.HmdPresent = true;
-					break;
-				case XR_SESSION_STATE_READY:
-					status.IsVisible = true;
-					status.HmdMounted = true;
-					break;
-				case XR_SESSION_STATE_SYNCHRONIZED:
-					status.HmdMounted = false;
-					break;
-				case XR_SESSION_STATE_VISIBLE:
-					status.HmdMounted = true;
-					status.HasInputFocus = false;
-					break;
-				case XR_SESSION_STATE_FOCUSED:
-					status.HasInputFocus = true;
-					break;
-				case XR_SESSION_STATE_STOPPING:
-					status.IsVisible = false;
-					break;
-				case XR_SESSION_STATE_LOSS_PENDING:
-					status.DisplayLost = true;
-					break;
-				case XR_SESSION_STATE_EXITING:
-					status.ShouldQuit = true;
-					break;
-				}
-			}
-			break;
-		}
-		case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
-		{
-			const XrEventDataInstanceLossPending& lossPending =
-				reinterpret_cast<XrEventDataInstanceLossPending&>(event);
-			status.ShouldQuit = true;
-			break;
-		}
-		case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING:
-		{
-			const XrEventDataReferenceSpaceChangePending& spaceChange =
-				reinterpret_cast<XrEventDataReferenceSpaceChangePending&>(event);
-			if (spaceChange.referenceSpaceType == XR_REFERENCE_SPACE_TYPE_LOCAL)
-			{
-				if (spaceChange.poseValid)
-					session->CalibratedOrigin = XR::Posef(session->CalibratedOrigin) * XR::Posef(spaceChange.poseInPreviousSpace);
-				status.ShouldRecenter = true;
-			}
-			break;
-		}
-		}
-		event = XR_TYPE(EVENT_DATA_BUFFER);
-	}
-
+	// The event pump keeps the status up-to-date, so this is just a snapshot
+	SessionStatusBits status = session->SessionStatus;
 	sessionStatus->IsVisible = status.IsVisible;
 	sessionStatus->HmdPresent = status.HmdPresent;
 	sessionStatus->HmdMounted = status.HmdMounted;
@@ -364,13 +307,18 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SpecifyTrackingOrigin(ovrSession session, ovr
 	// Get a leveled head pose
 	float yaw;
 	OVR::Quatf(originPose.Orientation).GetYawPitchRoll(&yaw, nullptr, nullptr);
-	OVR::Posef newOrigin = OVR::Posef(session->CalibratedOrigin) * OVR::Posef(OVR::Quatf(OVR::Axis_Y, yaw), originPose.Position);
-	session->CalibratedOrigin = newOrigin.Normalized();
+	OVR::Posef newOrigin;
+	{
+		std::lock_guard<std::mutex> lk(session->OriginMutex);
+		newOrigin = OVR::Posef(session->CalibratedOrigin) * OVR::Posef(OVR::Quatf(OVR::Axis_Y, yaw), originPose.Position);
+		newOrigin = newOrigin.Normalized();
+		session->CalibratedOrigin = newOrigin;
+	}
 
 	XrSpace oldSpace = session->LocalSpace;
 	XrReferenceSpaceCreateInfo spaceInfo = XR_TYPE(REFERENCE_SPACE_CREATE_INFO);
 	spaceInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
-	spaceInfo.poseInReferenceSpace = XR::Posef(session->CalibratedOrigin);
+	spaceInfo.poseInReferenceSpace = XR::Posef(newOrigin);
 	CHK_XR(xrCreateReferenceSpace(session->Session, &spaceInfo, &session->LocalSpace));
 	CHK_XR(xrDestroySpace(oldSpace));
 
@@ -380,7 +328,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SpecifyTrackingOrigin(ovrSession session, ovr
 
 OVR_PUBLIC_FUNCTION(void) ovr_ClearShouldRecenterFlag(ovrSession session)
 {
-	session->SessionStatus.ShouldRecenter = false;
+	session->UpdateSessionStatus([](SessionStatusBits& status) { status.ShouldRecenter = false; });
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker)
@@ -389,8 +337,18 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, d
 
 	ovrTrackingState state = { 0 };
 
+	if (CallRecorder::Get().IsEnabled())
+		CallRecorder::Get().Record(RECORD_GET_TRACKING_STATE, &absTime, sizeof(absTime));
+
+	// Some titles need a different prediction than they ask for
+	if (absTime > 0.0)
+		absTime += Runtime::Get().Profile.PredictionOffset;
+
 	if (session && session->Input)
+	{
+		session->Spikes.CountTrackingQuery();
 		session->Input->GetTrackingState(session, &state, absTime);
+	}
 
 	return state;
 }
@@ -402,6 +360,9 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetDevicePoses(ovrSession session, ovrTracked
 	if (!session)
 		return ovrError_InvalidSession;
 
+	if (absTime > 0.0)
+		absTime += Runtime::Get().Profile.PredictionOffset;
+
 	return session->Input->GetDevicePoses(session, deviceTypes, deviceCount, absTime, outDevicePoses);
 }
 
@@ -495,6 +456,10 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, ovrControll
 	if (!inputState)
 		return ovrError_InvalidParameter;
 
+	session->Spikes.CountInputQuery();
+	if (CallRecorder::Get().IsEnabled())
+		CallRecorder::Get().Record(RECORD_GET_INPUT_STATE, &controllerType, sizeof(uint32_t));
+
 	ovrInputState state = { 0 };
 
 	ovrResult result = ovrSuccess;
@@ -748,19 +713,27 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CommitTextureSwapChain(ovrSession session, ov
 
 	MICROPROFILE_META_CPU("Identifier", (int)chain->Swapchain);
 	MICROPROFILE_META_CPU("CurrentIndex", chain->CurrentIndex);
+	session->Spikes.CountCommit();
+	if (CallRecorder::Get().IsEnabled())
+	{
+		uint64_t handle = (uint64_t)(uintptr_t)chain;
+		CallRecorder::Get().Record(RECORD_COMMIT_SWAP_CHAIN, &handle, sizeof(handle));
+	}
+
+	// The image can't be released until the wait thread is done with it
+	session->ChainWaiter.WaitReady(chain);
 
 	XrSwapchainImageReleaseInfo releaseInfo = XR_TYPE(SWAPCHAIN_IMAGE_RELEASE_INFO);
 	CHK_XR(xrReleaseSwapchainImage(chain->Swapchain, &releaseInfo));
+	(*session->CurrentFrame).commitTime = ovr_GetTimeInSeconds();
 
 	if (!chain->Desc.StaticImage)
 	{
 		XrSwapchainImageAcquireInfo acquireInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
 		CHK_XR(xrAcquireSwapchainImage(chain->Swapchain, &acquireInfo, &chain->CurrentIndex));
 
-		{
-			std::unique_lock<std::mutex> lk(session->ChainMutex);
-			session->AcquiredChains.push_back(chain->Swapchain);
-		}
+		// Hand the image to the wait thread so it's ready by the time we begin the next frame
+		session->ChainWaiter.Submit(chain);
 	}
 
 	return ovrSuccess;
@@ -773,15 +746,14 @@ OVR_PUBLIC_FUNCTION(void) ovr_DestroyTextureSwapChain(ovrSession session, ovrTex
 	if (!chain)
 		return;
 
-	{
-		std::unique_lock<std::mutex> lk(session->ChainMutex);
-		session->AcquiredChains.remove(chain->Swapchain);
-	}
+	// The chain may still be queued, so let the wait thread finish with it
+	session->ChainWaiter.WaitReady(chain);
 
-	XrResult rs = xrDestroySwapchain(chain->Swapchain);
-	assert(XR_SUCCEEDED(rs));
-	delete[] chain->Images;
-	delete chain;
+	// Park the swapchain in the pool in case the title creates an equivalent one
+	if (session->Session && session->ChainPool.Release(chain))
+		return;
+
+	DestroySwapChain(chain);
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_DestroyMirrorTexture(ovrSession session, ovrMirrorTexture mirrorTexture)
@@ -854,6 +826,10 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_WaitToBeginFrame(ovrSession session, long lon
 	if (!session)
 		return ovrError_InvalidSession;
 
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_WAIT);
+	if (CallRecorder::Get().IsEnabled())
+		CallRecorder::Get().Record(RECORD_WAIT_TO_BEGIN_FRAME, &frameIndex, sizeof(frameIndex));
+
 	XrIndexedFrameState* frameState = session->CurrentFrame + 1;
 	if (frameState > &session->FrameStats[ovrMaxProvidedFrameStats - 1])
 		frameState = session->FrameStats;
@@ -861,7 +837,29 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_WaitToBeginFrame(ovrSession session, long lon
 	XrFrameWaitInfo waitInfo = XR_TYPE(FRAME_WAIT_INFO);
 	CHK_XR(xrWaitFrame(session->Session, &waitInfo, frameState));
 	frameState->frameIndex = frameIndex + 1;
+	frameState->waitTime = ovr_GetTimeInSeconds();
+	frameState->beginTime = 0.0;
+	frameState->commitTime = 0.0;
+	frameState->endTime = 0.0;
+	frameState->sampleTime = 0.0;
+	frameState->gpuTime = 0.0f;
+
+	// Count the display periods skipped since the last frame as dropped frames
+	XrIndexedFrameState* lastFrame = session->CurrentFrame;
+	if (lastFrame->predictedDisplayTime > 0 && frameState->predictedDisplayPeriod > 0)
+	{
+		XrDuration elapsed = frameState->predictedDisplayTime - lastFrame->predictedDisplayTime;
+		long long periods = (elapsed + frameState->predictedDisplayPeriod / 2) / frameState->predictedDisplayPeriod;
+		if (periods > 1)
+			session->DroppedFrames += (uint32_t)(periods - 1);
+	}
+
 	session->CurrentFrame = frameState;
+	frameState->displayTime = ovr_GetPredictedDisplayTime(session, 0);
+
+	// Input queried after this point should reflect the new frame
+	if (session->Input)
+		session->Input->InvalidateActionState();
 	return ovrSuccess;
 }
 
@@ -873,36 +871,40 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_BeginFrame(ovrSession session, long long fram
 	if (!session)
 		return ovrError_InvalidSession;
 
-	// Wait on all outstanding surfaces
-	XrSwapchainImageWaitInfo chainWaitInfo = XR_TYPE(SWAPCHAIN_IMAGE_WAIT_INFO);
-	chainWaitInfo.timeout = XR_NO_DURATION;
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_BEGIN);
+	if (CallRecorder::Get().IsEnabled())
+		CallRecorder::Get().Record(RECORD_BEGIN_FRAME, &frameIndex, sizeof(frameIndex));
+
+	// Wait until the wait thread is done with all outstanding surfaces
 	{
-		std::unique_lock<std::mutex> lk(session->ChainMutex);
-		while (!session->AcquiredChains.empty())
-		{
-			CHK_XR(xrWaitSwapchainImage(session->AcquiredChains.front(), &chainWaitInfo));
-			session->AcquiredChains.pop_front();
-		}
+		REV_TRACE_SCOPE(WaitSwapchains);
+		MICROPROFILE_SCOPEI("Revive", "WaitSwapchains", 0xff0000);
+		double start = ovr_GetTimeInSeconds();
+		XrResult rs = session->ChainWaiter.WaitAll();
+		session->BeginFrameBlockTime.Add((int64_t)((ovr_GetTimeInSeconds() - start) * 1000000.0));
+		session->SerialWaitTime.Add(session->ChainWaiter.TakeWaitTime());
+		CHK_XR(rs);
 	}
 
 	XrFrameBeginInfo beginInfo = XR_TYPE(FRAME_BEGIN_INFO);
 	CHK_XR(xrBeginFrame(session->Session, &beginInfo));
-	return ovrSuccess;
-}
+	(*session->CurrentFrame).beginTime = ovr_GetTimeInSeconds();
+	SetEvent(session->EventPumpEvent);
 
-union XrCompositionLayerUnion
-{
-	XrCompositionLayerBaseHeader Header;
-	XrCompositionLayerProjection Projection;
-	XrCompositionLayerQuad Quad;
-	XrCompositionLayerCylinderKHR Cylinder;
-	XrCompositionLayerCubeKHR Cube;
-};
+	if (session->FrameTimer)
+		session->FrameTimer->Begin();
 
-struct XrCompositionLayerProjectionViewStereo
-{
-	XrCompositionLayerProjectionView Views[ovrEye_Count];
-};
+	// Poses queried during the previous frame are stale now
+	if (session->Input)
+	{
+		session->Input->InvalidateTrackingState();
+
+		// Failing to sync the input shouldn't fail the frame, the input state will simply be stale
+		if (OVR_FAILURE(session->Input->SyncActions(session)))
+			OutputDebugStringA("Revive: Failed to sync the input actions\n");
+	}
+	return ovrSuccess;
+}
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_EndFrame(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc,
 	ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
@@ -913,190 +915,51 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_EndFrame(ovrSession session, long long frameI
 	if (!session)
 		return ovrError_InvalidSession;
 
-	std::vector<XrCompositionLayerBaseHeader*> layers;
-	std::list<XrCompositionLayerUnion> layerData;
-	std::list<XrCompositionLayerProjectionViewStereo> viewData;
-	std::list<XrCompositionLayerDepthInfoKHR> depthData;
-	for (unsigned int i = 0; i < layerCount; i++)
-	{
-		ovrLayer_Union* layer = (ovrLayer_Union*)layerPtrList[i];
-
-		if (!layer)
-			continue;
-
-		ovrLayerType type = layer->Header.Type;
-		const bool upsideDown = layer->Header.Flags & ovrLayerFlag_TextureOriginAtBottomLeft;
-		const bool headLocked = layer->Header.Flags & ovrLayerFlag_HeadLocked;
-
-		// Version 1.25 introduced a 128-byte reserved parameter, so on older versions the actual data
-		// falls within this reserved parameter and we need to move the pointer back into the actual data area.
-		// NOTE: Do not read the header after this operation as it will fall outside of the layer memory.
-		if (Runtime::Get().MinorVersion < 25)
-			layer = (ovrLayer_Union*)((char*)layer - sizeof(ovrLayerHeader::Reserved));
-
-		// The oculus runtime is very tolerant of invalid viewports, so this lambda ensures we submit valid ones.
-		auto ClampRect = [](ovrRecti rect, ovrTextureSwapChain chain)
-		{
-			OVR::Sizei chainSize(chain->Desc.Width, chain->Desc.Height);
-
-			if (rect.Size.w <= 0 || rect.Size.h <= 0)
-				return XR::Recti(OVR::Vector2i::Max(rect.Pos, OVR::Vector2i()), chainSize);
-
-			return XR::Recti(OVR::Vector2i::Max(rect.Pos, OVR::Vector2i()),
-				OVR::Sizei::Min(rect.Size, chainSize));
-		};
-
-		layerData.emplace_back();
-		XrCompositionLayerUnion& newLayer = layerData.back();
+	// The Oculus runtime rejects frames with more than ovrMaxLayerCount layers
+	if (layerCount > ovrMaxLayerCount)
+		return ovrError_InvalidParameter;
 
-		if (type == ovrLayerType_EyeFov || type == ovrLayerType_EyeMatrix || type == ovrLayerType_EyeFovDepth)
-		{
-			XrCompositionLayerProjection& projection = newLayer.Projection;
-			projection = XR_TYPE(COMPOSITION_LAYER_PROJECTION);
+	// Records the frame once the submission is done, even if it fails
+	SpikeScope spike(session->Spikes, SpikeDetector::CALL_END, frameIndex, layerCount);
+	if (CallRecorder::Get().IsEnabled())
+		CallRecorder::Get().RecordEndFrame(frameIndex, layerPtrList, layerCount);
 
-			ovrTextureSwapChain texture = nullptr;
-			viewData.emplace_back();
-			int i;
-			for (i = 0; i < ovrEye_Count; i++)
-			{
-				if (layer->EyeFov.ColorTexture[i])
-					texture = layer->EyeFov.ColorTexture[i];
-
-				if (!texture)
-					break;
-
-				XrCompositionLayerProjectionView& view = viewData.back().Views[i];
-				view = XR_TYPE(COMPOSITION_LAYER_PROJECTION_VIEW);
-
-				if (type == ovrLayerType_EyeMatrix)
-				{
-					// RenderPose is the first member that's differently aligned
-					view.pose = XR::Posef(layer->EyeMatrix.RenderPose[i]);
-					view.fov = XR::Matrix4f(layer->EyeMatrix.Matrix[i]);
-				}
-				else
-				{
-					view.pose = XR::Posef(layer->EyeFov.RenderPose[i]);
-
-					// The Climb specifies an invalid fov in the first frame, ignore the layer
-					XR::FovPort Fov(layer->EyeFov.Fov[i]);
-					if (Fov.GetMaxSideTan() > 0.0f)
-						view.fov = Fov;
-					else
-						break;
-				}
-
-				// Flip the field-of-view to flip the image, invert the check for OpenGL
-				if (texture->Images->type == XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR ? !upsideDown : upsideDown)
-					OVR::OVRMath_Swap(view.fov.angleUp, view.fov.angleDown);
-
-				if (type == ovrLayerType_EyeFovDepth && Runtime::Get().CompositionDepth)
-				{
-					depthData.emplace_back();
-					XrCompositionLayerDepthInfoKHR& depthInfo = depthData.back();
-					depthInfo = XR_TYPE(COMPOSITION_LAYER_DEPTH_INFO_KHR);
-
-					ovrTextureSwapChain depthTexture = layer->EyeFovDepth.DepthTexture[i];
-					depthInfo.subImage.swapchain = depthTexture->Swapchain;
-					depthInfo.subImage.imageRect = ClampRect(layer->EyeFovDepth.Viewport[i], depthTexture);
-					depthInfo.subImage.imageArrayIndex = 0;
-
-					const ovrTimewarpProjectionDesc& projDesc = layer->EyeFovDepth.ProjectionDesc;
-					depthInfo.minDepth = 0.0f;
-					depthInfo.maxDepth = 1.0f;
-					depthInfo.nearZ = projDesc.Projection23 / projDesc.Projection22;
-					depthInfo.farZ = projDesc.Projection23 / (1.0f + projDesc.Projection22);
-
-					if (viewScaleDesc)
-					{
-						depthInfo.nearZ *= viewScaleDesc->HmdSpaceToWorldScaleInMeters;
-						depthInfo.farZ *= viewScaleDesc->HmdSpaceToWorldScaleInMeters;
-					}
-
-					view.next = &depthData.back();
-				}
-
-				view.subImage.swapchain = texture->Swapchain;
-				view.subImage.imageRect = ClampRect(layer->EyeFov.Viewport[i], texture);
-				view.subImage.imageArrayIndex = 0;
-			}
+	XrIndexedFrameState* frame = session->CurrentFrame;
+	LayerTranslationInfo info = {
+		Runtime::Get().MinorVersion,
+		Runtime::Get().CompositionDepth,
+		Runtime::Get().CompositionCube,
+		Runtime::Get().CompositionCylinder,
+		session->ViewSpace,
+		session->TrackingSpace == XR_REFERENCE_SPACE_TYPE_STAGE ? session->StageSpace : session->LocalSpace
+	};
+	uint32_t numLayers = TranslateLayers(session->Layers, info, viewScaleDesc, layerPtrList, layerCount, &frame->sampleTime);
 
-			// Verify all views were initialized without errors, otherwise ignore the layer
-			if (i < ovrEye_Count)
-				continue;
+	// Estimate the performance scale from the GPU time of the frames that finished rendering
+	frame->endTime = ovr_GetTimeInSeconds();
+	if (session->FrameTimer)
+	{
+		session->FrameTimer->End();
 
-			projection.viewCount = ovrEye_Count;
-			projection.views = reinterpret_cast<XrCompositionLayerProjectionView*>(&viewData.back());
-		}
-		else if (type == ovrLayerType_Quad)
-		{
-			ovrTextureSwapChain texture = layer->Quad.ColorTexture;
-			if (!texture)
-				continue;
-
-			XrCompositionLayerQuad& quad = newLayer.Quad;
-			quad = XR_TYPE(COMPOSITION_LAYER_QUAD);
-			quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
-			quad.subImage.swapchain = texture->Swapchain;
-			quad.subImage.imageRect = ClampRect(layer->Quad.Viewport, texture);
-			quad.subImage.imageArrayIndex = 0;
-			quad.pose = XR::Posef(layer->Quad.QuadPoseCenter);
-			quad.size = XR::Vector2f(layer->Quad.QuadSize);
-		}
-		else if (type == ovrLayerType_Cylinder && Runtime::Get().CompositionCylinder)
-		{
-			ovrTextureSwapChain texture = layer->Cylinder.ColorTexture;
-			if (!texture)
-				continue;
-
-			XrCompositionLayerCylinderKHR& cylinder = newLayer.Cylinder;
-			cylinder = XR_TYPE(COMPOSITION_LAYER_CYLINDER_KHR);
-			cylinder.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
-			cylinder.subImage.swapchain = texture->Swapchain;
-			cylinder.subImage.imageRect = ClampRect(layer->Cylinder.Viewport, texture);
-			cylinder.subImage.imageArrayIndex = 0;
-			cylinder.pose = XR::Posef(layer->Cylinder.CylinderPoseCenter);
-			cylinder.radius = layer->Cylinder.CylinderRadius;
-			cylinder.centralAngle = layer->Cylinder.CylinderAngle;
-			cylinder.aspectRatio = layer->Cylinder.CylinderAspectRatio;
-		}
-		else if (type == ovrLayerType_Cube && Runtime::Get().CompositionCube)
+		float gpuTime;
+		float framePeriod = frame->predictedDisplayPeriod / 1.0e9f;
+		while (session->FrameTimer->GetTime(&gpuTime))
 		{
-			if (!layer->Cube.CubeMapTexture)
-				continue;
-
-			XrCompositionLayerCubeKHR& cube = newLayer.Cube;
-			cube = XR_TYPE(COMPOSITION_LAYER_CUBE_KHR);
-			cube.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
-			cube.swapchain = layer->Cube.CubeMapTexture->Swapchain;
-			cube.imageArrayIndex = 0;
-			cube.orientation = XR::Quatf(layer->Cube.Orientation);
+			session->PerfScale.AddFrame(gpuTime, framePeriod);
+			frame->gpuTime = gpuTime;
 		}
-		else
-		{
-			// Layer type not recognized or disabled, ignore the layer
-			assert(type == ovrLayerType_Disabled);
-			continue;
-		}
-
-		XrCompositionLayerBaseHeader& header = newLayer.Header;
-		header.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
-		if (headLocked)
-			header.space = session->ViewSpace;
-		else
-			header.space = (session->TrackingSpace == XR_REFERENCE_SPACE_TYPE_STAGE) ?
-				session->StageSpace : session->LocalSpace;
-
-		layers.push_back(&newLayer.Header);
 	}
 
 	XrFrameEndInfo endInfo = XR_TYPE(FRAME_END_INFO);
 	endInfo.displayTime = (*session->CurrentFrame).predictedDisplayTime;
 	endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
-	endInfo.layerCount = (uint32_t)layers.size();
-	endInfo.layers = layers.data();
+	endInfo.layerCount = numLayers;
+	endInfo.layers = session->Layers.Headers;
 	CHK_XR(xrEndFrame(session->Session, &endInfo));
 
+	// Release pooled swapchains that weren't reused in time, even if the app stops creating swapchains
+	session->ChainPool.Trim();
+
 	MicroProfileFlip();
 
 	return ovrSuccess;
@@ -1162,14 +1025,81 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats
 {
 	REV_TRACE(ovr_GetPerfStats);
 
-	return ovrError_Unsupported;
+	if (!session)
+		return ovrError_InvalidSession;
+
+	if (!outStats)
+		return ovrError_InvalidParameter;
+
+	ovrPerfStatsPerCompositorFrame FrameStats[ovrMaxProvidedFrameStats] = {};
+	float AdaptiveGpuPerformanceScale = session->PerfScale.GetScale();
+	uint32_t DroppedFrames = session->DroppedFrames;
+
+	// Walk the telemetry ring from the most recent frame, skipping the frame still in progress
+	int FrameStatsCount = 0;
+	long long LastFrameIndex = session->StatsIndex;
+	XrIndexedFrameState* frame = session->CurrentFrame;
+	for (int i = 0; i < ovrMaxProvidedFrameStats; i++)
+	{
+		if (frame->endTime > 0.0 && frame->frameIndex > session->StatsIndex)
+		{
+			ovrPerfStatsPerCompositorFrame& stats = FrameStats[FrameStatsCount++];
+			double period = frame->predictedDisplayPeriod / 1.0e9;
+			double beginTime = frame->beginTime > 0.0 ? frame->beginTime : frame->waitTime;
+			double renderTime = frame->commitTime > beginTime ? frame->commitTime : frame->endTime;
+
+			stats.HmdVsyncIndex = frame->predictedDisplayPeriod > 0 ? int(frame->predictedDisplayTime / frame->predictedDisplayPeriod) : 0;
+			stats.AppFrameIndex = (int)frame->frameIndex;
+			stats.AppDroppedFrameCount = (int)DroppedFrames;
+			double sampleTime = frame->sampleTime > 0.0 ? frame->sampleTime : frame->waitTime;
+			stats.AppMotionToPhotonLatency = float(frame->displayTime - sampleTime);
+			stats.AppQueueAheadTime = float(std::max(frame->displayTime - frame->waitTime - period, 0.0));
+			stats.AppCpuElapsedTime = float(renderTime - beginTime);
+			stats.AppGpuElapsedTime = frame->gpuTime;
+			stats.CompositorFrameIndex = stats.HmdVsyncIndex;
+			LastFrameIndex = std::max(LastFrameIndex, frame->frameIndex);
+		}
+
+		frame = frame == session->FrameStats ? &session->FrameStats[ovrMaxProvidedFrameStats - 1] : frame - 1;
+	}
+	ovrBool AnyFrameStatsDropped = LastFrameIndex - session->StatsIndex > FrameStatsCount;
+	session->StatsIndex = LastFrameIndex;
+
+	// We need to make sure we don't write outside of the bounds of the struct in older version of the runtime
+	if (Runtime::Get().MinorVersion < 11)
+	{
+		ovrPerfStats1* out = (ovrPerfStats1*)outStats;
+		for (int i = 0; i < FrameStatsCount; i++)
+			memcpy(out->FrameStats + i, FrameStats + i, sizeof(ovrPerfStatsPerCompositorFrame1));
+		out->AdaptiveGpuPerformanceScale = AdaptiveGpuPerformanceScale;
+		out->AnyFrameStatsDropped = AnyFrameStatsDropped;
+		out->FrameStatsCount = FrameStatsCount;
+	}
+	else
+	{
+		ovrPerfStats* out = outStats;
+		memcpy(out->FrameStats, FrameStats, sizeof(FrameStats));
+		out->AdaptiveGpuPerformanceScale = AdaptiveGpuPerformanceScale;
+		out->AnyFrameStatsDropped = AnyFrameStatsDropped;
+		out->FrameStatsCount = FrameStatsCount;
+		out->AswIsAvailable = ovrFalse;
+
+		if (Runtime::Get().MinorVersion >= 14)
+			out->VisibleProcessId = session->SessionStatus.load().IsVisible ? GetCurrentProcessId() : 0;
+	}
+	return ovrSuccess;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_ResetPerfStats(ovrSession session)
 {
 	REV_TRACE(ovr_ResetPerfStats);
 
-	return ovrError_Unsupported;
+	if (!session)
+		return ovrError_InvalidSession;
+
+	session->DroppedFrames = 0;
+	session->StatsIndex = (*session->CurrentFrame).frameIndex;
+	return ovrSuccess;
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long long frameIndex)
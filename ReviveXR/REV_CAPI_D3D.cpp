@@ -3,6 +3,7 @@
 #include "Session.h"
 #include "Runtime.h"
 #include "SwapChain.h"
+#include "GpuTimer.h"
 #include "XR_Math.h"
 
 #include <detours/detours.h>
@@ -157,6 +158,56 @@ DXGI_FORMAT TextureFormatToDXGIFormat(ovrTextureFormat format)
 	}
 }
 
+DXGI_FORMAT FallbackDXGIFormat(DXGI_FORMAT format)
+{
+	// Only fall back to the typeless format of the same family, so the channel order,
+	// bit depth and encoding of the views the application creates stay the same
+	switch (format)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   return DXGI_FORMAT_R8G8B8A8_TYPELESS;
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   return DXGI_FORMAT_B8G8R8A8_TYPELESS;
+		case DXGI_FORMAT_R10G10B10A2_UNORM:     return DXGI_FORMAT_R10G10B10A2_TYPELESS;
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:    return DXGI_FORMAT_R16G16B16A16_TYPELESS;
+		case DXGI_FORMAT_D16_UNORM:             return DXGI_FORMAT_R16_TYPELESS;
+		case DXGI_FORMAT_D24_UNORM_S8_UINT:     return DXGI_FORMAT_R24G8_TYPELESS;
+		case DXGI_FORMAT_D32_FLOAT:             return DXGI_FORMAT_R32_TYPELESS;
+		case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:  return DXGI_FORMAT_R32G8X24_TYPELESS;
+		default:                                return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+DXGI_FORMAT ResolveDXGIFormat(ovrSession session, DXGI_FORMAT format)
+{
+	// Some runtimes advertise formats that don't work, so apply the known fallbacks first
+	if (format == DXGI_FORMAT_R11G11B10_FLOAT)
+	{
+		if (Runtime::Get().UseHack(Runtime::HACK_NO_11BIT_FORMAT))
+			format = DXGI_FORMAT_R10G10B10A2_UNORM;
+		else if (Runtime::Get().UseHack(Runtime::HACK_NO_10BIT_FORMAT))
+			format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	}
+	else if ((format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM) &&
+		Runtime::Get().UseHack(Runtime::HACK_NO_8BIT_LINEAR))
+	{
+		if (format == DXGI_FORMAT_R8G8B8A8_UNORM)
+			format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+		else
+			format = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+	}
+
+	// Try the format itself and then its typeless equivalent
+	for (DXGI_FORMAT fallback = format; fallback != DXGI_FORMAT_UNKNOWN; fallback = FallbackDXGIFormat(fallback))
+	{
+		if (session->SupportsFormat(fallback))
+			return fallback;
+	}
+
+	// There is no compatible format that the runtime supports
+	return DXGI_FORMAT_UNKNOWN;
+}
+
 D3D_SRV_DIMENSION DescToViewDimension(const ovrTextureSwapChainDesc* desc)
 {
 	if (desc->ArraySize > 1)
@@ -225,6 +276,9 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session,
 			XrGraphicsBindingD3D11KHR graphicsBinding = XR_TYPE(GRAPHICS_BINDING_D3D11_KHR);
 			graphicsBinding.device = pDevice;
 			session->BeginSession(&graphicsBinding);
+
+			// Measure the GPU time of the app for the adaptive performance scale
+			session->FrameTimer.reset(new GpuTimer(pDevice));
 		}
 		else if (pQueue)
 		{
@@ -257,28 +311,15 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session,
 		}
 	}
 
-	DXGI_FORMAT format = TextureFormatToDXGIFormat(desc->Format);
-	if (format == DXGI_FORMAT_R11G11B10_FLOAT)
-	{
-		if (Runtime::Get().UseHack(Runtime::HACK_NO_11BIT_FORMAT))
-			format = DXGI_FORMAT_R10G10B10A2_UNORM;
-		else if (Runtime::Get().UseHack(Runtime::HACK_NO_10BIT_FORMAT))
-			format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-	}
-	else if ((format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM) &&
-		Runtime::Get().UseHack(Runtime::HACK_NO_8BIT_LINEAR))
-	{
-		if (format == DXGI_FORMAT_R8G8B8A8_UNORM)
-			format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-		else
-			format = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
-	}
+	DXGI_FORMAT format = ResolveDXGIFormat(session, TextureFormatToDXGIFormat(desc->Format));
+	if (format == DXGI_FORMAT_UNKNOWN)
+		return ovrError_InvalidParameter;
 
 	if (pDevice)
 	{
 		ovrTextureSwapChain chain;
 		g_SwapChainDesc = desc;
-		CHK_OVR(CreateSwapChain(session->Session, desc, format, &chain));
+		CHK_OVR(CreateSwapChain(session, desc, format, &chain));
 		g_SwapChainDesc = nullptr;
 		CHK_OVR(EnumerateImages<XrSwapchainImageD3D11KHR>(XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR, chain));
 
@@ -301,7 +342,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainDX(ovrSession session,
 	}
 	else if (pQueue)
 	{
-		CHK_OVR(CreateSwapChain(session->Session, desc, format, out_TextureSwapChain));
+		CHK_OVR(CreateSwapChain(session, desc, format, out_TextureSwapChain));
 		return EnumerateImages<XrSwapchainImageD3D12KHR>(XR_TYPE_SWAPCHAIN_IMAGE_D3D12_KHR, *out_TextureSwapChain);
 	}
 	else
@@ -68,7 +68,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateTextureSwapChainGL(ovrSession session,
 		session->BeginSession(&graphicsBinding);
 	}
 
-	CHK_OVR(CreateSwapChain(session->Session, desc, TextureFormatToGLFormat(desc->Format), out_TextureSwapChain));
+	CHK_OVR(CreateSwapChain(session, desc, TextureFormatToGLFormat(desc->Format), out_TextureSwapChain));
 	return EnumerateImages<XrSwapchainImageOpenGLKHR>(XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR, *out_TextureSwapChain);
 }
 
@@ -216,7 +216,7 @@ ovr_CreateTextureSwapChainVk(
 		session->BeginSession(&g_Binding);
 	}
 
-	CHK_OVR(CreateSwapChain(session->Session, desc, TextureFormatToVkFormat(desc->Format), out_TextureSwapChain));
+	CHK_OVR(CreateSwapChain(session, desc, TextureFormatToVkFormat(desc->Format), out_TextureSwapChain));
 	return EnumerateImages<XrSwapchainImageVulkanKHR>(XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR, *out_TextureSwapChain);
 }
 
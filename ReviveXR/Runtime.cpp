@@ -1,5 +1,6 @@
 #include "Runtime.h"
 #include "Common.h"
+#include "Compatibility.h"
 #include "version.h"
 
 #include <Windows.h>
@@ -24,7 +25,8 @@ const char* Runtime::s_optional_extensions[] = {
 	XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME,
 	XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME,
 	XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME,
-	XR_EPIC_VIEW_CONFIGURATION_FOV_EXTENSION_NAME
+	XR_EPIC_VIEW_CONFIGURATION_FOV_EXTENSION_NAME,
+	XR_KHR_LOCATE_SPACES_EXTENSION_NAME
 };
 
 Runtime::HackInfo Runtime::s_known_hacks[] = {
@@ -38,6 +40,12 @@ Runtime::HackInfo Runtime::s_known_hacks[] = {
 	{ "loneecho.exe", nullptr, HACK_FORCE_FOV_FALLBACK, 0, 0, true },
 };
 
+const char* Runtime::s_hack_names[] = {
+#define REV_HACK_NAME(name) #name,
+	REV_RUNTIME_HACKS(REV_HACK_NAME)
+#undef REV_HACK_NAME
+};
+
 Runtime& Runtime::Get()
 {
 	static Runtime instance;
@@ -77,6 +85,7 @@ ovrResult Runtime::CreateInstance(XrInstance* out_Instance, const ovrInitParams*
 	CompositionDepth = Supports(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
 	CompositionCube = Supports(XR_KHR_COMPOSITION_LAYER_CUBE_EXTENSION_NAME);
 	CompositionCylinder = Supports(XR_KHR_COMPOSITION_LAYER_CYLINDER_EXTENSION_NAME);
+	LocateSpaces = Supports(XR_KHR_LOCATE_SPACES_EXTENSION_NAME);
 
 	XrInstanceCreateInfo createInfo = XR_TYPE(INSTANCE_CREATE_INFO);
 	createInfo.applicationInfo = { "Revive", REV_VERSION_INT, "Revive", REV_VERSION_INT, XR_CURRENT_API_VERSION };
@@ -91,27 +100,40 @@ ovrResult Runtime::CreateInstance(XrInstance* out_Instance, const ovrInitParams*
 	XrInstanceProperties props = XR_TYPE(INSTANCE_PROPERTIES);
 	CHK_XR(xrGetInstanceProperties(*out_Instance, &props));
 
+	static_assert(HACK_COUNT <= 64, "The hacks need to fit in the hack mask");
+	static_assert(sizeof(s_hack_names) / sizeof(const char*) == HACK_COUNT, "Every hack needs a name");
+
+	// Compile the hacks into a mask once, so checking them on the hot paths is cheap
+	m_hacks = 0;
 	for (auto& hack : s_known_hacks)
+		AddHack(hack, filename, props);
+
+	// Additional hacks can be added without rebuilding through the compatibility file
+	Profile = CompatibilityProfile();
+	std::vector<std::string> errors;
+	const JsonValue* compat = GetCompatibilityFile(&errors);
+	if (compat)
 	{
-		if ((!hack.m_filename || _stricmp(filename, hack.m_filename) == 0) &&
-			(!hack.m_runtime || strcmp(props.runtimeName, hack.m_runtime) == 0) &&
-			(!hack.m_versionend || hack.m_versionstart <= props.runtimeVersion &&
-				props.runtimeVersion < hack.m_versionend))
-		{
-			if (hack.m_usehack)
-				m_hacks.emplace(hack.m_hack, hack);
-		}
-		else if (!hack.m_usehack)
-		{
-			m_hacks.emplace(hack.m_hack, hack);
-		}
+		uint64_t version = props.runtimeVersion;
+		m_hacks = ApplyCompatibility(*compat, m_hacks, filename, props.runtimeName, &version, s_hack_names, HACK_COUNT, &Profile, &errors);
 	}
+	LogCompatibilityErrors(errors);
 	return ovrSuccess;
 }
 
-bool Runtime::UseHack(Hack hack)
+bool Runtime::MatchHack(const HackInfo& hack, const char* filename, const XrInstanceProperties& props)
+{
+	return (!hack.m_filename || _stricmp(filename, hack.m_filename) == 0) &&
+		(!hack.m_runtime || strcmp(props.runtimeName, hack.m_runtime) == 0) &&
+		(!hack.m_versionend || hack.m_versionstart <= props.runtimeVersion &&
+			props.runtimeVersion < hack.m_versionend);
+}
+
+void Runtime::AddHack(const HackInfo& hack, const char* filename, const XrInstanceProperties& props)
 {
-	return m_hacks.find(hack) != m_hacks.end();
+	// Table entries that don't use the hack enable it for everything they don't match
+	if (MatchHack(hack, filename, props) == hack.m_usehack)
+		m_hacks |= 1ull << hack.m_hack;
 }
 
 bool Runtime::Supports(const char* extensionName)
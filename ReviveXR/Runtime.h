@@ -1,12 +1,37 @@
 #pragma once
 
 #include "Common.h"
+#include "Compatibility.h"
 #include "OVR_CAPI.h"
 
 #include <openxr/openxr.h>
-#include <map>
+#include <stdint.h>
 #include <vector>
 
+// The hacks are listed once, so the enum and the names used by the compatibility file stay in sync.
+#define REV_RUNTIME_HACKS(HACK) \
+	/* Hack: SteamVR runtime doesn't support the Oculus Touch interaction profile. \
+	 * Use the Valve Index interaction profile instead. */ \
+	HACK(HACK_VALVE_INDEX_PROFILE) \
+	/* Hack: WMR runtime doesn't support the Oculus Touch interaction profile. \
+	 * Use the WMR motion controller interaction profile instead. */ \
+	HACK(HACK_WMR_PROFILE) \
+	/* Hack: Some runtimes don't support the R11G11B10 swapchain format. \
+	 * Fall back to the R10G10B10A2 format instead. */ \
+	HACK(HACK_NO_11BIT_FORMAT) \
+	/* Hack: Some runtimes don't support the floating point swapchain format. \
+	 * Fall back to the 8-bit sRGB format instead. */ \
+	HACK(HACK_NO_10BIT_FORMAT) \
+	/* Hack: Some runtimes don't support 8-bit linear swapchain formats. \
+	 * Fall back to the sRGB formats instead. */ \
+	HACK(HACK_NO_8BIT_LINEAR) \
+	/* Hack: Some games only call GetRenderDesc once before the session is fully initialized. \
+	 * Therefore we need to force the fallback field-of-view query so we get full ViewPoses. */ \
+	HACK(HACK_FORCE_FOV_FALLBACK) \
+	/* Hack: SteamVR runtime has some inflexibilities in its swapchain creation. \
+	 * To work around that we hook the D3D11 texture creation function and force our own parameters. */ \
+	HACK(HACK_HOOK_CREATE_TEXTURE)
+
 class Runtime
 {
 public:
@@ -14,30 +39,15 @@ public:
 
 	enum Hack
 	{
-		// Hack: SteamVR runtime doesn't support the Oculus Touch interaction profile.
-		// Use the Valve Index interaction profile instead.
-		HACK_VALVE_INDEX_PROFILE,
-		// Hack: WMR runtime doesn't support the Oculus Touch interaction profile.
-		// Use the WMR motion controller interaction profile instead.
-		HACK_WMR_PROFILE,
-		// Hack: Some runtimes don't support the R11G11B10 swapchain format.
-		// Fall back to the R10G10B10A2 format instead.
-		HACK_NO_11BIT_FORMAT,
-		// Hack: Some runtimes don't support the floating point swapchain format.
-		// Fall back to the 8-bit sRGB format instead.
-		HACK_NO_10BIT_FORMAT,
-		// Hack: Some runtimes don't support 8-bit linear swapchain formats.
-		// Fall back to the sRGB formats instead.
-		HACK_NO_8BIT_LINEAR,
-		// Hack: Some games only call GetRenderDesc once before the session is fully initialized.
-		// Therefore we need to force the fallback field-of-view query so we get full ViewPoses.
-		HACK_FORCE_FOV_FALLBACK,
-		// Hack: SteamVR runtime has some inflexibilities in its swapchain creation.
-		// To work around that we hook the D3D11 texture creation function and force our own parameters.
-		HACK_HOOK_CREATE_TEXTURE,
+#define REV_HACK_ENUM(name) name,
+		REV_RUNTIME_HACKS(REV_HACK_ENUM)
+#undef REV_HACK_ENUM
+
+		// Number of hacks, they have to fit in the hack mask.
+		HACK_COUNT
 	};
 
-	bool UseHack(Hack hack);
+	bool UseHack(Hack hack) const { return (m_hacks & (1ull << hack)) != 0; }
 	ovrResult CreateInstance(XrInstance* out_Instance, const ovrInitParams* params);
 	bool Supports(const char* extensionName);
 
@@ -45,8 +55,10 @@ public:
 	bool CompositionDepth;
 	bool CompositionCube;
 	bool CompositionCylinder;
+	bool LocateSpaces;
 
 	uint32_t MinorVersion;
+	CompatibilityProfile Profile;
 
 private:
 	struct HackInfo
@@ -62,7 +74,11 @@ private:
 	static const char* s_required_extensions[];
 	static const char* s_optional_extensions[];
 	static HackInfo s_known_hacks[];
+	static const char* s_hack_names[];
 
-	std::map<Hack, HackInfo> m_hacks;
+	uint64_t m_hacks;
 	std::vector<const char*> m_extensions;
+
+	static bool MatchHack(const HackInfo& hack, const char* filename, const XrInstanceProperties& props);
+	void AddHack(const HackInfo& hack, const char* filename, const XrInstanceProperties& props);
 };
@@ -4,6 +4,7 @@
 #include "Session.h"
 #include "Runtime.h"
 #include "InputManager.h"
+#include "GpuTimer.h"
 
 #define XR_USE_GRAPHICS_API_D3D11
 #include <d3d11.h>
@@ -12,6 +13,7 @@
 #include <openxr/openxr_platform.h>
 #include <wrl/client.h>
 #include <thread>
+#include <algorithm>
 
 ovrResult ovrHmdStruct::InitSession(XrInstance instance)
 {
@@ -21,6 +23,8 @@ ovrResult ovrHmdStruct::InitSession(XrInstance instance)
 	for (int i = 0; i < ovrMaxProvidedFrameStats; i++)
 		FrameStats[i].type = XR_TYPE_FRAME_STATE;
 	CurrentFrame = FrameStats;
+	StatsIndex = 0;
+	DroppedFrames = 0;
 	Instance = instance;
 	TrackingSpace = XR_REFERENCE_SPACE_TYPE_LOCAL;
 	SystemProperties = XR_TYPE(SYSTEM_PROPERTIES);
@@ -121,7 +125,20 @@ ovrResult ovrHmdStruct::BeginSession(void* graphicsBinding, bool waitFrame)
 	createInfo.next = graphicsBinding;
 	createInfo.systemId = System;
 	CHK_XR(xrCreateSession(Instance, &createInfo, &Session));
-	memset(&SessionStatus, 0, sizeof(SessionStatus));
+	SessionStatus = SessionStatusBits();
+
+	// Enumerate the supported swapchain formats, they won't change for the lifetime of the session
+	uint32_t formatCount = 0;
+	CHK_XR(xrEnumerateSwapchainFormats(Session, 0, &formatCount, nullptr));
+	SwapchainFormats.resize(formatCount);
+	CHK_XR(xrEnumerateSwapchainFormats(Session, (uint32_t)SwapchainFormats.size(), &formatCount, SwapchainFormats.data()));
+	assert(SwapchainFormats.size() == formatCount);
+	std::sort(SwapchainFormats.begin(), SwapchainFormats.end());
+
+	// Start waiting on committed swapchain images in the background
+	BeginFrameBlockTime.Reset();
+	SerialWaitTime.Reset();
+	ChainWaiter.Start();
 
 	// Attach it to the InputManager
 	if (Input)
@@ -138,6 +155,11 @@ ovrResult ovrHmdStruct::BeginSession(void* graphicsBinding, bool waitFrame)
 	CHK_XR(xrCreateReferenceSpace(Session, &spaceInfo, &StageSpace));
 	CalibratedOrigin = OVR::Posef::Identity();
 
+	// Handle the session events in the background, the session handle is valid now so no events are missed
+	EventPumpRunning = true;
+	EventPumpEvent = CreateEvent(nullptr, false, false, nullptr);
+	EventPumpThread = std::thread(EventPumpThreadFunc, this);
+
 	XrSessionBeginInfo beginInfo = XR_TYPE(SESSION_BEGIN_INFO);
 	beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
 	CHK_XR(xrBeginSession(Session, &beginInfo));
@@ -157,9 +179,28 @@ ovrResult ovrHmdStruct::EndSession()
 
 	if (Input)
 		Input->AttachSession(XR_NULL_HANDLE);
+	FrameTimer.reset();
+
+	EventPumpRunning = false;
+	SetEvent(EventPumpEvent);
+	if (EventPumpThread.joinable())
+		EventPumpThread.join();
+	CloseHandle(EventPumpEvent);
+	EventPumpEvent = nullptr;
+
+	ChainWaiter.Stop();
+
+	if (BeginFrameBlockTime.GetTotal() > 0)
+	{
+		OutputDebugStringA(BeginFrameBlockTime.Format("Revive: BeginFrame blocked").c_str());
+		OutputDebugStringA(SerialWaitTime.Format("Revive: Serial image waits").c_str());
+	}
+
+	ChainPool.Clear();
 
 	CHK_XR(xrDestroySession(Session));
 	Session = XR_NULL_HANDLE;
+	SwapchainFormats.clear();
 	ViewSpace = XR_NULL_HANDLE;
 	LocalSpace = XR_NULL_HANDLE;
 	StageSpace = XR_NULL_HANDLE;
@@ -189,3 +230,107 @@ ovrResult ovrHmdStruct::LocateViews(XrView out_Views[ovrEye_Count], XrViewStateF
 		*out_Flags = viewState.viewStateFlags;
 	return ovrSuccess;
 }
+
+bool ovrHmdStruct::SupportsFormat(int64_t format) const
+{
+	return std::binary_search(SwapchainFormats.begin(), SwapchainFormats.end(), format);
+}
+
+ovrPosef ovrHmdStruct::GetCalibratedOrigin()
+{
+	std::lock_guard<std::mutex> lk(OriginMutex);
+	return CalibratedOrigin;
+}
+
+bool ovrHmdStruct::PollEvents()
+{
+	bool received = false;
+	XrEventDataBuffer event = XR_TYPE(EVENT_DATA_BUFFER);
+	while (xrPollEvent(Instance, &event) == XR_SUCCESS)
+	{
+		received = true;
+		switch (event.type)
+		{
+		case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED:
+		{
+			const XrEventDataSessionStateChanged& stateChanged =
+				reinterpret_cast<XrEventDataSessionStateChanged&>(event);
+			if (stateChanged.session == Session)
+			{
+				UpdateSessionStatus([&stateChanged](SessionStatusBits& status)
+				{
+					switch (stateChanged.state)
+					{
+					case XR_SESSION_STATE_IDLE:
+						status.HmdPresent = true;
+						break;
+					case XR_SESSION_STATE_READY:
+						status.IsVisible = true;
+						status.HmdMounted = true;
+						break;
+					case XR_SESSION_STATE_SYNCHRONIZED:
+						status.HmdMounted = false;
+						break;
+					case XR_SESSION_STATE_VISIBLE:
+						status.HmdMounted = true;
+						status.HasInputFocus = false;
+						break;
+					case XR_SESSION_STATE_FOCUSED:
+						status.HasInputFocus = true;
+						break;
+					case XR_SESSION_STATE_STOPPING:
+						status.IsVisible = false;
+						break;
+					case XR_SESSION_STATE_LOSS_PENDING:
+						status.DisplayLost = true;
+						break;
+					case XR_SESSION_STATE_EXITING:
+						status.ShouldQuit = true;
+						break;
+					}
+				});
+			}
+			break;
+		}
+		case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
+		{
+			UpdateSessionStatus([](SessionStatusBits& status) { status.ShouldQuit = true; });
+			break;
+		}
+		case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING:
+		{
+			const XrEventDataReferenceSpaceChangePending& spaceChange =
+				reinterpret_cast<XrEventDataReferenceSpaceChangePending&>(event);
+			if (spaceChange.referenceSpaceType == XR_REFERENCE_SPACE_TYPE_LOCAL)
+			{
+				if (spaceChange.poseValid)
+				{
+					std::lock_guard<std::mutex> lk(OriginMutex);
+					CalibratedOrigin = XR::Posef(CalibratedOrigin) * XR::Posef(spaceChange.poseInPreviousSpace);
+				}
+				UpdateSessionStatus([](SessionStatusBits& status) { status.ShouldRecenter = true; });
+			}
+			break;
+		}
+		}
+		event = XR_TYPE(EVENT_DATA_BUFFER);
+	}
+	return received;
+}
+
+void ovrHmdStruct::EventPumpThreadFunc(ovrHmdStruct* session)
+{
+	MicroProfileOnThreadCreate("Event Pump");
+
+	DWORD interval = REV_EVENT_POLL_MIN_INTERVAL;
+	while (session->EventPumpRunning)
+	{
+		// Poll again soon while events are arriving, they tend to come in bursts
+		if (session->PollEvents())
+			interval = REV_EVENT_POLL_MIN_INTERVAL;
+		else
+			interval = std::min(interval * 2, (DWORD)REV_EVENT_POLL_MAX_INTERVAL);
+
+		WaitForSingleObject(session->EventPumpEvent, interval);
+	}
+}
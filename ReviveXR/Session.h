@@ -1,15 +1,29 @@
 #pragma once
 
 #include <OVR_CAPI.h>
+#include "CompositionLayers.h"
+#include "SwapChain.h"
+#include "SwapChainWaiter.h"
+#include "PerformanceScale.h"
+#include "SpikeDetector.h"
+#include "TimingHistogram.h"
+
 #include <openxr/openxr.h>
 #include <memory>
 #include <map>
+#include <vector>
 #include <atomic>
 #include <mutex>
-#include <list>
+#include <condition_variable>
+#include <thread>
+
+// Event pump polling interval in milliseconds, it backs off to the maximum while no events arrive
+#define REV_EVENT_POLL_MIN_INTERVAL 1
+#define REV_EVENT_POLL_MAX_INTERVAL 50
 
 class Runtime;
 class InputManager;
+class GpuTimer;
 
 struct SessionStatusBits {
 	bool IsVisible : 1;
@@ -25,6 +39,15 @@ struct SessionStatusBits {
 typedef struct XrIndexedFrameState : public XrFrameState
 {
 	long long frameIndex;
+
+	// Frame telemetry
+	double displayTime;	// Predicted display time in seconds
+	double waitTime;	// When xrWaitFrame returned
+	double beginTime;	// When xrBeginFrame returned
+	double commitTime;	// When the last swapchain was committed
+	double endTime;		// When the frame was submitted
+	double sampleTime;	// Sensor sample time of the first eye layer, zero if the app didn't set it
+	float gpuTime;		// Latest GPU time of the app, it lags a few frames behind
 } XrIndexedFrameState;
 
 struct ovrHmdStruct
@@ -42,11 +65,25 @@ struct ovrHmdStruct
 	// Frame state
 	XrIndexedFrameState FrameStats[ovrMaxProvidedFrameStats];
 	std::atomic<XrIndexedFrameState*> CurrentFrame;
+	PerformanceScale PerfScale;
+	std::unique_ptr<GpuTimer> FrameTimer; // Only available for D3D11
+	long long StatsIndex;
+	std::atomic_uint32_t DroppedFrames;
+	SpikeDetector Spikes;
 	ovrGraphicsLuid Adapter;
 
 	// Swapchain management
-	std::mutex ChainMutex;
-	std::list<XrSwapchain> AcquiredChains;
+	std::vector<int64_t> SwapchainFormats; // Sorted, enumerated once per session
+	SwapChainPool ChainPool;
+	SwapChainWaiter ChainWaiter;
+
+	// How long ovr_BeginFrame blocks on the wait thread, compared to how long it would block if it
+	// waited on the images serially: the total wait time of the images since the previous frame
+	TimingHistogram BeginFrameBlockTime;
+	TimingHistogram SerialWaitTime;
+
+	// Layer translation storage
+	LayerArena Layers;
 
 	// OpenXR properties
 	XrSystemProperties SystemProperties;
@@ -56,10 +93,16 @@ struct ovrHmdStruct
 	XrView ViewPoses[ovrEye_Count];
 	ovrVector2f PixelsPerTan[ovrEye_Count];
 
-	// Session status
-	SessionStatusBits SessionStatus;
+	// Session status, the origin is updated before the status so ShouldRecenter is never seen early
+	std::atomic<SessionStatusBits> SessionStatus;
+	std::mutex OriginMutex;
 	ovrPosef CalibratedOrigin;
 
+	// Event pump thread, the event is signalled every frame so events are handled without delay
+	std::thread EventPumpThread;
+	std::atomic_bool EventPumpRunning;
+	void* EventPumpEvent;
+
 	// Input
 	std::unique_ptr<InputManager> Input;
 
@@ -67,4 +110,21 @@ struct ovrHmdStruct
 	ovrResult BeginSession(void* graphicsBinding, bool waitFrame = true);
 	ovrResult EndSession();
 	ovrResult LocateViews(XrView out_Views[ovrEye_Count], XrViewStateFlags* out_Flags = nullptr) const;
+	bool SupportsFormat(int64_t format) const;
+
+	ovrPosef GetCalibratedOrigin();
+	bool PollEvents();
+	static void EventPumpThreadFunc(ovrHmdStruct* session);
+
+	// Both the app and the event pump modify the status, so retry until the update applies atomically
+	template<typename F> void UpdateSessionStatus(F update)
+	{
+		SessionStatusBits status = SessionStatus;
+		SessionStatusBits desired;
+		do
+		{
+			desired = status;
+			update(desired);
+		} while (!SessionStatus.compare_exchange_weak(status, desired));
+	}
 };
@@ -1,17 +1,64 @@
 #pragma once
 
+#include "Common.h"
+#include "CompositionLayers.h"
 #include "OVR_CAPI.h"
+#include "SwapChainQueue.h"
 #include <openxr/openxr.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #define REV_DEFAULT_SWAPCHAIN_DEPTH 3
+#define REV_SWAPCHAIN_POOL_TIMEOUT 5.0
+#define REV_SWAPCHAIN_POOL_BUDGET (256ull * 1024 * 1024)
 
 struct ovrTextureSwapChainData
 {
 	ovrTextureSwapChainDesc Desc;
+	XrSwapchainCreateInfo CreateInfo;
 	XrSwapchain Swapchain;
 	XrSwapchainImageBaseHeader* Images;
 	uint32_t Length;
 	uint32_t CurrentIndex;
+	std::atomic_bool ImageReady;
+
+	// Last quad or cylinder layer translated from this swapchain
+	LayerCache Cache;
+};
+
+// Destroyed swapchains are parked here for a while, so an equivalent swapchain can be handed back
+// to titles that recreate their swapchains on every resolution change
+class SwapChainPool
+{
+public:
+	SwapChainPool();
+	~SwapChainPool();
+
+	ovrTextureSwapChain Acquire(const XrSwapchainCreateInfo& createInfo, ovrTextureFormat format);
+	bool Release(ovrTextureSwapChain chain);
+	void Clear();
+
+	// Evicts swapchains that have been parked for too long, called once per frame
+	void Trim();
+
+	// Statistics
+	std::atomic_uint64_t Hits;
+	std::atomic_uint64_t Misses;
+	std::atomic_uint64_t ResidentBytes;
+
+private:
+	struct Entry
+	{
+		ovrTextureSwapChain Chain;
+		uint64_t Bytes;
+		double ReleaseTime;
+	};
+
+	void Trim(double time, uint64_t budget);
+
+	std::mutex m_Mutex;
+	std::vector<Entry> m_Entries;
 };
 
 struct ovrMirrorTextureData
@@ -23,6 +70,10 @@ struct ovrMirrorTextureData
 template<typename T>
 ovrResult EnumerateImages(XrStructureType type, ovrTextureSwapChain swapChain)
 {
+	// The images are already enumerated if the swapchain came from the pool
+	if (swapChain->Images)
+		return ovrSuccess;
+
 	CHK_XR(xrEnumerateSwapchainImages(swapChain->Swapchain, 0, &swapChain->Length, nullptr));
 	T* images = new T[swapChain->Length]();
 	for (uint32_t i = 0; i < swapChain->Length; i++)
@@ -35,4 +86,5 @@ ovrResult EnumerateImages(XrStructureType type, ovrTextureSwapChain swapChain)
 	return ovrSuccess;
 }
 
-ovrResult CreateSwapChain(XrSession session, const ovrTextureSwapChainDesc* desc, int64_t format, ovrTextureSwapChain* out);
+ovrResult CreateSwapChain(ovrSession session, const ovrTextureSwapChainDesc* desc, int64_t format, ovrTextureSwapChain* out);
+void DestroySwapChain(ovrTextureSwapChain chain);
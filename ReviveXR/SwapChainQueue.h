@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#define REV_MAX_ACQUIRED_CHAINS 64
+
+struct ovrTextureSwapChainData;
+
+// Lock-less bounded queue of pointers, multiple producers/single consumer
+template<typename T>
+class BoundedQueue
+{
+public:
+	BoundedQueue()
+		: m_EnqueueIndex(0)
+		, m_DequeueIndex(0)
+	{
+		for (size_t i = 0; i < REV_MAX_ACQUIRED_CHAINS; i++)
+			m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// Returns false if the queue is full
+	bool Push(T* chain)
+	{
+		size_t pos = m_EnqueueIndex.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &m_Cells[pos % REV_MAX_ACQUIRED_CHAINS];
+			size_t seq = cell->Sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0)
+			{
+				if (m_EnqueueIndex.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_EnqueueIndex.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->Chain = chain;
+		cell->Sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Must only be called from the consumer thread, returns false if the queue is empty
+	bool Pop(T** out_Chain)
+	{
+		size_t pos = m_DequeueIndex.load(std::memory_order_relaxed);
+		Cell& cell = m_Cells[pos % REV_MAX_ACQUIRED_CHAINS];
+		size_t seq = cell.Sequence.load(std::memory_order_acquire);
+		if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+			return false;
+
+		*out_Chain = cell.Chain;
+		cell.Sequence.store(pos + REV_MAX_ACQUIRED_CHAINS, std::memory_order_release);
+		m_DequeueIndex.store(pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic_size_t Sequence;
+		T* Chain;
+	};
+
+	Cell m_Cells[REV_MAX_ACQUIRED_CHAINS];
+	std::atomic_size_t m_EnqueueIndex;
+	std::atomic_size_t m_DequeueIndex;
+};
+
+// Queue of acquired swapchains
+typedef BoundedQueue<ovrTextureSwapChainData> SwapChainQueue;
@@ -0,0 +1,167 @@
+#include "SwapChainWaiter.h"
+#include "Common.h"
+#include "SwapChain.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t), "The wake word is waited on as a plain word");
+
+static void WaitOnWord(std::atomic_uint32_t& word, uint32_t value)
+{
+#ifdef _WIN32
+	WaitOnAddress(&word, &value, sizeof(value), INFINITE);
+#else
+	// The futex only blocks if the word still holds the value
+	syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#endif
+}
+
+static void WakeWord(std::atomic_uint32_t& word)
+{
+#ifdef _WIN32
+	WakeByAddressSingle(&word);
+#else
+	syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+SwapChainWaiter::SwapChainWaiter()
+	: m_Pending(0)
+	, m_Result(XR_SUCCESS)
+	, m_WaitTime(0)
+	, m_Running(false)
+	, m_Wake(0)
+{
+}
+
+SwapChainWaiter::~SwapChainWaiter()
+{
+	Stop();
+}
+
+void SwapChainWaiter::Start()
+{
+	if (m_Running)
+		return;
+
+	// Images submitted before the thread started stay pending, they're waited on as soon as it runs
+	m_Result = XR_SUCCESS;
+	m_WaitTime = 0;
+	m_Running = true;
+	m_Thread = std::thread(ThreadFunc, this);
+}
+
+void SwapChainWaiter::Stop()
+{
+	m_Running = false;
+	m_Wake++;
+	WakeWord(m_Wake);
+	if (m_Thread.joinable())
+		m_Thread.join();
+
+	// The images will never be waited on, so don't let any commit block on them
+	ovrTextureSwapChainData* chain;
+	while (m_Queue.Pop(&chain))
+	{
+		chain->ImageReady = true;
+		m_Pending--;
+	}
+	SignalReady();
+}
+
+void SwapChainWaiter::WaitReady(ovrTextureSwapChainData* chain)
+{
+	if (!chain->ImageReady)
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+		m_Ready.wait(lk, [chain] { return chain->ImageReady.load(); });
+	}
+}
+
+void SwapChainWaiter::Submit(ovrTextureSwapChainData* chain)
+{
+	chain->ImageReady = false;
+	m_Pending++;
+	if (m_Queue.Push(chain))
+	{
+		m_Wake++;
+		WakeWord(m_Wake);
+	}
+	else
+	{
+		// The queue is full, wait on the image ourselves
+		WaitChain(chain);
+		SignalReady();
+	}
+}
+
+XrResult SwapChainWaiter::WaitAll()
+{
+	if (m_Pending > 0)
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+		m_Ready.wait(lk, [this] { return m_Pending == 0; });
+	}
+	return m_Result.exchange(XR_SUCCESS);
+}
+
+void SwapChainWaiter::WaitChain(ovrTextureSwapChainData* chain)
+{
+	REV_TRACE_SCOPE(xrWaitSwapchainImage);
+	MICROPROFILE_SCOPEI("Revive", "xrWaitSwapchainImage", 0xff0000);
+
+	XrSwapchainImageWaitInfo waitInfo = XR_TYPE(SWAPCHAIN_IMAGE_WAIT_INFO);
+	waitInfo.timeout = XR_NO_DURATION;
+	auto start = std::chrono::steady_clock::now();
+	XrResult rs = xrWaitSwapchainImage(chain->Swapchain, &waitInfo);
+	m_WaitTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	assert(XR_SUCCEEDED(rs));
+	if (XR_FAILED(rs))
+		m_Result = rs;
+
+	chain->ImageReady = true;
+	m_Pending--;
+}
+
+void SwapChainWaiter::SignalReady()
+{
+	// Taking the lock ensures a thread that's about to block on the condition won't miss the notification
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+	}
+	m_Ready.notify_all();
+}
+
+void SwapChainWaiter::ThreadFunc(SwapChainWaiter* waiter)
+{
+	MicroProfileOnThreadCreate("Swapchain Wait");
+
+	while (waiter->m_Running)
+	{
+		// Read the wake word first, so an image submitted after the queue is drained wakes us right away
+		uint32_t wake = waiter->m_Wake;
+
+		ovrTextureSwapChainData* chain;
+		bool waited = false;
+		while (waiter->m_Queue.Pop(&chain))
+		{
+			waiter->WaitChain(chain);
+			waited = true;
+		}
+
+		if (waited)
+			waiter->SignalReady();
+
+		if (waiter->m_Running)
+			WaitOnWord(waiter->m_Wake, wake);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SwapChainQueue.h"
+
+#include <openxr/openxr.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+struct ovrTextureSwapChainData;
+
+// Waits on the acquired swapchain images in a background thread, so the app only blocks on them
+// when it begins the next frame. Committing an image never takes a lock unless the app has to wait
+// for the previous image of the same swapchain, the wait thread is woken through an atomic word.
+class SwapChainWaiter
+{
+public:
+	SwapChainWaiter();
+	~SwapChainWaiter();
+
+	void Start();
+
+	// Stops the wait thread, the images that were never waited on are marked ready so nothing blocks on them
+	void Stop();
+
+	// Blocks until the wait thread is done with the image of the swapchain, before it's released or destroyed
+	void WaitReady(ovrTextureSwapChainData* chain);
+
+	// Hands an acquired image to the wait thread, or waits on it directly if the queue is full
+	void Submit(ovrTextureSwapChainData* chain);
+
+	// Blocks until all submitted images are ready, returns the result of a failed wait since the previous call
+	XrResult WaitAll();
+
+	// Time spent waiting on the images since the previous call in microseconds, as if they were waited on serially
+	int64_t TakeWaitTime() { return m_WaitTime.exchange(0); }
+
+	uint32_t GetPending() const { return m_Pending; }
+
+private:
+	void WaitChain(ovrTextureSwapChainData* chain);
+	void SignalReady();
+	static void ThreadFunc(SwapChainWaiter* waiter);
+
+	SwapChainQueue m_Queue;
+	std::atomic_uint32_t m_Pending;
+	std::atomic<XrResult> m_Result;
+	std::atomic_int64_t m_WaitTime;
+
+	// The wake word is incremented for every submitted image, the thread sleeps while it's unchanged
+	std::thread m_Thread;
+	std::atomic_bool m_Running;
+	std::atomic_uint32_t m_Wake;
+
+	// The mutex is only needed to block on the ready condition
+	std::mutex m_Mutex;
+	std::condition_variable m_Ready;
+};
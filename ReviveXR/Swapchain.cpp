@@ -1,8 +1,9 @@
 #include "SwapChain.h"
 #include "Common.h"
+#include "Session.h"
 
 #include <openxr/openxr.h>
-#include <vector>
+#include <memory>
 
 XrSwapchainCreateInfo DescToCreateInfo(const ovrTextureSwapChainDesc* desc, int64_t format)
 {
@@ -38,34 +39,185 @@ XrSwapchainCreateInfo DescToCreateInfo(const ovrTextureSwapChainDesc* desc, int6
 	return createInfo;
 }
 
-ovrResult CreateSwapChain(XrSession session, const ovrTextureSwapChainDesc* desc, int64_t format, ovrTextureSwapChain* out)
+ovrResult CreateSwapChain(ovrSession session, const ovrTextureSwapChainDesc* desc, int64_t format, ovrTextureSwapChain* out)
 {
-	// Enumerate formats
-	uint32_t formatCount = 0;
-	xrEnumerateSwapchainFormats(session, 0, &formatCount, nullptr);
-	std::vector<int64_t> formats;
-	formats.resize(formatCount);
-	xrEnumerateSwapchainFormats(session, (uint32_t)formats.size(), &formatCount, formats.data());
-	assert(formats.size() == formatCount);
-
-	ovrTextureSwapChain swapChain = new ovrTextureSwapChainData();
-
 	// Check if the format is supported
-	if (std::find(formats.begin(), formats.end(), format) == formats.end()) {
+	if (!session->SupportsFormat(format))
 		return ovrError_InvalidParameter;
+
+	XrSwapchainCreateInfo createInfo = DescToCreateInfo(desc, format);
+
+	// Hand back an equivalent swapchain if one was recently destroyed
+	ovrTextureSwapChain pooled = session->ChainPool.Acquire(createInfo, desc->Format);
+	if (pooled)
+	{
+		pooled->Desc = *desc;
+		pooled->Cache.Layer.Header.type = XR_TYPE_UNKNOWN;
+		*out = pooled;
+		return ovrSuccess;
 	}
 
+	std::unique_ptr<ovrTextureSwapChainData> swapChain(new ovrTextureSwapChainData());
 	swapChain->Desc = *desc;
-	XrSwapchainCreateInfo createInfo = DescToCreateInfo(desc, format);
-	CHK_XR(xrCreateSwapchain(session, &createInfo, &swapChain->Swapchain));
+	swapChain->CreateInfo = createInfo;
+	CHK_XR(xrCreateSwapchain(session->Session, &createInfo, &swapChain->Swapchain));
 
 	XrSwapchainImageAcquireInfo acqInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
-	CHK_XR(xrAcquireSwapchainImage(swapChain->Swapchain, &acqInfo, &swapChain->CurrentIndex));
+	XrResult rs = xrAcquireSwapchainImage(swapChain->Swapchain, &acqInfo, &swapChain->CurrentIndex);
+	if (XR_SUCCEEDED(rs))
+	{
+		XrSwapchainImageWaitInfo waitInfo = XR_TYPE(SWAPCHAIN_IMAGE_WAIT_INFO);
+		waitInfo.timeout = XR_NO_DURATION;
+		rs = xrWaitSwapchainImage(swapChain->Swapchain, &waitInfo);
+	}
 
-	XrSwapchainImageWaitInfo waitInfo = XR_TYPE(SWAPCHAIN_IMAGE_WAIT_INFO);
-	waitInfo.timeout = XR_NO_DURATION;
-	CHK_XR(xrWaitSwapchainImage(swapChain->Swapchain, &waitInfo));
+	if (XR_FAILED(rs))
+	{
+		xrDestroySwapchain(swapChain->Swapchain);
+		CHK_XR(rs);
+	}
 
-	*out = swapChain;
+	swapChain->ImageReady = true;
+	*out = swapChain.release();
 	return ovrSuccess;
 }
+
+void DestroySwapChain(ovrTextureSwapChain chain)
+{
+	XrResult rs = xrDestroySwapchain(chain->Swapchain);
+	assert(XR_SUCCEEDED(rs));
+	delete[] chain->Images;
+	delete chain;
+}
+
+static uint64_t EstimateSwapChainBytes(ovrTextureSwapChain chain)
+{
+	uint64_t bytesPerPixel;
+	switch (chain->Desc.Format)
+	{
+		case OVR_FORMAT_B5G6R5_UNORM:
+		case OVR_FORMAT_B5G5R5A1_UNORM:
+		case OVR_FORMAT_B4G4R4A4_UNORM:
+		case OVR_FORMAT_D16_UNORM:
+			bytesPerPixel = 2;
+			break;
+		case OVR_FORMAT_R16G16B16A16_FLOAT:
+		case OVR_FORMAT_D32_FLOAT_S8X24_UINT:
+			bytesPerPixel = 8;
+			break;
+		default:
+			bytesPerPixel = 4;
+			break;
+	}
+
+	const XrSwapchainCreateInfo& info = chain->CreateInfo;
+	uint64_t bytes = bytesPerPixel * info.width * info.height * info.faceCount * info.arraySize * info.sampleCount;
+
+	// A full mip chain adds roughly a third to the size of the base level
+	if (info.mipCount > 1)
+		bytes += bytes / 3;
+	return bytes * chain->Length;
+}
+
+SwapChainPool::SwapChainPool()
+	: Hits(0)
+	, Misses(0)
+	, ResidentBytes(0)
+{
+}
+
+SwapChainPool::~SwapChainPool()
+{
+	Clear();
+}
+
+ovrTextureSwapChain SwapChainPool::Acquire(const XrSwapchainCreateInfo& createInfo, ovrTextureFormat format)
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	Trim(ovr_GetTimeInSeconds(), REV_SWAPCHAIN_POOL_BUDGET);
+
+	for (auto it = m_Entries.begin(); it != m_Entries.end(); it++)
+	{
+		const XrSwapchainCreateInfo& info = it->Chain->CreateInfo;
+		if (it->Chain->Desc.Format == format &&
+			info.createFlags == createInfo.createFlags &&
+			info.usageFlags == createInfo.usageFlags &&
+			info.format == createInfo.format &&
+			info.sampleCount == createInfo.sampleCount &&
+			info.width == createInfo.width &&
+			info.height == createInfo.height &&
+			info.faceCount == createInfo.faceCount &&
+			info.arraySize == createInfo.arraySize &&
+			info.mipCount == createInfo.mipCount)
+		{
+			ovrTextureSwapChain chain = it->Chain;
+			ResidentBytes -= it->Bytes;
+			m_Entries.erase(it);
+
+			Hits++;
+			MICROPROFILE_COUNTER_ADD("Swapchains/PoolHits", 1);
+			MICROPROFILE_COUNTER_SET("Swapchains/PoolResidentBytes", ResidentBytes.load());
+			return chain;
+		}
+	}
+
+	Misses++;
+	MICROPROFILE_COUNTER_ADD("Swapchains/PoolMisses", 1);
+	return nullptr;
+}
+
+bool SwapChainPool::Release(ovrTextureSwapChain chain)
+{
+	// Static images can't be acquired again once they've been released
+	if (chain->Desc.StaticImage)
+		return false;
+
+	uint64_t bytes = EstimateSwapChainBytes(chain);
+	if (bytes > REV_SWAPCHAIN_POOL_BUDGET)
+		return false;
+
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	double time = ovr_GetTimeInSeconds();
+	Trim(time, REV_SWAPCHAIN_POOL_BUDGET - bytes);
+
+	Entry entry = { chain, bytes, time };
+	m_Entries.push_back(entry);
+	ResidentBytes += bytes;
+	MICROPROFILE_COUNTER_SET("Swapchains/PoolResidentBytes", ResidentBytes.load());
+	return true;
+}
+
+void SwapChainPool::Clear()
+{
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	for (Entry& entry : m_Entries)
+		DestroySwapChain(entry.Chain);
+	m_Entries.clear();
+	ResidentBytes = 0;
+	MICROPROFILE_COUNTER_SET("Swapchains/PoolResidentBytes", 0);
+}
+
+void SwapChainPool::Trim()
+{
+	// Avoid taking the lock on every frame when nothing is parked
+	if (ResidentBytes == 0)
+		return;
+
+	std::lock_guard<std::mutex> lk(m_Mutex);
+	Trim(ovr_GetTimeInSeconds(), REV_SWAPCHAIN_POOL_BUDGET);
+	MICROPROFILE_COUNTER_SET("Swapchains/PoolResidentBytes", ResidentBytes.load());
+}
+
+void SwapChainPool::Trim(double time, uint64_t budget)
+{
+	// Entries are kept in the order they were released, so the oldest ones are evicted first
+	auto it = m_Entries.begin();
+	while (it != m_Entries.end() &&
+		(time - it->ReleaseTime > REV_SWAPCHAIN_POOL_TIMEOUT || ResidentBytes > budget))
+	{
+		DestroySwapChain(it->Chain);
+		ResidentBytes -= it->Bytes;
+		it++;
+	}
+	m_Entries.erase(m_Entries.begin(), it);
+}
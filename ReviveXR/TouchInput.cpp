@@ -0,0 +1,112 @@
+#include "TouchInput.h"
+#include "XR_Math.h"
+
+#include <algorithm>
+
+void TouchSnapshotToInputState(const TouchActionSnapshot& snapshot, bool wmrProfile, ovrInputState* inputState)
+{
+	if (snapshot.Button_Enter)
+		inputState->Buttons |= ovrButton_Enter;
+
+	// In most games this doesn't really do anything,
+	// because it would normally open the dashboard.
+	if (snapshot.Button_Home)
+		inputState->Buttons |= ovrButton_Home;
+
+	for (int i = 0; i < ovrHand_Count; i++)
+	{
+		ovrHandType hand = (ovrHandType)i;
+		unsigned int buttons = 0, touches = 0;
+
+		if (wmrProfile)
+		{
+			if (snapshot.Button_AX[i] || snapshot.Button_BY[i])
+			{
+				if (snapshot.Trackpad_Buttons[i] > 0.0f)
+					buttons |= ovrButton_B;
+				else
+					buttons |= ovrButton_A;
+			}
+
+			if (snapshot.Touch_AX[i] || snapshot.Touch_BY[i])
+			{
+				if (snapshot.Trackpad_Buttons[i] > 0.0f)
+					touches |= ovrTouch_B;
+				else
+					touches |= ovrTouch_A;
+			}
+		}
+		else
+		{
+			if (snapshot.Button_AX[i])
+				buttons |= ovrButton_A;
+
+			if (snapshot.Touch_AX[i])
+				touches |= ovrTouch_A;
+
+			if (snapshot.Button_BY[i])
+				buttons |= ovrButton_B;
+
+			if (snapshot.Touch_BY[i])
+				touches |= ovrTouch_B;
+		}
+
+		if (snapshot.Button_Thumb[i])
+			buttons |= ovrButton_RThumb;
+
+		if (snapshot.Touch_Thumb[i])
+			touches |= ovrTouch_RThumb;
+
+		if (snapshot.Touch_ThumbRest[i])
+			touches |= ovrTouch_RThumbRest;
+
+		if (snapshot.Touch_IndexTrigger[i])
+			touches |= ovrTouch_RIndexTrigger;
+
+		inputState->ThumbstickNoDeadzone[i] = snapshot.Thumbstick[i];
+		inputState->IndexTriggerNoDeadzone[i] = snapshot.IndexTrigger[i];
+		inputState->HandTriggerNoDeadzone[i] = snapshot.HandTrigger[i];
+
+		// Derive gestures from touch flags
+		if (inputState->HandTriggerNoDeadzone[i] > 0.5f)
+		{
+			if (!(touches & ovrTouch_RIndexTrigger))
+				touches |= ovrTouch_RIndexPointing;
+
+			if (!(touches & ~(ovrTouch_RIndexTrigger | ovrTouch_RIndexPointing)))
+				touches |= ovrTouch_RThumbUp;
+		}
+
+		// Apply deadzones where needed
+		inputState->Thumbstick[i] = ApplyDeadzone(inputState->ThumbstickNoDeadzone[i], 0.24f);
+		inputState->IndexTrigger[i] = inputState->IndexTriggerNoDeadzone[i];
+		inputState->HandTrigger[i] = inputState->HandTriggerNoDeadzone[i];
+
+		// We have no way to get raw values
+		inputState->ThumbstickRaw[i] = inputState->ThumbstickNoDeadzone[i];
+		inputState->IndexTriggerRaw[i] = inputState->IndexTriggerNoDeadzone[i];
+		inputState->HandTriggerRaw[i] = inputState->HandTriggerNoDeadzone[i];
+
+		inputState->Buttons |= (hand == ovrHand_Left) ? buttons << 8 : buttons;
+		inputState->Touches |= (hand == ovrHand_Left) ? touches << 8 : touches;
+	}
+}
+
+ovrVector2f ApplyDeadzone(ovrVector2f axis, float deadZone)
+{
+	XR::Vector2f vector(axis);
+	float mag = vector.Length();
+	if (mag > deadZone)
+	{
+		// scale such that output magnitude is in the range[0, 1]
+		float legalRange = 1.0f - deadZone;
+		float normalizedMag = std::min(1.0f, (mag - deadZone) / legalRange);
+		float scale = normalizedMag / mag;
+		return vector * scale;
+	}
+	else
+	{
+		// stick is in the inner dead zone
+		return OVR::Vector2f();
+	}
+}
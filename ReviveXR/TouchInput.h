@@ -0,0 +1,28 @@
+#pragma once
+
+#include "OVR_CAPI.h"
+
+// State of all Touch input actions, read once after every action sync
+struct TouchActionSnapshot
+{
+	bool Button_Enter;
+	bool Button_Home;
+	bool Button_AX[ovrHand_Count];
+	bool Button_BY[ovrHand_Count];
+	bool Button_Thumb[ovrHand_Count];
+	bool Touch_AX[ovrHand_Count];
+	bool Touch_BY[ovrHand_Count];
+	bool Touch_Thumb[ovrHand_Count];
+	bool Touch_ThumbRest[ovrHand_Count];
+	bool Touch_IndexTrigger[ovrHand_Count];
+	float IndexTrigger[ovrHand_Count];
+	float HandTrigger[ovrHand_Count];
+	float Trackpad_Buttons[ovrHand_Count];	// Only read for the WMR profile hack
+	ovrVector2f Thumbstick[ovrHand_Count];
+};
+
+// Converts the snapshot to the Touch input state, the buttons and touches are added to the state
+void TouchSnapshotToInputState(const TouchActionSnapshot& snapshot, bool wmrProfile, ovrInputState* inputState);
+
+// Scales the axis so the output magnitude is in the range [0, 1] outside of the dead zone
+ovrVector2f ApplyDeadzone(ovrVector2f axis, float deadZone);
@@ -76,6 +76,9 @@ namespace XR {
 		using OVR::Quatf::Quat;
 		Quatf() : OVR::Quatf() { }
 
+		// Inherited constructors can't convert from the base class
+		Quatf(const OVR::Quatf& s) : OVR::Quatf(s) { }
+
 		// OpenXR-interop support
 		Quatf(const XrQuaternionf& s)
 			: OVR::Quatf(s.x, s.y, s.z, s.w)
@@ -98,6 +101,7 @@ namespace XR {
 		// Inherit constructors
 		using OVR::Posef::Pose;
 		Posef() : OVR::Posef() { }
+		Posef(const OVR::Posef& s) : OVR::Posef(s) { }
 
 		// OpenXR-interop support
 		Posef(const XrPosef& s)
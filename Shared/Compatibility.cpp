@@ -0,0 +1,445 @@
+#include "Compatibility.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Shlobj.h>
+#include <Shlwapi.h>
+#else
+#include <strings.h>
+#define _stricmp strcasecmp
+#endif
+
+// Maximum prediction offset in milliseconds
+#define REV_COMPAT_MAX_PREDICTION_OFFSET 50.0
+
+// Parses a "major.minor.patch" version string into the packed OpenXR version layout
+static bool ParseVersion(const std::string& version, uint64_t* out)
+{
+	unsigned int major = 0, minor = 0, patch = 0;
+	if (sscanf(version.c_str(), "%u.%u.%u", &major, &minor, &patch) < 1)
+		return false;
+	*out = ((uint64_t)(major & 0xffff) << 48) | ((uint64_t)(minor & 0xffff) << 32) | patch;
+	return true;
+}
+
+static std::string Describe(const char* list, size_t index, const std::string& error)
+{
+	char prefix[64];
+	snprintf(prefix, sizeof(prefix), "%s[%zu]: ", list, index);
+	return prefix + error;
+}
+
+bool LoadCompatibilityFile(JsonValue* out, std::vector<std::string>* errors)
+{
+	std::string path;
+	const char* devFile = getenv("REVIVE_COMPAT_FILE");
+	if (devFile)
+	{
+		path = devFile;
+	}
+	else
+	{
+#ifdef _WIN32
+		std::vector<char> pathVec;
+		DWORD pathSize = MAX_PATH;
+		LSTATUS status = RegGetValueA(HKEY_LOCAL_MACHINE, "Software\\Revive", "", RRF_RT_REG_SZ | RRF_SUBKEY_WOW6432KEY, NULL, NULL, &pathSize);
+		if (status != ERROR_SUCCESS)
+			return false;
+
+		pathVec.resize(pathSize);
+		status = RegGetValueA(HKEY_LOCAL_MACHINE, "Software\\Revive", "", RRF_RT_REG_SZ | RRF_SUBKEY_WOW6432KEY, NULL, pathVec.data(), &pathSize);
+		if (status != ERROR_SUCCESS)
+			return false;
+
+		path = pathVec.data();
+		path += "\\compatibility.json";
+#else
+		return false;
+#endif
+	}
+
+	// Not having a compatibility file isn't an error
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return false;
+	fclose(file);
+
+	if (!JsonValue::ParseFile(path.c_str(), out) || !out->IsObject())
+	{
+		errors->push_back(path + " is not a valid JSON object");
+		return false;
+	}
+
+	// Reject files written for a different format, the version has to be an exact integer
+	const JsonValue* version = out->Find("version");
+	if (!version || !version->IsNumber() || version->Number() != (double)REV_COMPAT_FILE_VERSION)
+	{
+		errors->push_back(path + " doesn't have a supported \"version\", expected " + std::to_string(REV_COMPAT_FILE_VERSION));
+		return false;
+	}
+
+	for (size_t i = 0; i < out->MemberCount(); i++)
+	{
+		const std::string& key = out->GetKey(i);
+		if (key == "version")
+			continue;
+
+		if (key != "hacks" && key != "profiles")
+		{
+			errors->push_back(path + " has an unknown member \"" + key + "\"");
+			return false;
+		}
+
+		if (!out->GetMember(i).IsArray())
+		{
+			errors->push_back(path + ": \"" + key + "\" must be an array");
+			return false;
+		}
+	}
+	return true;
+}
+
+const JsonValue* GetCompatibilityFile(std::vector<std::string>* errors)
+{
+	// The file is only resolved and parsed once per process, no matter how many sessions are created
+	// TODO: Cache the parsed profiles in a memory-mapped binary file, so the JSON isn't parsed on every launch
+	struct CompatibilityFile
+	{
+		bool Loaded;
+		JsonValue Root;
+		std::vector<std::string> Errors;
+	};
+	static const CompatibilityFile file = []()
+	{
+		CompatibilityFile result;
+		result.Loaded = LoadCompatibilityFile(&result.Root, &result.Errors);
+		return result;
+	}();
+
+	errors->insert(errors->end(), file.Errors.begin(), file.Errors.end());
+	return file.Loaded ? &file.Root : nullptr;
+}
+
+// Converts a hack name into its index, returns false if the name is unknown
+static bool FindHack(const JsonValue& name, const char* const* hackNames, int hackCount, int* out)
+{
+	if (!name.IsString())
+		return false;
+
+	int hack = 0;
+	while (hack < hackCount && name.String() != hackNames[hack])
+		hack++;
+	*out = hack;
+	return hack < hackCount;
+}
+
+// Validates a hack table entry against the schema, returns false and describes the problem if it's invalid
+static bool ParseHackOverride(const JsonValue& entry, const char* const* hackNames, int hackCount, HackOverride* out, std::string* error)
+{
+	if (!entry.IsObject())
+	{
+		*error = "must be an object";
+		return false;
+	}
+
+	HackOverride hack;
+	hack.VersionStart = 0;
+	hack.VersionEnd = 0;
+	hack.UseHack = true;
+	for (size_t i = 0; i < entry.MemberCount(); i++)
+	{
+		const std::string& key = entry.GetKey(i);
+		const JsonValue& value = entry.GetMember(i);
+
+		bool valid;
+		if (key == "hack")
+		{
+			int index;
+			valid = FindHack(value, hackNames, hackCount, &index);
+			if (valid)
+				hack.Hack = value.String();
+		}
+		else if (key == "filename" || key == "target")
+		{
+			valid = value.IsString();
+			if (valid)
+				(key == "filename" ? hack.Filename : hack.Target) = value.String();
+		}
+		else if (key == "versionStart" || key == "versionEnd")
+		{
+			valid = value.IsString() && ParseVersion(value.String(), key == "versionStart" ? &hack.VersionStart : &hack.VersionEnd);
+		}
+		else if (key == "enabled")
+		{
+			valid = value.IsBool();
+			hack.UseHack = value.Bool();
+		}
+		else
+		{
+			*error = "unknown member \"" + key + "\"";
+			return false;
+		}
+
+		if (!valid)
+		{
+			*error = "invalid \"" + key + "\"";
+			return false;
+		}
+	}
+
+	if (hack.Hack.empty())
+	{
+		*error = "missing \"hack\"";
+		return false;
+	}
+
+	*out = hack;
+	return true;
+}
+
+std::vector<HackOverride> GetHackOverrides(const JsonValue& root, const char* const* hackNames, int hackCount,
+	std::vector<std::string>* errors)
+{
+	std::vector<HackOverride> overrides;
+	const JsonValue* hacks = root.Find("hacks");
+	if (!hacks)
+		return overrides;
+
+	for (size_t i = 0; i < hacks->Size(); i++)
+	{
+		HackOverride hack;
+		std::string error;
+		if (ParseHackOverride((*hacks)[i], hackNames, hackCount, &hack, &error))
+			overrides.push_back(hack);
+		else
+			errors->push_back(Describe("hacks", i, error));
+	}
+	return overrides;
+}
+
+// Converts a list of hack names into a mask, returns false if any of the names is unknown
+static bool ParseHackList(const JsonValue& list, const char* const* hackNames, int hackCount, uint64_t* out)
+{
+	if (!list.IsArray())
+		return false;
+
+	*out = 0;
+	for (size_t i = 0; i < list.Size(); i++)
+	{
+		int hack;
+		if (!FindHack(list[i], hackNames, hackCount, &hack))
+			return false;
+		*out |= 1ull << hack;
+	}
+	return true;
+}
+
+static bool ParseHapticsEnvelope(const JsonValue& haptics, HapticsEnvelope* out)
+{
+	const JsonValue* blockSamples = haptics.Find("blockSamples");
+	const JsonValue* maxSamples = haptics.Find("maxSamples");
+	const JsonValue* tolerance = haptics.Find("tolerance");
+	const JsonValue* useFrequency = haptics.Find("useFrequency");
+	if (haptics.MemberCount() != 4 || !blockSamples || !blockSamples->IsNumber() || !maxSamples || !maxSamples->IsNumber() ||
+		!tolerance || !tolerance->IsNumber() || !useFrequency || !useFrequency->IsBool())
+		return false;
+
+	// The segments can't be longer than the sample buffer
+	if (blockSamples->Number() < 1.0 || maxSamples->Number() < blockSamples->Number() || maxSamples->Number() > OVR_HAPTICS_BUFFER_SAMPLES_MAX ||
+		tolerance->Number() < 0.0 || tolerance->Number() > 255.0)
+		return false;
+
+	out->BlockSamples = (unsigned int)blockSamples->Number();
+	out->MaxSamples = (unsigned int)maxSamples->Number();
+	out->Tolerance = (uint8_t)tolerance->Number();
+	out->UseFrequency = useFrequency->Bool();
+	return true;
+}
+
+// Validates the profile against the schema and applies it, the output is untouched if it's invalid
+static bool ApplyProfile(const JsonValue& entry, const char* const* hackNames, int hackCount, CompatibilityProfile* out, std::string* error)
+{
+	if (!entry.IsObject())
+	{
+		*error = "must be an object";
+		return false;
+	}
+
+	const JsonValue* filename = entry.Find("filename");
+	if (!filename || !filename->IsString() || filename->String().empty())
+	{
+		*error = "missing \"filename\"";
+		return false;
+	}
+
+	CompatibilityProfile profile = *out;
+	for (size_t i = 0; i < entry.MemberCount(); i++)
+	{
+		const std::string& key = entry.GetKey(i);
+		const JsonValue& value = entry.GetMember(i);
+
+		bool valid = true;
+		if (key == "filename" || key == "target")
+		{
+			valid = value.IsString();
+		}
+		else if (key == "hacks" || key == "disabledHacks")
+		{
+			uint64_t hacks;
+			valid = ParseHackList(value, hackNames, hackCount, &hacks);
+
+			uint64_t& enabled = key == "hacks" ? profile.EnabledHacks : profile.DisabledHacks;
+			uint64_t& disabled = key == "hacks" ? profile.DisabledHacks : profile.EnabledHacks;
+			if (valid)
+			{
+				enabled |= hacks;
+				disabled &= ~hacks;
+			}
+		}
+		else if (key == "predictionOffset")
+		{
+			valid = value.IsNumber() && fabs(value.Number()) <= REV_COMPAT_MAX_PREDICTION_OFFSET;
+			profile.PredictionOffset = value.Number() / 1000.0;
+		}
+		else if (key == "swapchainDepth")
+		{
+			valid = value.IsNumber() && value.Number() == floor(value.Number()) &&
+				value.Number() >= REV_COMPAT_MIN_SWAPCHAIN_DEPTH && value.Number() <= REV_COMPAT_MAX_SWAPCHAIN_DEPTH;
+			profile.SwapchainDepth = valid ? (unsigned int)value.Number() : 0;
+		}
+		else if (key == "framePacing")
+		{
+			valid = value.IsBool();
+			profile.FramePacing = value.Bool();
+		}
+		else if (key == "haptics")
+		{
+			valid = ParseHapticsEnvelope(value, &profile.Haptics);
+			profile.OverrideHaptics = true;
+		}
+		else
+		{
+			*error = "unknown member \"" + key + "\"";
+			return false;
+		}
+
+		if (!valid)
+		{
+			*error = "invalid \"" + key + "\"";
+			return false;
+		}
+	}
+
+	*out = profile;
+	return true;
+}
+
+bool GetCompatibilityProfile(const JsonValue& root, const char* filename, const char* target,
+	const char* const* hackNames, int hackCount, CompatibilityProfile* out, std::vector<std::string>* errors)
+{
+	const JsonValue* profiles = root.Find("profiles");
+	if (!profiles)
+		return true;
+
+	// Every profile is validated, so mistakes show up before the title they're meant for is launched
+	bool valid = true;
+	for (size_t i = 0; i < profiles->Size(); i++)
+	{
+		const JsonValue& entry = (*profiles)[i];
+		const JsonValue* entryFilename = entry.Find("filename");
+		const JsonValue* entryTarget = entry.Find("target");
+		bool match = entryFilename && entryFilename->IsString() && _stricmp(filename, entryFilename->String().c_str()) == 0 &&
+			(!entryTarget || !entryTarget->IsString() || strcmp(target, entryTarget->String().c_str()) == 0);
+
+		CompatibilityProfile scratch;
+		std::string error;
+		if (!ApplyProfile(entry, hackNames, hackCount, match ? out : &scratch, &error))
+		{
+			errors->push_back(Describe("profiles", i, error));
+			valid = false;
+		}
+	}
+	return valid;
+}
+
+uint64_t ApplyCompatibility(const JsonValue& root, uint64_t hacks, const char* filename, const char* target,
+	const uint64_t* version, const char* const* hackNames, int hackCount, CompatibilityProfile* profile,
+	std::vector<std::string>* errors)
+{
+	const JsonValue* overrides = root.Find("hacks");
+	for (size_t i = 0; overrides && i < overrides->Size(); i++)
+	{
+		HackOverride entry;
+		std::string error;
+		if (!ParseHackOverride((*overrides)[i], hackNames, hackCount, &entry, &error))
+		{
+			errors->push_back(Describe("hacks", i, error));
+			continue;
+		}
+
+		bool hasRange = entry.VersionStart || entry.VersionEnd;
+		if (hasRange && !version)
+		{
+			errors->push_back(Describe("hacks", i, std::string("\"versionStart\" and \"versionEnd\" aren't supported for ") + target));
+			continue;
+		}
+
+		if ((!entry.Filename.empty() && _stricmp(filename, entry.Filename.c_str()) != 0) ||
+			(!entry.Target.empty() && strcmp(target, entry.Target.c_str()) != 0) ||
+			(hasRange && (*version < entry.VersionStart || (entry.VersionEnd && *version >= entry.VersionEnd))))
+			continue;
+
+		// Unlike the hack tables, an override only affects the titles it matches
+		int hack;
+		for (hack = 0; hack < hackCount && entry.Hack != hackNames[hack]; hack++)
+			;
+		if (entry.UseHack)
+			hacks |= 1ull << hack;
+		else
+			hacks &= ~(1ull << hack);
+	}
+
+	// The per-title profiles are applied last, so they take precedence over the hack tables
+	GetCompatibilityProfile(root, filename, target, hackNames, hackCount, profile, errors);
+	return (hacks | profile->EnabledHacks) & ~profile->DisabledHacks;
+}
+
+void LogCompatibilityErrors(const std::vector<std::string>& errors)
+{
+	if (errors.empty())
+		return;
+
+#ifdef _WIN32
+	// Keep the errors of the last launch next to the injector log, so they can be found without a debugger
+	FILE* log = nullptr;
+	char path[MAX_PATH];
+	if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, path)))
+	{
+		strncat(path, "\\Revive", MAX_PATH - strlen(path) - 1);
+		if (PathFileExistsA(path) || CreateDirectoryA(path, NULL))
+		{
+			strncat(path, "\\Compatibility.txt", MAX_PATH - strlen(path) - 1);
+			log = fopen(path, "w");
+		}
+	}
+
+	for (const std::string& error : errors)
+	{
+		std::string message = "Revive: Ignoring invalid compatibility entry, " + error + "\n";
+		OutputDebugStringA(message.c_str());
+		if (log)
+			fputs(message.c_str(), log);
+	}
+
+	if (log)
+		fclose(log);
+#else
+	for (const std::string& error : errors)
+		fprintf(stderr, "Revive: Ignoring invalid compatibility entry, %s\n", error.c_str());
+#endif
+}
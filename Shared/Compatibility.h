@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Json.h"
+#include "HapticsBuffer.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Version of the compatibility file format, files with a different version are ignored
+#define REV_COMPAT_FILE_VERSION 1
+
+// Range of the swapchain depth a profile can request
+#define REV_COMPAT_MIN_SWAPCHAIN_DEPTH 2
+#define REV_COMPAT_MAX_SWAPCHAIN_DEPTH 3
+
+// Hack table entry loaded from the compatibility file, the string fields are empty to match anything
+struct HackOverride
+{
+	std::string Filename;	// The filename of the main executable
+	std::string Target;		// The name of the driver or runtime
+	std::string Hack;		// The name of the hack, e.g. "HACK_SPOOF_SENSORS"
+	uint64_t VersionStart;	// First runtime version it applies to, parsed from a "major.minor.patch" string
+	uint64_t VersionEnd;	// First runtime version it no longer applies to, zero if it applies to all later versions
+	bool UseHack;			// Whether to enable or disable the hack for the matching titles
+};
+
+// Per-title settings, profiles are matched on the executable filename and optionally the name of the
+// driver or runtime. Every matching profile is applied in order, so later profiles take precedence.
+struct CompatibilityProfile
+{
+	CompatibilityProfile()
+		: EnabledHacks(0)
+		, DisabledHacks(0)
+		, PredictionOffset(0.0)
+		, SwapchainDepth(0)
+		, FramePacing(false)
+		, OverrideHaptics(false)
+		, Haptics()
+	{
+	}
+
+	uint64_t EnabledHacks;		// Hacks to enable on top of the hack tables
+	uint64_t DisabledHacks;		// Hacks to disable, even if the hack tables enable them
+	double PredictionOffset;	// Seconds added to the tracking state query time
+	unsigned int SwapchainDepth;	// Number of images in a swapchain, zero for the default (Revive only)
+	bool FramePacing;			// Whether the release of the app thread is paced, opt-in (Revive only)
+	bool OverrideHaptics;		// Whether the haptics envelope is overridden (ReviveXR only)
+	HapticsEnvelope Haptics;
+};
+
+// The compatibility file is loaded from the path in the REVIVE_COMPAT_FILE environment variable,
+// or from compatibility.json in the Revive installation directory. Its hacks are applied after the
+// built-in ones, for example:
+// { "version": 1, "hacks": [ { "filename": "game.exe", "target": "lighthouse", "hack": "HACK_SPOOF_SENSORS" } ] }
+// A hack is disabled for the matching titles with "enabled": false, titles that don't match are unaffected.
+// Profiles are listed in the "profiles" array, for example:
+// { "filename": "game.exe", "hacks": [ "HACK_WAIT_ON_SUBMIT" ], "disabledHacks": [], "predictionOffset": 2.0,
+//   "swapchainDepth": 2, "framePacing": true,
+//   "haptics": { "blockSamples": 4, "maxSamples": 32, "tolerance": 16, "useFrequency": true } }
+// The prediction offset is in milliseconds. The file is rejected if its version or top-level members don't
+// match the schema, hack entries and profiles that don't match it are ignored. Every problem is added to
+// the errors, which can be reported with LogCompatibilityErrors.
+bool LoadCompatibilityFile(JsonValue* out, std::vector<std::string>* errors);
+// Loads the compatibility file the first time it's called and returns the same file afterwards, or null if
+// there's none. The errors found while loading it are added to the errors on every call.
+const JsonValue* GetCompatibilityFile(std::vector<std::string>* errors);
+std::vector<HackOverride> GetHackOverrides(const JsonValue& root, const char* const* hackNames, int hackCount,
+	std::vector<std::string>* errors);
+bool GetCompatibilityProfile(const JsonValue& root, const char* filename, const char* target,
+	const char* const* hackNames, int hackCount, CompatibilityProfile* out, std::vector<std::string>* errors);
+
+// Applies the hack overrides and the profiles matching the title to the mask of the built-in hack tables
+// and returns the new mask, the profile of the title is stored in profile. Overrides with a version range
+// only match runtime versions in [VersionStart, VersionEnd). The version is null if the target doesn't
+// report one, overrides with a version range are then rejected.
+uint64_t ApplyCompatibility(const JsonValue& root, uint64_t hacks, const char* filename, const char* target,
+	const uint64_t* version, const char* const* hackNames, int hackCount, CompatibilityProfile* profile,
+	std::vector<std::string>* errors);
+void LogCompatibilityErrors(const std::vector<std::string>& errors);
@@ -0,0 +1,232 @@
+#include "HapticsScheduler.h"
+#include "HapticsBuffer.h"
+#include "microprofile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+class SystemHapticsClock : public HapticsClock
+{
+public:
+	SystemHapticsClock()
+	{
+		// High-resolution timers are only supported since Windows 10 1803
+		m_Timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!m_Timer)
+			m_Timer = CreateWaitableTimerW(nullptr, FALSE, nullptr);
+		m_WakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+	}
+
+	virtual ~SystemHapticsClock()
+	{
+		CloseHandle(m_Timer);
+		CloseHandle(m_WakeEvent);
+	}
+
+	virtual TimePoint Now() override { return std::chrono::steady_clock::now(); }
+
+	virtual void SleepUntil(TimePoint deadline) override
+	{
+		std::chrono::nanoseconds delay = deadline - Now();
+		if (delay.count() <= 0)
+			return;
+
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -(LONGLONG)(delay.count() / 100);
+		SetWaitableTimer(m_Timer, &dueTime, 0, nullptr, nullptr, FALSE);
+		WaitForSingleObject(m_Timer, INFINITE);
+	}
+
+	virtual void WaitForWake() override { WaitForSingleObject(m_WakeEvent, INFINITE); }
+	virtual void Wake() override { SetEvent(m_WakeEvent); }
+
+private:
+	HANDLE m_Timer;
+	HANDLE m_WakeEvent;
+};
+#else
+class SystemHapticsClock : public HapticsClock
+{
+public:
+	SystemHapticsClock() : m_Woken(false) { }
+
+	virtual TimePoint Now() override { return std::chrono::steady_clock::now(); }
+	virtual void SleepUntil(TimePoint deadline) override { std::this_thread::sleep_until(deadline); }
+
+	virtual void WaitForWake() override
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+		m_WakeCondition.wait(lk, [this] { return m_Woken; });
+		m_Woken = false;
+	}
+
+	virtual void Wake() override
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_Mutex);
+			m_Woken = true;
+		}
+		m_WakeCondition.notify_one();
+	}
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_WakeCondition;
+	bool m_Woken;
+};
+#endif
+
+std::unique_ptr<HapticsClock> HapticsClock::CreateSystemClock()
+{
+	return std::unique_ptr<HapticsClock>(new SystemHapticsClock());
+}
+
+HapticsScheduler& HapticsScheduler::Get()
+{
+	static HapticsScheduler scheduler(HapticsClock::CreateSystemClock());
+	return scheduler;
+}
+
+HapticsScheduler::HapticsScheduler(std::unique_ptr<HapticsClock> clock)
+	: m_Outputs()
+	, m_Vibrations()
+	, m_Dispatching(false)
+	, m_Running(false)
+	, m_Clock(std::move(clock))
+{
+}
+
+HapticsScheduler::~HapticsScheduler()
+{
+	// The thread is normally stopped when the last output is removed
+	if (m_Thread.joinable())
+	{
+		m_Running = false;
+		m_Clock->Wake();
+		m_Thread.join();
+	}
+}
+
+void HapticsScheduler::AddOutput(HapticsBuffer* buffer, const HapticsEnvelope& envelope, VibrateFunc vibrate)
+{
+	std::lock_guard<std::mutex> threadLock(m_ThreadMutex);
+
+	{
+		std::lock_guard<std::mutex> lk(m_OutputsMutex);
+		m_Outputs.push_back(Output{ buffer, envelope, vibrate, 0 });
+	}
+
+	if (!m_Running)
+	{
+		m_Running = true;
+		m_Thread = std::thread(SchedulerThread, this);
+	}
+}
+
+void HapticsScheduler::RemoveOutput(HapticsBuffer* buffer)
+{
+	std::lock_guard<std::mutex> threadLock(m_ThreadMutex);
+
+	bool empty;
+	{
+		std::unique_lock<std::mutex> lk(m_OutputsMutex);
+		m_Outputs.erase(std::remove_if(m_Outputs.begin(), m_Outputs.end(),
+			[buffer](const Output& output) { return output.Buffer == buffer; }), m_Outputs.end());
+		empty = m_Outputs.empty();
+
+		// The scheduler may still be calling a copy of the callback, wait until it's done
+		m_Dispatched.wait(lk, [this] { return !m_Dispatching; });
+	}
+
+	// Stop the thread when there are no outputs left
+	if (empty && m_Running)
+	{
+		m_Running = false;
+		m_Clock->Wake();
+		m_Thread.join();
+	}
+}
+
+void HapticsScheduler::Wake()
+{
+	m_Clock->Wake();
+}
+
+bool HapticsScheduler::Tick()
+{
+	bool active = false;
+	{
+		std::lock_guard<std::mutex> lk(m_OutputsMutex);
+		for (Output& output : m_Outputs)
+		{
+			// Start a new vibration for the next segment
+			if (output.Remaining == 0)
+			{
+				HapticsSegment segment;
+				if (!output.Buffer->PeekSegment(output.Envelope, &segment))
+					continue;
+
+				if (segment.Amplitude > 0.0f)
+					m_Vibrations.push_back(Vibration{ output.Vibrate, segment });
+				output.Remaining = segment.Samples;
+				MICROPROFILE_COUNTER_ADD("Haptics/Vibrations", segment.Amplitude > 0.0f ? 1 : 0);
+			}
+
+			// Consume the samples at the sample rate, so the playback state stays accurate
+			output.Buffer->GetSample();
+			output.Remaining--;
+			active = true;
+		}
+
+		if (m_Vibrations.empty())
+			return active;
+		m_Dispatching = true;
+	}
+
+	// The callbacks call into the runtime, so don't block the outputs while they're running
+	for (const Vibration& vibration : m_Vibrations)
+		vibration.Vibrate(vibration.Segment);
+	m_Vibrations.clear();
+
+	{
+		std::lock_guard<std::mutex> lk(m_OutputsMutex);
+		m_Dispatching = false;
+	}
+	m_Dispatched.notify_all();
+	return active;
+}
+
+void HapticsScheduler::SchedulerThread(HapticsScheduler* scheduler)
+{
+	MicroProfileOnThreadCreate("Haptics");
+
+	HapticsClock* clock = scheduler->m_Clock.get();
+	const std::chrono::nanoseconds period = std::chrono::nanoseconds(std::chrono::seconds(1)) / REV_HAPTICS_SAMPLE_RATE;
+	HapticsClock::TimePoint deadline = clock->Now();
+
+	while (scheduler->m_Running)
+	{
+		if (!scheduler->Tick())
+		{
+			// All buffers are empty, sleep until new samples are submitted
+			clock->WaitForWake();
+			deadline = clock->Now();
+			continue;
+		}
+
+		// Pace the ticks against an absolute deadline so timer jitter doesn't accumulate,
+		// but don't try to catch up with a burst of ticks if we fell far behind
+		deadline += period;
+		std::chrono::nanoseconds delay = deadline - clock->Now();
+		if (delay.count() > 0)
+			clock->SleepUntil(deadline);
+		else if (delay < -period)
+			deadline = clock->Now();
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "HapticsSegment.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+class HapticsBuffer;
+
+// The time source and the waits of the scheduler thread, so the scheduling can be simulated.
+// The system clock uses a high-resolution waitable timer on Windows.
+class HapticsClock
+{
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	virtual ~HapticsClock() { }
+
+	virtual TimePoint Now() = 0;
+	virtual void SleepUntil(TimePoint deadline) = 0;
+
+	// Blocks until Wake is called, a wake that arrived since the previous wait returns immediately
+	virtual void WaitForWake() = 0;
+	virtual void Wake() = 0;
+
+	static std::unique_ptr<HapticsClock> CreateSystemClock();
+};
+
+// Plays back the haptics buffers of all devices from a single thread paced against the clock.
+// The samples are converted into vibration segments according to the envelope of each output
+// and the thread goes idle until it's woken up when all buffers are empty.
+class HapticsScheduler
+{
+public:
+	// Called from the scheduler thread for every segment with a non-zero amplitude, without holding
+	// any scheduler locks. Once RemoveOutput returns the callback of that output won't be called again.
+	typedef std::function<void(const HapticsSegment& segment)> VibrateFunc;
+
+	static HapticsScheduler& Get();
+
+	explicit HapticsScheduler(std::unique_ptr<HapticsClock> clock);
+	~HapticsScheduler();
+
+	void AddOutput(HapticsBuffer* buffer, const HapticsEnvelope& envelope, VibrateFunc vibrate);
+	void RemoveOutput(HapticsBuffer* buffer);
+
+	// Wakes up the scheduler after new samples were submitted
+	void Wake();
+
+private:
+	struct Output
+	{
+		HapticsBuffer* Buffer;
+		HapticsEnvelope Envelope;
+		VibrateFunc Vibrate;
+		uint32_t Remaining;	// Samples left in the last segment
+	};
+
+	struct Vibration
+	{
+		VibrateFunc Vibrate;
+		HapticsSegment Segment;
+	};
+
+	std::mutex m_OutputsMutex;
+	std::vector<Output> m_Outputs;
+
+	// Vibrations collected by a tick, they're started after the outputs lock is released
+	std::vector<Vibration> m_Vibrations;
+	bool m_Dispatching;
+	std::condition_variable m_Dispatched;
+
+	// Serializes starting and stopping the thread
+	std::mutex m_ThreadMutex;
+	std::thread m_Thread;
+	std::atomic_bool m_Running;
+	std::unique_ptr<HapticsClock> m_Clock;
+
+	bool Tick();
+	static void SchedulerThread(HapticsScheduler* scheduler);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+#define REV_HAPTICS_SAMPLE_RATE 320
+
+// Shortest block used to estimate the pulse frequency, 16 samples resolve steps of 20 Hz
+#define REV_HAPTICS_FREQUENCY_BLOCK 16
+
+// Describes how the sample stream is converted into vibration segments for an actuator
+struct HapticsEnvelope
+{
+	unsigned int BlockSamples;	// Resolution of the envelope in samples
+	unsigned int MaxSamples;	// Maximum length of a single segment
+	uint8_t Tolerance;			// Maximum RMS level difference between blocks in the same segment
+	bool UseFrequency;			// Whether the actuator can vibrate at a given frequency
+};
+
+// A single vibration covering a number of samples
+struct HapticsSegment
+{
+	float Amplitude;
+	float Frequency;	// Zero if unspecified
+	unsigned int Samples;
+};
@@ -0,0 +1,230 @@
+#include "Json.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nesting limit, so a malformed file can't overflow the stack
+#define REV_JSON_MAX_DEPTH 32
+
+static void SkipWhitespace(const char*& p)
+{
+	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+		p++;
+}
+
+bool JsonValue::Parse(const char* text, JsonValue* out)
+{
+	const char* p = text;
+	if (!ParseValue(p, out, 0))
+		return false;
+
+	// Only whitespace may follow the document
+	SkipWhitespace(p);
+	return *p == '\0';
+}
+
+bool JsonValue::ParseFile(const char* path, JsonValue* out)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	std::string text;
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		text.append(buffer, read);
+	fclose(file);
+
+	// Skip the UTF-8 byte order mark
+	const char* start = text.c_str();
+	if (text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+		start += 3;
+	return Parse(start, out);
+}
+
+bool JsonValue::ParseString(const char*& p, std::string* out)
+{
+	if (*p != '"')
+		return false;
+	p++;
+
+	out->clear();
+	while (*p != '"')
+	{
+		if (*p == '\0')
+			return false;
+
+		if (*p != '\\')
+		{
+			out->push_back(*p++);
+			continue;
+		}
+
+		p++;
+		switch (*p++)
+		{
+		case '"': out->push_back('"'); break;
+		case '\\': out->push_back('\\'); break;
+		case '/': out->push_back('/'); break;
+		case 'b': out->push_back('\b'); break;
+		case 'f': out->push_back('\f'); break;
+		case 'n': out->push_back('\n'); break;
+		case 'r': out->push_back('\r'); break;
+		case 't': out->push_back('\t'); break;
+		case 'u':
+		{
+			char hex[5] = { 0 };
+			for (int i = 0; i < 4; i++)
+			{
+				if (!isxdigit((unsigned char)p[i]))
+					return false;
+				hex[i] = p[i];
+			}
+			p += 4;
+			unsigned long code = strtoul(hex, nullptr, 16);
+			out->push_back(code < 0x80 ? (char)code : '?');
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+	p++;
+	return true;
+}
+
+bool JsonValue::ParseValue(const char*& p, JsonValue* out, int depth)
+{
+	if (depth > REV_JSON_MAX_DEPTH)
+		return false;
+
+	SkipWhitespace(p);
+	*out = JsonValue();
+
+	if (*p == '{')
+	{
+		out->m_Type = TYPE_OBJECT;
+		p++;
+		SkipWhitespace(p);
+		if (*p == '}')
+		{
+			p++;
+			return true;
+		}
+
+		while (true)
+		{
+			std::string key;
+			SkipWhitespace(p);
+			if (!ParseString(p, &key))
+				return false;
+
+			SkipWhitespace(p);
+			if (*p++ != ':')
+				return false;
+
+			out->m_Keys.push_back(key);
+			out->m_Array.emplace_back();
+			if (!ParseValue(p, &out->m_Array.back(), depth + 1))
+				return false;
+
+			SkipWhitespace(p);
+			if (*p == '}')
+			{
+				p++;
+				return true;
+			}
+			if (*p++ != ',')
+				return false;
+		}
+	}
+	else if (*p == '[')
+	{
+		out->m_Type = TYPE_ARRAY;
+		p++;
+		SkipWhitespace(p);
+		if (*p == ']')
+		{
+			p++;
+			return true;
+		}
+
+		while (true)
+		{
+			out->m_Array.emplace_back();
+			if (!ParseValue(p, &out->m_Array.back(), depth + 1))
+				return false;
+
+			SkipWhitespace(p);
+			if (*p == ']')
+			{
+				p++;
+				return true;
+			}
+			if (*p++ != ',')
+				return false;
+		}
+	}
+	else if (*p == '"')
+	{
+		out->m_Type = TYPE_STRING;
+		return ParseString(p, &out->m_String);
+	}
+	else if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0)
+	{
+		out->m_Type = TYPE_BOOL;
+		out->m_Bool = *p == 't';
+		p += out->m_Bool ? 4 : 5;
+		return true;
+	}
+	else if (strncmp(p, "null", 4) == 0)
+	{
+		p += 4;
+		return true;
+	}
+	else if (*p == '-' || (*p >= '0' && *p <= '9'))
+	{
+		char* end;
+		out->m_Type = TYPE_NUMBER;
+		out->m_Number = strtod(p, &end);
+		if (end == p)
+			return false;
+		p = end;
+		return true;
+	}
+	return false;
+}
+
+const JsonValue* JsonValue::Find(const char* key) const
+{
+	if (m_Type != TYPE_OBJECT)
+		return nullptr;
+
+	for (size_t i = 0; i < m_Keys.size(); i++)
+	{
+		if (m_Keys[i] == key)
+			return &m_Array[i];
+	}
+	return nullptr;
+}
+
+bool JsonValue::GetBool(const char* key, bool fallback) const
+{
+	const JsonValue* value = Find(key);
+	return value && value->m_Type == TYPE_BOOL ? value->m_Bool : fallback;
+}
+
+double JsonValue::GetNumber(const char* key, double fallback) const
+{
+	const JsonValue* value = Find(key);
+	return value && value->m_Type == TYPE_NUMBER ? value->m_Number : fallback;
+}
+
+std::string JsonValue::GetString(const char* key, const char* fallback) const
+{
+	const JsonValue* value = Find(key);
+	return value && value->m_Type == TYPE_STRING ? value->m_String : fallback;
+}
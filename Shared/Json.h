@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Minimal JSON document parser for the configuration files, it only supports UTF-8 input and
+// doesn't decode \u escapes outside of the ASCII range.
+class JsonValue
+{
+public:
+	enum Type
+	{
+		TYPE_NULL,
+		TYPE_BOOL,
+		TYPE_NUMBER,
+		TYPE_STRING,
+		TYPE_ARRAY,
+		TYPE_OBJECT,
+	};
+
+	JsonValue() : m_Type(TYPE_NULL), m_Bool(false), m_Number(0.0) { }
+
+	static bool Parse(const char* text, JsonValue* out);
+	static bool ParseFile(const char* path, JsonValue* out);
+
+	Type GetType() const { return m_Type; }
+	bool IsBool() const { return m_Type == TYPE_BOOL; }
+	bool IsNumber() const { return m_Type == TYPE_NUMBER; }
+	bool IsString() const { return m_Type == TYPE_STRING; }
+	bool IsObject() const { return m_Type == TYPE_OBJECT; }
+	bool IsArray() const { return m_Type == TYPE_ARRAY; }
+
+	bool Bool() const { return m_Bool; }
+	double Number() const { return m_Number; }
+	const std::string& String() const { return m_String; }
+
+	// Array access
+	size_t Size() const { return m_Type == TYPE_ARRAY ? m_Array.size() : 0; }
+	const JsonValue& operator[](size_t index) const { return m_Array[index]; }
+
+	// Object access, Find returns nullptr if the member doesn't exist
+	size_t MemberCount() const { return m_Type == TYPE_OBJECT ? m_Keys.size() : 0; }
+	const std::string& GetKey(size_t index) const { return m_Keys[index]; }
+	const JsonValue& GetMember(size_t index) const { return m_Array[index]; }
+	const JsonValue* Find(const char* key) const;
+	bool GetBool(const char* key, bool fallback) const;
+	double GetNumber(const char* key, double fallback) const;
+	std::string GetString(const char* key, const char* fallback) const;
+
+private:
+	static bool ParseValue(const char*& p, JsonValue* out, int depth);
+	static bool ParseString(const char*& p, std::string* out);
+
+	Type m_Type;
+	bool m_Bool;
+	double m_Number;
+	std::string m_String;
+	std::vector<JsonValue> m_Array;		// Array elements or object members
+	std::vector<std::string> m_Keys;	// Object member names
+};
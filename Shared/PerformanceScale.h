@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+
+// Fraction of the frame budget we want the app to use
+#define REV_PERF_SCALE_TARGET 0.9f
+// Smoothing factors of the load average, the app needs to back off faster than it can ramp up
+#define REV_PERF_SCALE_ALPHA_UP 0.3f
+#define REV_PERF_SCALE_ALPHA_DOWN 0.05f
+// Relative change of the estimate before the reported scale is updated
+#define REV_PERF_SCALE_HYSTERESIS 0.05f
+#define REV_PERF_SCALE_MIN 0.5f
+#define REV_PERF_SCALE_MAX 2.0f
+
+// Estimates the adaptive GPU performance scale, which is the factor by which the app should scale
+// its workload so it uses the target fraction of the frame budget. Frames are added from the thread
+// that submits them, while the scale can be read from any thread.
+class PerformanceScale
+{
+public:
+	PerformanceScale() : m_Load(0.0f), m_Scale(1.0f) { }
+
+	void AddFrame(float frameTime, float frameBudget)
+	{
+		if (frameTime <= 0.0f || frameBudget <= 0.0f)
+			return;
+
+		float load = frameTime / frameBudget;
+		if (m_Load <= 0.0f)
+			m_Load = load;
+		else
+			m_Load += (load > m_Load ? REV_PERF_SCALE_ALPHA_UP : REV_PERF_SCALE_ALPHA_DOWN) * (load - m_Load);
+
+		// Only report a new scale when the estimate moved far enough, so the app doesn't oscillate
+		float estimate = std::min(std::max(REV_PERF_SCALE_TARGET / m_Load, REV_PERF_SCALE_MIN), REV_PERF_SCALE_MAX);
+		float scale = m_Scale.load(std::memory_order_relaxed);
+		if (fabsf(estimate - scale) > REV_PERF_SCALE_HYSTERESIS * scale)
+			m_Scale.store(estimate, std::memory_order_relaxed);
+	}
+
+	float GetScale() const { return m_Scale.load(std::memory_order_relaxed); }
+
+private:
+	float m_Load;
+	std::atomic<float> m_Scale;
+};
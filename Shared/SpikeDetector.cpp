@@ -0,0 +1,200 @@
+#include "SpikeDetector.h"
+#include "TraceRecorder.h"
+#include "microprofile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <chrono>
+#endif
+
+SpikeDetector::SpikeDetector()
+	: SpikeDetector(getenv("REVIVE_SPIKE_FILE"), REV_SPIKE_DEFAULT_PERCENTILE)
+{
+	const char* percentile = getenv("REVIVE_SPIKE_PERCENTILE");
+	if (percentile)
+	{
+		double value = atof(percentile);
+		if (value > 0.0 && value < 100.0)
+			m_Percentile = value;
+	}
+}
+
+SpikeDetector::SpikeDetector(const char* path, double percentile)
+	: m_Enabled(false)
+	, m_Path()
+	, m_Percentile(percentile)
+	, m_Frequency(GetFrequency())
+	, m_Frames()
+	, m_FrameCount(0)
+	, m_LastEnd(0)
+	, m_Commits(0)
+	, m_TrackingQueries(0)
+	, m_InputQueries(0)
+	, m_Intervals()
+	, m_IntervalCount(0)
+	, m_Threshold(0)
+	, m_Cooldown(0)
+	, m_Captures(0)
+	, m_Capture()
+	, m_Writing(false)
+{
+	for (std::atomic_int64_t& time : m_CallTime)
+		time = 0;
+
+	if (path && path[0] != '\0' && strlen(path) < sizeof(m_Path) - 8)
+	{
+		strcpy(m_Path, path);
+		m_Enabled = true;
+	}
+}
+
+SpikeDetector::~SpikeDetector()
+{
+	Flush();
+}
+
+void SpikeDetector::Flush()
+{
+	if (m_Writer.joinable())
+		m_Writer.join();
+}
+
+int64_t SpikeDetector::GetTimestamp()
+{
+#ifdef _WIN32
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int64_t SpikeDetector::GetFrequency()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return freq.QuadPart;
+#else
+	return 1000000000;
+#endif
+}
+
+uint32_t SpikeDetector::ToMicroseconds(int64_t ticks) const
+{
+	return (uint32_t)std::min(ticks * 1000000 / m_Frequency, (int64_t)UINT32_MAX);
+}
+
+void SpikeDetector::AddCallTime(Call call, int64_t begin, int64_t end)
+{
+	m_CallTime[call] += end - begin;
+}
+
+bool SpikeDetector::EndFrame(long long frameIndex, unsigned int layerCount, int64_t end)
+{
+	if (!m_Enabled)
+		return false;
+
+	uint32_t interval = m_LastEnd ? ToMicroseconds(end - m_LastEnd) : 0;
+	m_LastEnd = end;
+
+	SpikeFrame& frame = m_Frames[m_FrameCount++ % REV_SPIKE_FRAMES];
+	frame.FrameIndex = frameIndex;
+	frame.Interval = interval;
+	frame.WaitTime = ToMicroseconds(m_CallTime[CALL_WAIT].exchange(0));
+	frame.BeginTime = ToMicroseconds(m_CallTime[CALL_BEGIN].exchange(0));
+	frame.EndTime = ToMicroseconds(m_CallTime[CALL_END].exchange(0));
+	frame.Layers = (uint16_t)layerCount;
+	frame.Commits = (uint16_t)std::min(m_Commits.exchange(0), (uint32_t)UINT16_MAX);
+	frame.TrackingQueries = (uint16_t)std::min(m_TrackingQueries.exchange(0), (uint32_t)UINT16_MAX);
+	frame.InputQueries = (uint16_t)std::min(m_InputQueries.exchange(0), (uint32_t)UINT16_MAX);
+
+	if (interval == 0)
+		return false;
+
+	// Compare against the threshold before the interval is added, so a spike doesn't raise it
+	bool spike = false;
+	if (m_Cooldown > 0)
+		m_Cooldown--;
+	else if (m_Threshold > 0 && interval > m_Threshold * REV_SPIKE_MARGIN)
+	{
+		MICROPROFILE_COUNTER_ADD("Compositor/FrameSpikes", 1);
+		spike = Capture();
+		TraceRecorder::Get().DumpAsync("Spike");
+		m_Cooldown = REV_SPIKE_COOLDOWN_FRAMES;
+	}
+
+	m_Intervals[m_IntervalCount++ % REV_SPIKE_WINDOW] = interval;
+	if (m_IntervalCount >= REV_SPIKE_MIN_FRAMES && m_IntervalCount % REV_SPIKE_UPDATE_FRAMES == 0)
+		UpdateThreshold();
+	return spike;
+}
+
+void SpikeDetector::UpdateThreshold()
+{
+	uint32_t intervals[REV_SPIKE_WINDOW];
+	size_t count = (size_t)std::min(m_IntervalCount, (uint64_t)REV_SPIKE_WINDOW);
+	memcpy(intervals, m_Intervals, count * sizeof(uint32_t));
+
+	size_t rank = std::min((size_t)(count * m_Percentile / 100.0), count - 1);
+	std::nth_element(intervals, intervals + rank, intervals + count);
+	m_Threshold = intervals[rank];
+}
+
+bool SpikeDetector::Capture()
+{
+	// Skip the capture if the previous one is still being written
+	if (m_Writing.exchange(true, std::memory_order_acquire))
+		return false;
+	if (m_Writer.joinable())
+		m_Writer.join();
+
+	SpikeFileHeader header;
+	header.Magic = REV_SPIKE_FILE_MAGIC;
+	header.Version = REV_SPIKE_FILE_VERSION;
+	header.FrameSize = sizeof(SpikeFrame);
+	header.FrameCount = (uint32_t)std::min(m_FrameCount, (uint64_t)REV_SPIKE_FRAMES);
+	header.Threshold = m_Threshold;
+
+	// Copy the ring buffer oldest frame first, the file is written on a background thread
+	uint64_t first = m_FrameCount - header.FrameCount;
+	for (uint64_t i = first; i < m_FrameCount; i++)
+		m_Capture[i - first] = m_Frames[i % REV_SPIKE_FRAMES];
+
+	uint32_t capture = m_Captures++;
+	m_Writer = std::thread([this, header, capture]()
+	{
+		Write(header, capture);
+		m_Writing.store(false, std::memory_order_release);
+	});
+	return true;
+}
+
+bool SpikeDetector::Write(const SpikeFileHeader& header, uint32_t capture)
+{
+	// Every capture after the first gets a numbered file, so it doesn't overwrite an earlier capture
+	char path[sizeof(m_Path)];
+	strcpy(path, m_Path);
+	if (capture > 0)
+	{
+		const char* ext = strrchr(m_Path, '.');
+		if (!ext || strpbrk(ext, "\\/"))
+			ext = m_Path + strlen(m_Path);
+		snprintf(path + (ext - m_Path), sizeof(path) - (ext - m_Path), ".%u%s", capture, ext);
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(m_Capture, sizeof(SpikeFrame), header.FrameCount, file);
+	return fclose(file) == 0;
+}
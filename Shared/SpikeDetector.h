@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <stdint.h>
+
+// Number of frames written to a capture
+#define REV_SPIKE_FRAMES 256
+// Number of frame intervals in the rolling distribution, must be a power of two
+#define REV_SPIKE_WINDOW 512
+// Minimum number of intervals to measure before detecting spikes
+#define REV_SPIKE_MIN_FRAMES 90
+// Number of frames between updates of the percentile threshold
+#define REV_SPIKE_UPDATE_FRAMES 30
+// Number of frames to wait after a capture before capturing again
+#define REV_SPIKE_COOLDOWN_FRAMES 900
+// Factor by which an interval has to exceed the percentile to count as a spike
+#define REV_SPIKE_MARGIN 1.25
+#define REV_SPIKE_DEFAULT_PERCENTILE 99.0
+
+// Capture files are little-endian and consist of a SpikeFileHeader followed by FrameCount
+// SpikeFrame records, oldest frame first. All times are in microseconds.
+#define REV_SPIKE_FILE_MAGIC 0x50535652 // 'RVSP'
+#define REV_SPIKE_FILE_VERSION 1
+
+struct SpikeFileHeader
+{
+	uint32_t Magic;
+	uint16_t Version;
+	uint16_t FrameSize;
+	uint32_t FrameCount;
+	uint32_t Threshold;
+};
+
+struct SpikeFrame
+{
+	int64_t FrameIndex;
+	uint32_t Interval;		// Time since the previous frame was submitted
+	uint32_t WaitTime;		// Time spent in ovr_WaitToBeginFrame
+	uint32_t BeginTime;		// Time spent in ovr_BeginFrame
+	uint32_t EndTime;		// Time spent in ovr_EndFrame
+	uint16_t Layers;
+	uint16_t Commits;		// Calls to ovr_CommitTextureSwapChain
+	uint16_t TrackingQueries;	// Calls to ovr_GetTrackingState
+	uint16_t InputQueries;	// Calls to ovr_GetInputState
+};
+
+// Keeps a rolling distribution of the frame intervals and captures the timing of the last frames
+// to a file when an interval exceeds the configured percentile. The detector is only enabled when
+// the REVIVE_SPIKE_FILE environment variable is set, REVIVE_SPIKE_PERCENTILE sets the percentile.
+// The frames are copied on the calling thread, the file is written on a background thread.
+class SpikeDetector
+{
+public:
+	enum Call
+	{
+		CALL_WAIT,
+		CALL_BEGIN,
+		CALL_END,
+		CALL_COUNT
+	};
+
+	SpikeDetector();
+	SpikeDetector(const char* path, double percentile);
+	~SpikeDetector();
+
+	bool IsEnabled() const { return m_Enabled; }
+	static int64_t GetTimestamp();
+	static int64_t GetFrequency();
+
+	void CountCommit() { if (m_Enabled) m_Commits++; }
+	void CountTrackingQuery() { if (m_Enabled) m_TrackingQueries++; }
+	void CountInputQuery() { if (m_Enabled) m_InputQueries++; }
+
+	void AddCallTime(Call call, int64_t begin, int64_t end);
+	// Returns true if the frame was a spike and a capture was started
+	bool EndFrame(long long frameIndex, unsigned int layerCount, int64_t end);
+	// Waits until the capture that is being written is finished
+	void Flush();
+
+private:
+	uint32_t ToMicroseconds(int64_t ticks) const;
+	void UpdateThreshold();
+	bool Capture();
+	bool Write(const SpikeFileHeader& header, uint32_t capture);
+
+	bool m_Enabled;
+	char m_Path[260];
+	double m_Percentile;
+	int64_t m_Frequency;
+
+	// Frame history
+	SpikeFrame m_Frames[REV_SPIKE_FRAMES];
+	uint64_t m_FrameCount;
+	std::atomic_int64_t m_CallTime[CALL_COUNT];
+	int64_t m_LastEnd;
+	std::atomic_uint32_t m_Commits;
+	std::atomic_uint32_t m_TrackingQueries;
+	std::atomic_uint32_t m_InputQueries;
+
+	// Interval distribution in microseconds
+	uint32_t m_Intervals[REV_SPIKE_WINDOW];
+	uint64_t m_IntervalCount;
+	uint32_t m_Threshold;
+	uint32_t m_Cooldown;
+	uint32_t m_Captures;
+
+	// Capture that is being written
+	SpikeFrame m_Capture[REV_SPIKE_FRAMES];
+	std::atomic_bool m_Writing;
+	std::thread m_Writer;
+};
+
+class SpikeScope
+{
+public:
+	SpikeScope(SpikeDetector& detector, SpikeDetector::Call call, long long frameIndex = 0, unsigned int layerCount = 0)
+		: m_Detector(detector)
+		, m_Call(call)
+		, m_FrameIndex(frameIndex)
+		, m_LayerCount(layerCount)
+		, m_Begin(detector.IsEnabled() ? SpikeDetector::GetTimestamp() : 0)
+	{
+	}
+
+	~SpikeScope()
+	{
+		if (!m_Begin)
+			return;
+
+		int64_t end = SpikeDetector::GetTimestamp();
+		m_Detector.AddCallTime(m_Call, m_Begin, end);
+		if (m_Call == SpikeDetector::CALL_END)
+			m_Detector.EndFrame(m_FrameIndex, m_LayerCount, end);
+	}
+
+private:
+	SpikeDetector& m_Detector;
+	SpikeDetector::Call m_Call;
+	long long m_FrameIndex;
+	unsigned int m_LayerCount;
+	int64_t m_Begin;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// Number of buckets, the last one counts everything from about a second up
+#define REV_HISTOGRAM_BUCKETS 22
+
+// Lock-less histogram of durations in power-of-two buckets: bucket 0 counts durations below 1 us
+// and bucket i counts durations from 2^(i-1) up to 2^i us.
+class TimingHistogram
+{
+public:
+	TimingHistogram() { Reset(); }
+
+	void Reset()
+	{
+		for (std::atomic_uint64_t& bucket : m_Buckets)
+			bucket.store(0, std::memory_order_relaxed);
+	}
+
+	static int GetBucket(int64_t microseconds)
+	{
+		int bucket = 0;
+		while (bucket < REV_HISTOGRAM_BUCKETS - 1 && microseconds >= (1ll << bucket))
+			bucket++;
+		return bucket;
+	}
+
+	// Upper bound of the bucket in microseconds, the last bucket has no upper bound
+	static int64_t GetBucketLimit(int bucket) { return 1ll << bucket; }
+
+	void Add(int64_t microseconds) { m_Buckets[GetBucket(microseconds)].fetch_add(1, std::memory_order_relaxed); }
+	uint64_t GetCount(int bucket) const { return m_Buckets[bucket].load(std::memory_order_relaxed); }
+
+	uint64_t GetTotal() const
+	{
+		uint64_t total = 0;
+		for (int i = 0; i < REV_HISTOGRAM_BUCKETS; i++)
+			total += GetCount(i);
+		return total;
+	}
+
+	// Upper bound of the bucket that contains the percentile, in microseconds
+	int64_t GetPercentile(double percentile) const
+	{
+		uint64_t total = GetTotal();
+		uint64_t rank = (uint64_t)(total * percentile / 100.0);
+		uint64_t count = 0;
+		for (int i = 0; i < REV_HISTOGRAM_BUCKETS; i++)
+		{
+			count += GetCount(i);
+			if (count > rank)
+				return GetBucketLimit(i);
+		}
+		return GetBucketLimit(REV_HISTOGRAM_BUCKETS - 1);
+	}
+
+	// Summary followed by a line for every bucket from the first to the last non-empty one
+	std::string Format(const char* name) const
+	{
+		int first = 0, last = REV_HISTOGRAM_BUCKETS - 1;
+		while (first < last && GetCount(first) == 0)
+			first++;
+		while (last > first && GetCount(last) == 0)
+			last--;
+
+		char line[128];
+		snprintf(line, sizeof(line), "%s: %llu samples, p50 < %lld us, p99 < %lld us\n", name,
+			(unsigned long long)GetTotal(), (long long)GetPercentile(50.0), (long long)GetPercentile(99.0));
+		std::string out = line;
+		for (int i = first; i <= last; i++)
+		{
+			if (i < REV_HISTOGRAM_BUCKETS - 1)
+				snprintf(line, sizeof(line), "  < %8lld us: %llu\n", (long long)GetBucketLimit(i), (unsigned long long)GetCount(i));
+			else
+				snprintf(line, sizeof(line), "  >= %7lld us: %llu\n", (long long)GetBucketLimit(i - 1), (unsigned long long)GetCount(i));
+			out += line;
+		}
+		return out;
+	}
+
+private:
+	std::atomic_uint64_t m_Buckets[REV_HISTOGRAM_BUCKETS];
+};
@@ -0,0 +1,187 @@
+#include "TraceRecorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <chrono>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+TraceRecorder& TraceRecorder::Get()
+{
+	static TraceRecorder instance;
+	return instance;
+}
+
+TraceRecorder::TraceRecorder()
+	: m_Enabled(false)
+	, m_Path()
+	, m_Frequency(0)
+	, m_Index(0)
+	, m_Dumps(0)
+	, m_Events()
+	, m_Snapshot()
+	, m_Writing(false)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	m_Frequency = freq.QuadPart;
+#else
+	m_Frequency = 1000000000;
+#endif
+
+	const char* path = getenv("REVIVE_TRACE_FILE");
+	if (path && path[0] != '\0' && strlen(path) < sizeof(m_Path) - 8)
+	{
+		strcpy(m_Path, path);
+		m_Events.reset(new Event[REV_TRACE_EVENTS]);
+		for (size_t i = 0; i < REV_TRACE_EVENTS; i++)
+			m_Events[i].Sequence = 0;
+		m_Snapshot.reset(new EventData[REV_TRACE_EVENTS]);
+		m_Enabled = true;
+	}
+}
+
+TraceRecorder::~TraceRecorder()
+{
+	if (m_Writer.joinable())
+		m_Writer.join();
+}
+
+int64_t TraceRecorder::GetTimestamp() const
+{
+#ifdef _WIN32
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static uint32_t CurrentThreadId()
+{
+#ifdef _WIN32
+	return GetCurrentThreadId();
+#else
+	return (uint32_t)syscall(SYS_gettid);
+#endif
+}
+
+static unsigned long CurrentProcessId()
+{
+#ifdef _WIN32
+	return GetCurrentProcessId();
+#else
+	return (unsigned long)getpid();
+#endif
+}
+
+void TraceRecorder::AddEvent(const char* name, int64_t begin, int64_t end)
+{
+	if (!m_Enabled)
+		return;
+
+	uint64_t index = m_Index.fetch_add(1, std::memory_order_relaxed);
+	Event& e = m_Events[index & (REV_TRACE_EVENTS - 1)];
+
+	// Mark the slot as incomplete so a concurrent dump will skip it
+	e.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	e.Data.Name = name;
+	e.Data.ThreadId = CurrentThreadId();
+	e.Data.Begin = begin;
+	e.Data.End = end;
+	e.Sequence.store(index + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::Dump(const char* reason)
+{
+	if (!m_Enabled)
+		return false;
+
+	// Wait for a background dump to finish, it uses the same snapshot
+	std::lock_guard<std::mutex> lock(m_WriterMutex);
+	if (m_Writer.joinable())
+		m_Writer.join();
+	return Write(reason, Snapshot());
+}
+
+bool TraceRecorder::DumpAsync(const char* reason)
+{
+	if (!m_Enabled)
+		return false;
+
+	// Never block the calling thread, it's usually the render thread that just had a spike
+	std::unique_lock<std::mutex> lock(m_WriterMutex, std::try_to_lock);
+	if (!lock.owns_lock() || m_Writing.load(std::memory_order_acquire))
+		return false;
+	if (m_Writer.joinable())
+		m_Writer.join();
+
+	size_t count = Snapshot();
+	m_Writing.store(true, std::memory_order_relaxed);
+	m_Writer = std::thread([this, reason, count]()
+	{
+		Write(reason, count);
+		m_Writing.store(false, std::memory_order_release);
+	});
+	return true;
+}
+
+size_t TraceRecorder::Snapshot()
+{
+	// Copy the ring buffer so the events keep flowing while we write the file
+	uint64_t end = m_Index.load(std::memory_order_acquire);
+	uint64_t begin = end > REV_TRACE_EVENTS ? end - REV_TRACE_EVENTS : 0;
+	size_t count = 0;
+	for (uint64_t i = begin; i < end; i++)
+	{
+		const Event& e = m_Events[i & (REV_TRACE_EVENTS - 1)];
+		uint64_t seq = e.Sequence.load(std::memory_order_acquire);
+		m_Snapshot[count] = e.Data;
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// Skip events that were being written or overwritten while we copied them
+		if (seq == i + 1 && e.Sequence.load(std::memory_order_relaxed) == seq)
+			count++;
+	}
+	return count;
+}
+
+bool TraceRecorder::Write(const char* reason, size_t count)
+{
+	// Every dump after the first gets a numbered file, so a spike doesn't overwrite an earlier capture
+	char path[sizeof(m_Path)];
+	uint32_t dump = m_Dumps++;
+	strcpy(path, m_Path);
+	if (dump > 0)
+	{
+		const char* ext = strrchr(m_Path, '.');
+		if (!ext || strpbrk(ext, "\\/"))
+			ext = m_Path + strlen(m_Path);
+		snprintf(path + (ext - m_Path), sizeof(path) - (ext - m_Path), ".%u%s", dump, ext);
+	}
+
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	unsigned long pid = CurrentProcessId();
+	double scale = 1000000.0 / m_Frequency;
+	fprintf(file, "{\"otherData\":{\"reason\":\"%s\"},\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", reason);
+	for (size_t i = 0; i < count; i++)
+	{
+		const EventData& e = m_Snapshot[i];
+		fprintf(file, "{\"name\":\"%s\",\"cat\":\"Revive\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%u}%s\n",
+			e.Name, e.Begin * scale, (e.End - e.Begin) * scale, pid, e.ThreadId, i + 1 < count ? "," : "");
+	}
+	fprintf(file, "]}\n");
+	return fclose(file) == 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+
+// Number of events kept in the ring buffer, must be a power of two
+#define REV_TRACE_EVENTS 16384
+
+// Records the timing of the traced API calls into a lock-free ring buffer that can be exported
+// as a Chrome trace (JSON), which can be opened in chrome://tracing or the Perfetto UI.
+// The recorder is only enabled when the REVIVE_TRACE_FILE environment variable is set, the ring
+// buffer isn't allocated otherwise.
+class TraceRecorder
+{
+public:
+	static TraceRecorder& Get();
+	~TraceRecorder();
+
+	bool IsEnabled() const { return m_Enabled; }
+	int64_t GetTimestamp() const;
+
+	void AddEvent(const char* name, int64_t begin, int64_t end);
+
+	// Writes the events currently in the ring buffer to the trace file, returns false on failure
+	bool Dump(const char* reason);
+	// Copies the events currently in the ring buffer and writes them on a background thread,
+	// returns false if the recorder is disabled or busy with an earlier dump
+	bool DumpAsync(const char* reason);
+
+private:
+	TraceRecorder();
+
+	struct EventData
+	{
+		const char* Name;
+		uint32_t ThreadId;
+		int64_t Begin;
+		int64_t End;
+	};
+
+	struct Event
+	{
+		// Index of the event plus one, zero while the event is being written
+		std::atomic_uint64_t Sequence;
+		EventData Data;
+	};
+
+	bool m_Enabled;
+	char m_Path[260];
+	int64_t m_Frequency;
+	std::atomic_uint64_t m_Index;
+	std::atomic_uint32_t m_Dumps;
+	std::unique_ptr<Event[]> m_Events;
+
+	size_t Snapshot();
+	bool Write(const char* reason, size_t count);
+
+	// Copy of the ring buffer that is being written
+	std::unique_ptr<EventData[]> m_Snapshot;
+	std::mutex m_WriterMutex;
+	std::atomic_bool m_Writing;
+	std::thread m_Writer;
+};
+
+class TraceScope
+{
+public:
+	TraceScope(const char* name)
+		: m_Name(name)
+		, m_Begin(TraceRecorder::Get().IsEnabled() ? TraceRecorder::Get().GetTimestamp() : 0)
+	{
+	}
+
+	~TraceScope()
+	{
+		if (m_Begin)
+			TraceRecorder::Get().AddEvent(m_Name, m_Begin, TraceRecorder::Get().GetTimestamp());
+	}
+
+private:
+	const char* m_Name;
+	int64_t m_Begin;
+};
+
+// Traces the enclosing scope, use it next to the microprofile scopes that aren't API calls
+#define REV_TRACE_SCOPE(x) TraceScope traceScope_##x(#x)
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+// Single-entry cache of the last tracking state keyed on the requested time and tracking space.
+// Lock-less sequence lock: a reader that races with a writer simply treats the lookup as a miss,
+// and a writer that races with another writer skips the store.
+// The entry is stored as relaxed atomic words, so a racing reader never touches non-atomic memory.
+template<typename State>
+class TrackingCache
+{
+public:
+	TrackingCache() : m_Epoch(1), m_Sequence(0), m_Writing(false)
+	{
+		for (std::atomic_uint64_t& word : m_Words)
+			word.store(0, std::memory_order_relaxed);
+	}
+
+	// Returns the current epoch, callers must sample it before computing a state they want to store
+	uint32_t Epoch() const { return m_Epoch.load(std::memory_order_acquire); }
+
+	// Drops the cached state, typically called when a new frame begins
+	void Invalidate() { m_Epoch.fetch_add(1, std::memory_order_acq_rel); }
+
+	bool Get(int64_t time, uint64_t space, State* outState) const
+	{
+		uint32_t seq = m_Sequence.load(std::memory_order_acquire);
+		if (seq & 1)
+			return false;
+
+		uint64_t words[WordCount];
+		for (size_t i = 0; i < WordCount; i++)
+			words[i] = m_Words[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_Sequence.load(std::memory_order_relaxed) != seq)
+			return false;
+
+		Entry entry;
+		memcpy(&entry, words, sizeof(Entry));
+		if (entry.Epoch != Epoch() || entry.Time != time || entry.Space != space)
+			return false;
+
+		*outState = entry.Value;
+		return true;
+	}
+
+	void Put(uint32_t epoch, int64_t time, uint64_t space, const State& state)
+	{
+		if (m_Writing.exchange(true, std::memory_order_acquire))
+			return;
+
+		uint64_t words[WordCount] = {};
+		Entry entry = { epoch, time, space, state };
+		memcpy(words, &entry, sizeof(Entry));
+
+		uint32_t seq = m_Sequence.load(std::memory_order_relaxed);
+		m_Sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t i = 0; i < WordCount; i++)
+			m_Words[i].store(words[i], std::memory_order_relaxed);
+
+		m_Sequence.store(seq + 2, std::memory_order_release);
+		m_Writing.store(false, std::memory_order_release);
+	}
+
+private:
+	struct Entry
+	{
+		uint32_t Epoch;
+		int64_t Time;
+		uint64_t Space;
+		State Value;
+	};
+
+	static const size_t WordCount = (sizeof(Entry) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	std::atomic_uint32_t m_Epoch;
+	std::atomic_uint32_t m_Sequence;
+	std::atomic_bool m_Writing;
+	std::atomic_uint64_t m_Words[WordCount];
+};
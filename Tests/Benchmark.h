@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// Minimal benchmark harness, every benchmark is run several times and the runs are reported
+// separately so noisy results stand out. A benchmark runs the given number of iterations.
+// The heap allocations per iteration are reported as well, setup allocations included.
+typedef void (*BenchmarkFunc)(uint64_t iterations);
+
+struct BenchmarkCase
+{
+	const char* Name;
+	BenchmarkFunc Func;
+	uint64_t Iterations;
+	BenchmarkCase* Next;
+};
+
+bool RegisterBenchmark(BenchmarkCase* benchmark);
+
+#define BENCHMARK(name, count) \
+	static void name(uint64_t); \
+	static BenchmarkCase name##Case = { #name, name, count, nullptr }; \
+	static const bool name##Registered = RegisterBenchmark(&name##Case); \
+	static void name(uint64_t iterations)
+
+// Keeps the compiler from optimizing away a result
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+	volatile const T* sink = &value;
+	(void)sink;
+}
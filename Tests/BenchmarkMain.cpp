@@ -0,0 +1,123 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define REV_BENCHMARK_RUNS 5
+
+static BenchmarkCase* s_Benchmarks = nullptr;
+static std::atomic_uint64_t s_Allocations(0);
+
+// Count every heap allocation, so the hot paths can be shown not to allocate
+void* operator new(size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+bool RegisterBenchmark(BenchmarkCase* benchmark)
+{
+	benchmark->Next = s_Benchmarks;
+	s_Benchmarks = benchmark;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	// Benchmarks register in reverse order, so run them back to front
+	BenchmarkCase* benchmarks = nullptr;
+	while (s_Benchmarks)
+	{
+		BenchmarkCase* next = s_Benchmarks->Next;
+		s_Benchmarks->Next = benchmarks;
+		benchmarks = s_Benchmarks;
+		s_Benchmarks = next;
+	}
+
+	// The optional argument only runs the benchmarks that contain it in their name,
+	// --json also writes the results to a file so runs can be compared by scripts
+	const char* filter = nullptr;
+	const char* jsonPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+		else
+			filter = argv[i];
+	}
+
+	FILE* json = nullptr;
+	if (jsonPath)
+	{
+		json = fopen(jsonPath, "w");
+		if (!json)
+		{
+			fprintf(stderr, "Failed to open %s\n", jsonPath);
+			return 1;
+		}
+		fprintf(json, "{\n  \"runs\": %d,\n  \"benchmarks\": [", REV_BENCHMARK_RUNS);
+	}
+
+	bool first = true;
+	for (BenchmarkCase* benchmark = benchmarks; benchmark; benchmark = benchmark->Next)
+	{
+		if (filter && !strstr(benchmark->Name, filter))
+			continue;
+
+		// Warm up the caches before the measured runs
+		benchmark->Func(std::max(benchmark->Iterations / 10, (uint64_t)1));
+
+		std::vector<double> runs;
+		runs.reserve(REV_BENCHMARK_RUNS);
+		uint64_t allocations = s_Allocations.load();
+		for (int i = 0; i < REV_BENCHMARK_RUNS; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			benchmark->Func(benchmark->Iterations);
+			std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			runs.push_back(elapsed.count() / benchmark->Iterations);
+		}
+		allocations = s_Allocations.load() - allocations;
+
+		std::sort(runs.begin(), runs.end());
+		double allocsPerIteration = (double)allocations / (benchmark->Iterations * REV_BENCHMARK_RUNS);
+		printf("%-40s min %10.1f ns  median %10.1f ns  max %10.1f ns  %8.3f allocs\n", benchmark->Name,
+			runs.front(), runs[runs.size() / 2], runs.back(), allocsPerIteration);
+
+		// The names are identifiers, so they never need to be escaped
+		if (json)
+		{
+			fprintf(json, "%s\n    { \"name\": \"%s\", \"iterations\": %llu, \"min_ns\": %.1f, \"median_ns\": %.1f, "
+				"\"max_ns\": %.1f, \"allocs_per_iteration\": %.3f }", first ? "" : ",", benchmark->Name,
+				(unsigned long long)benchmark->Iterations, runs.front(), runs[runs.size() / 2], runs.back(),
+				allocsPerIteration);
+		}
+		first = false;
+	}
+
+	if (json)
+	{
+		fprintf(json, "\n  ]\n}\n");
+		fclose(json);
+	}
+	return 0;
+}
@@ -0,0 +1,291 @@
+#include "Test.h"
+#include "Compatibility.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* HackNames[] = { "HACK_A", "HACK_B", "HACK_C" };
+static const int HackCount = sizeof(HackNames) / sizeof(HackNames[0]);
+
+static bool GetProfile(const char* json, const char* filename, const char* target, CompatibilityProfile* out)
+{
+	JsonValue root;
+	std::vector<std::string> errors;
+	if (!JsonValue::Parse(json, &root))
+		return false;
+	bool valid = GetCompatibilityProfile(root, filename, target, HackNames, HackCount, out, &errors);
+	return valid && errors.empty();
+}
+
+static bool LoadFile(const char* path, const char* json, JsonValue* out, std::vector<std::string>* errors)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+	fputs(json, file);
+	fclose(file);
+
+	bool loaded = LoadCompatibilityFile(out, errors);
+	remove(path);
+	return loaded;
+}
+
+static void SetCompatibilityFile(const char* path)
+{
+#ifdef _WIN32
+	_putenv_s("REVIVE_COMPAT_FILE", path);
+#else
+	setenv("REVIVE_COMPAT_FILE", path, 1);
+#endif
+}
+
+TEST(Compatibility_HackOverrides)
+{
+	JsonValue root;
+	CHECK(JsonValue::Parse("{ \"hacks\": ["
+		"{ \"filename\": \"game.exe\", \"target\": \"lighthouse\", \"hack\": \"HACK_A\", \"versionStart\": \"1.2.3\" },"
+		"{ \"hack\": \"HACK_B\", \"enabled\": false } ] }", &root));
+
+	std::vector<std::string> errors;
+	std::vector<HackOverride> overrides = GetHackOverrides(root, HackNames, HackCount, &errors);
+	CHECK(errors.empty());
+	CHECK(overrides.size() == 2);
+	CHECK(overrides[0].Filename == "game.exe");
+	CHECK(overrides[0].Target == "lighthouse");
+	CHECK(overrides[0].Hack == "HACK_A");
+	CHECK(overrides[0].VersionStart == ((1ull << 48) | (2ull << 32) | 3));
+	CHECK(overrides[0].VersionEnd == 0);
+	CHECK(overrides[0].UseHack);
+	CHECK(overrides[1].Filename.empty());
+	CHECK(!overrides[1].UseHack);
+
+	JsonValue empty;
+	CHECK(JsonValue::Parse("{}", &empty));
+	CHECK(GetHackOverrides(empty, HackNames, HackCount, &errors).empty());
+	CHECK(errors.empty());
+}
+
+TEST(Compatibility_InvalidHackOverrides)
+{
+	// Invalid entries are skipped and reported, the valid ones still apply
+	const char* invalid[] =
+	{
+		"{ \"filename\": \"nohack.exe\" }",
+		"{ \"hack\": \"HACK_UNKNOWN\" }",
+		"{ \"hack\": \"HACK_A\", \"enabled\": 1 }",
+		"{ \"hack\": \"HACK_A\", \"versionStart\": \"latest\" }",
+		"{ \"hack\": \"HACK_A\", \"filename\": 1 }",
+		"{ \"hack\": \"HACK_A\", \"unknown\": true }",
+		"\"HACK_A\"",
+	};
+	for (const char* entry : invalid)
+	{
+		std::string json = std::string("{ \"hacks\": [ { \"hack\": \"HACK_C\" }, ") + entry + " ] }";
+		JsonValue root;
+		CHECK(JsonValue::Parse(json.c_str(), &root));
+
+		std::vector<std::string> errors;
+		std::vector<HackOverride> overrides = GetHackOverrides(root, HackNames, HackCount, &errors);
+		CHECK(overrides.size() == 1);
+		CHECK(overrides[0].Hack == "HACK_C");
+		CHECK(errors.size() == 1);
+		CHECK(errors[0].compare(0, 9, "hacks[1]:") == 0);
+	}
+}
+
+TEST(Compatibility_ProfileMatching)
+{
+	const char* json = "{ \"profiles\": ["
+		"{ \"filename\": \"Game.exe\", \"hacks\": [ \"HACK_A\", \"HACK_B\" ], \"predictionOffset\": 2.0 },"
+		"{ \"filename\": \"game.exe\", \"target\": \"Oculus\", \"disabledHacks\": [ \"HACK_B\" ], \"framePacing\": true },"
+		"{ \"filename\": \"other.exe\", \"hacks\": [ \"HACK_C\" ] } ] }";
+
+	// Filenames match case-insensitively, later profiles take precedence
+	CompatibilityProfile profile;
+	CHECK(GetProfile(json, "game.exe", "Oculus", &profile));
+	CHECK(profile.EnabledHacks == 1);
+	CHECK(profile.DisabledHacks == 2);
+	CHECK(profile.PredictionOffset == 0.002);
+	CHECK(profile.FramePacing);
+	CHECK(!profile.OverrideHaptics);
+
+	// Profiles with a target only apply to that driver or runtime
+	profile = CompatibilityProfile();
+	CHECK(GetProfile(json, "GAME.EXE", "SteamVR", &profile));
+	CHECK(profile.EnabledHacks == 3);
+	CHECK(profile.DisabledHacks == 0);
+	CHECK(!profile.FramePacing);
+
+	profile = CompatibilityProfile();
+	CHECK(GetProfile(json, "unknown.exe", "SteamVR", &profile));
+	CHECK(profile.EnabledHacks == 0);
+	CHECK(profile.PredictionOffset == 0.0);
+}
+
+TEST(Compatibility_Haptics)
+{
+	CompatibilityProfile profile;
+	CHECK(GetProfile("{ \"profiles\": [ { \"filename\": \"game.exe\", \"haptics\": "
+		"{ \"blockSamples\": 4, \"maxSamples\": 32, \"tolerance\": 16, \"useFrequency\": true } } ] }",
+		"game.exe", "", &profile));
+	CHECK(profile.OverrideHaptics);
+	CHECK(profile.Haptics.BlockSamples == 4);
+	CHECK(profile.Haptics.MaxSamples == 32);
+	CHECK(profile.Haptics.Tolerance == 16);
+	CHECK(profile.Haptics.UseFrequency);
+
+	// Segments can't be longer than the sample buffer, and every field is required
+	const char* invalid[] =
+	{
+		"{ \"blockSamples\": 4, \"maxSamples\": 1000, \"tolerance\": 16, \"useFrequency\": true }",
+		"{ \"blockSamples\": 0, \"maxSamples\": 32, \"tolerance\": 16, \"useFrequency\": true }",
+		"{ \"blockSamples\": 4, \"maxSamples\": 32, \"tolerance\": 300, \"useFrequency\": true }",
+		"{ \"blockSamples\": 4, \"maxSamples\": 32, \"tolerance\": 16 }",
+		"{ \"blockSamples\": 4, \"maxSamples\": 32, \"tolerance\": 16, \"useFrequency\": 1 }",
+	};
+	for (const char* haptics : invalid)
+	{
+		std::string json = std::string("{ \"profiles\": [ { \"filename\": \"game.exe\", \"haptics\": ") + haptics + " } ] }";
+		profile = CompatibilityProfile();
+		CHECK(!GetProfile(json.c_str(), "game.exe", "", &profile));
+		CHECK(!profile.OverrideHaptics);
+	}
+}
+
+TEST(Compatibility_InvalidProfiles)
+{
+	// An invalid profile is ignored as a whole, the valid ones still apply
+	const char* invalid[] =
+	{
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\" ], \"unknown\": 1 }",
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\", \"HACK_UNKNOWN\" ] }",
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\" ], \"predictionOffset\": 100.0 }",
+		"{ \"filename\": \"game.exe\", \"hacks\": \"HACK_A\" }",
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\" ], \"framePacing\": \"yes\" }",
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\" ], \"swapchainDepth\": 2.5 }",
+		"{ \"filename\": \"game.exe\", \"hacks\": [ \"HACK_A\" ], \"swapchainDepth\": 8 }",
+		"{ \"hacks\": [ \"HACK_A\" ] }",
+		"[ \"game.exe\" ]",
+	};
+	for (const char* entry : invalid)
+	{
+		std::string json = std::string("{ \"profiles\": [ ") + entry +
+			", { \"filename\": \"game.exe\", \"hacks\": [ \"HACK_C\" ] } ] }";
+		CompatibilityProfile profile;
+		CHECK(!GetProfile(json.c_str(), "game.exe", "", &profile));
+		CHECK(profile.EnabledHacks == 4);
+		CHECK(profile.PredictionOffset == 0.0);
+		CHECK(!profile.FramePacing);
+		CHECK(profile.SwapchainDepth == 0);
+	}
+
+	// Profiles for other titles are validated as well, so mistakes show up right away
+	CompatibilityProfile profile;
+	CHECK(!GetProfile("{ \"profiles\": [ { \"filename\": \"other.exe\", \"hacks\": [ \"HACK_UNKNOWN\" ] } ] }",
+		"game.exe", "", &profile));
+	CHECK(profile.EnabledHacks == 0);
+}
+
+TEST(Compatibility_SwapchainDepth)
+{
+	CompatibilityProfile profile;
+	CHECK(GetProfile("{ \"profiles\": [ { \"filename\": \"game.exe\", \"swapchainDepth\": 2 } ] }",
+		"game.exe", "", &profile));
+	CHECK(profile.SwapchainDepth == 2);
+
+	profile = CompatibilityProfile();
+	CHECK(!GetProfile("{ \"profiles\": [ { \"filename\": \"game.exe\", \"swapchainDepth\": 1 } ] }",
+		"game.exe", "", &profile));
+	CHECK(profile.SwapchainDepth == 0);
+}
+
+TEST(Compatibility_LoadFile)
+{
+	const char* path = "CompatibilityTest.json";
+	SetCompatibilityFile(path);
+
+	JsonValue root;
+	std::vector<std::string> errors;
+	CHECK(LoadFile(path, "{ \"version\": 1, \"hacks\": [ { \"hack\": \"HACK_A\" } ], \"profiles\": [] }", &root, &errors));
+	CHECK(errors.empty());
+	CHECK(GetHackOverrides(root, HackNames, HackCount, &errors).size() == 1);
+
+	// A missing file isn't an error
+	CHECK(!LoadCompatibilityFile(&root, &errors));
+	CHECK(errors.empty());
+
+	// The version and the top-level members have to match the schema exactly
+	const char* invalid[] =
+	{
+		"{ \"hacks\": [] }",
+		"{ \"version\": 2, \"hacks\": [] }",
+		"{ \"version\": 1.5, \"hacks\": [] }",
+		"{ \"version\": \"1\", \"hacks\": [] }",
+		"{ \"version\": 1, \"hacks\": {} }",
+		"{ \"version\": 1, \"profiles\": \"game.exe\" }",
+		"{ \"version\": 1, \"unknown\": [] }",
+		"[ 1 ]",
+		"{ \"version\": 1, ",
+	};
+	for (const char* json : invalid)
+	{
+		errors.clear();
+		CHECK(!LoadFile(path, json, &root, &errors));
+		CHECK(errors.size() == 1);
+	}
+}
+
+TEST(Compatibility_ApplyOverrides)
+{
+	JsonValue root;
+	CHECK(JsonValue::Parse("{ \"hacks\": ["
+		"{ \"filename\": \"game.exe\", \"hack\": \"HACK_A\" },"
+		"{ \"target\": \"SteamVR\", \"hack\": \"HACK_B\", \"enabled\": false },"
+		"{ \"hack\": \"HACK_C\", \"versionStart\": \"1.2.0\", \"versionEnd\": \"1.3.0\" } ],"
+		"\"profiles\": [ { \"filename\": \"game.exe\", \"target\": \"Oculus\", \"disabledHacks\": [ \"HACK_A\" ] } ] }", &root));
+
+	// Overrides only affect the titles and targets they match, the profiles are applied last
+	std::vector<std::string> errors;
+	CompatibilityProfile profile;
+	uint64_t version = (1ull << 48) | (2ull << 32) | 5;
+	CHECK(ApplyCompatibility(root, 2, "GAME.EXE", "SteamVR", &version, HackNames, HackCount, &profile, &errors) == 5);
+	CHECK(errors.empty());
+
+	profile = CompatibilityProfile();
+	CHECK(ApplyCompatibility(root, 2, "game.exe", "Oculus", &version, HackNames, HackCount, &profile, &errors) == 6);
+	CHECK(errors.empty());
+
+	// The version range includes the start and excludes the end
+	version = 1ull << 48 | (3ull << 32);
+	profile = CompatibilityProfile();
+	CHECK(ApplyCompatibility(root, 0, "other.exe", "Oculus", &version, HackNames, HackCount, &profile, &errors) == 0);
+	version = 1ull << 48 | (2ull << 32);
+	profile = CompatibilityProfile();
+	CHECK(ApplyCompatibility(root, 0, "other.exe", "Oculus", &version, HackNames, HackCount, &profile, &errors) == 4);
+	CHECK(errors.empty());
+
+	// Without a runtime version the range can't be honored, so the override is rejected
+	profile = CompatibilityProfile();
+	CHECK(ApplyCompatibility(root, 0, "game.exe", "lighthouse", nullptr, HackNames, HackCount, &profile, &errors) == 1);
+	CHECK(errors.size() == 1);
+	CHECK(errors[0].compare(0, 9, "hacks[2]:") == 0);
+}
+
+TEST(Compatibility_FileCached)
+{
+	const char* path = "CompatibilityCacheTest.json";
+	SetCompatibilityFile(path);
+	FILE* file = fopen(path, "w");
+	CHECK(file);
+	fputs("{ \"version\": 1, \"hacks\": [ { \"hack\": \"HACK_A\" } ] }", file);
+	fclose(file);
+
+	// The file is only read the first time, later changes aren't picked up
+	std::vector<std::string> errors;
+	const JsonValue* root = GetCompatibilityFile(&errors);
+	remove(path);
+	CHECK(root);
+	CHECK(errors.empty());
+	CHECK(GetCompatibilityFile(&errors) == root);
+	CHECK(GetHackOverrides(*root, HackNames, HackCount, &errors).size() == 1);
+}
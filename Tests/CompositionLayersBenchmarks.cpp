@@ -0,0 +1,114 @@
+#include "Benchmark.h"
+#include "ReviveXR/CompositionLayers.h"
+#include "ReviveXR/SwapChain.h"
+
+#include <memory>
+#include <string.h>
+
+// A frame with an eye layer followed by a mix of quad, cylinder and cube layers, like a title with a HUD
+struct BenchmarkFrame
+{
+	XrSwapchainImageBaseHeader Image;
+	std::unique_ptr<ovrTextureSwapChainData> Chains[ovrMaxLayerCount];
+	ovrLayer_Union Layers[ovrMaxLayerCount];
+	const ovrLayerHeader* LayerPtrs[ovrMaxLayerCount];
+	std::unique_ptr<LayerArena> Arena;
+	LayerTranslationInfo Info;
+
+	BenchmarkFrame()
+		: Image{ XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR, nullptr }
+		, Arena(new LayerArena())
+	{
+		LayerTranslationInfo info = { 25, true, true, true, (XrSpace)(uintptr_t)1, (XrSpace)(uintptr_t)2 };
+		Info = info;
+
+		memset(Layers, 0, sizeof(Layers));
+		for (int i = 0; i < ovrMaxLayerCount; i++)
+		{
+			Chains[i].reset(new ovrTextureSwapChainData());
+			Chains[i]->Desc.Width = 1024;
+			Chains[i]->Desc.Height = 512;
+			Chains[i]->Swapchain = (XrSwapchain)(uintptr_t)(0x100 + i);
+			Chains[i]->Images = &Image;
+
+			ovrLayer_Union& layer = Layers[i];
+			if (i == 0)
+			{
+				layer.EyeFov.Header.Type = ovrLayerType_EyeFov;
+				for (int eye = 0; eye < ovrEye_Count; eye++)
+				{
+					layer.EyeFov.ColorTexture[eye] = Chains[i].get();
+					layer.EyeFov.Viewport[eye] = ovrRecti{ { eye * 512, 0 }, { 512, 512 } };
+					layer.EyeFov.Fov[eye] = ovrFovPort{ 1.0f, 1.0f, 1.0f, 1.0f };
+					layer.EyeFov.RenderPose[eye].Orientation.w = 1.0f;
+				}
+			}
+			else if (i % 4 == 1)
+			{
+				layer.Cylinder.Header.Type = ovrLayerType_Cylinder;
+				layer.Cylinder.ColorTexture = Chains[i].get();
+				layer.Cylinder.Viewport = ovrRecti{ { 0, 0 }, { 1024, 512 } };
+				layer.Cylinder.CylinderPoseCenter.Orientation.w = 1.0f;
+				layer.Cylinder.CylinderRadius = 2.0f;
+				layer.Cylinder.CylinderAngle = 1.5f;
+				layer.Cylinder.CylinderAspectRatio = 2.0f;
+			}
+			else if (i % 4 == 2)
+			{
+				layer.Cube.Header.Type = ovrLayerType_Cube;
+				layer.Cube.Orientation.w = 1.0f;
+				layer.Cube.CubeMapTexture = Chains[i].get();
+			}
+			else
+			{
+				layer.Quad.Header.Type = ovrLayerType_Quad;
+				layer.Quad.ColorTexture = Chains[i].get();
+				layer.Quad.Viewport = ovrRecti{ { 0, 0 }, { 256, 128 } };
+				layer.Quad.QuadPoseCenter.Orientation.w = 1.0f;
+				layer.Quad.QuadPoseCenter.Position.z = -1.0f - i;
+				layer.Quad.QuadSize = ovrVector2f{ 1.0f, 0.5f };
+			}
+			LayerPtrs[i] = &layer.Header;
+		}
+	}
+
+	void Run(uint64_t iterations, unsigned int layerCount, bool moving)
+	{
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			// Moving the quads defeats the layer cache
+			if (moving)
+			{
+				for (unsigned int j = 3; j < layerCount; j += 4)
+					Layers[j].Quad.QuadPoseCenter.Position.x = (float)(i & 0xff);
+			}
+
+			double sampleTime = 0.0;
+			DoNotOptimize(TranslateLayers(*Arena, Info, nullptr, LayerPtrs, layerCount, &sampleTime));
+		}
+	}
+};
+
+BENCHMARK(TranslateLayers_1Layer, 2000000)
+{
+	BenchmarkFrame frame;
+	frame.Run(iterations, 1, false);
+}
+
+BENCHMARK(TranslateLayers_4Layers, 1000000)
+{
+	BenchmarkFrame frame;
+	frame.Run(iterations, 4, false);
+}
+
+BENCHMARK(TranslateLayers_16Layers, 500000)
+{
+	BenchmarkFrame frame;
+	frame.Run(iterations, ovrMaxLayerCount, false);
+}
+
+BENCHMARK(TranslateLayers_16LayersMoving, 500000)
+{
+	BenchmarkFrame frame;
+	frame.Run(iterations, ovrMaxLayerCount, true);
+}
@@ -0,0 +1,365 @@
+#include "Test.h"
+#include "ReviveXR/CompositionLayers.h"
+#include "ReviveXR/SwapChain.h"
+
+#include <math.h>
+#include <memory>
+#include <string.h>
+
+#define TEST_SPACE_VIEW ((XrSpace)(uintptr_t)1)
+#define TEST_SPACE_WORLD ((XrSpace)(uintptr_t)2)
+
+// Swapchains with just enough state for the translation, the images are never touched
+struct TestChains
+{
+	XrSwapchainImageBaseHeader Image;
+	std::unique_ptr<ovrTextureSwapChainData> Chains[ovrMaxLayerCount];
+
+	TestChains(XrStructureType imageType = XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR)
+		: Image{ imageType, nullptr }
+	{
+		for (int i = 0; i < ovrMaxLayerCount; i++)
+		{
+			Chains[i].reset(new ovrTextureSwapChainData());
+			Chains[i]->Desc.Width = 1024;
+			Chains[i]->Desc.Height = 512;
+			Chains[i]->Swapchain = (XrSwapchain)(uintptr_t)(0x100 + i);
+			Chains[i]->Images = &Image;
+		}
+	}
+
+	ovrTextureSwapChain operator[](int i) const { return Chains[i].get(); }
+};
+
+static LayerTranslationInfo TestInfo()
+{
+	LayerTranslationInfo info = { 25, true, true, true, TEST_SPACE_VIEW, TEST_SPACE_WORLD };
+	return info;
+}
+
+static ovrPosef TestPose(float z)
+{
+	ovrPosef pose = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.5f, z } };
+	return pose;
+}
+
+static void MakeEyeFov(ovrLayer_Union& layer, ovrTextureSwapChain chain, double sampleTime)
+{
+	memset(&layer, 0, sizeof(layer));
+	layer.EyeFov.Header.Type = ovrLayerType_EyeFov;
+	for (int eye = 0; eye < ovrEye_Count; eye++)
+	{
+		layer.EyeFov.ColorTexture[eye] = chain;
+		layer.EyeFov.Viewport[eye] = ovrRecti{ { eye * 512, 0 }, { 512, 512 } };
+		layer.EyeFov.Fov[eye] = ovrFovPort{ 1.0f, 1.0f, 1.0f, 1.0f };
+		layer.EyeFov.RenderPose[eye] = TestPose(0.0f);
+	}
+	layer.EyeFov.SensorSampleTime = sampleTime;
+}
+
+static void MakeQuad(ovrLayer_Union& layer, ovrTextureSwapChain chain, float z)
+{
+	memset(&layer, 0, sizeof(layer));
+	layer.Quad.Header.Type = ovrLayerType_Quad;
+	layer.Quad.ColorTexture = chain;
+	layer.Quad.Viewport = ovrRecti{ { 0, 0 }, { 256, 128 } };
+	layer.Quad.QuadPoseCenter = TestPose(z);
+	layer.Quad.QuadSize = ovrVector2f{ 1.0f, 0.5f };
+}
+
+static void MakeCylinder(ovrLayer_Union& layer, ovrTextureSwapChain chain)
+{
+	memset(&layer, 0, sizeof(layer));
+	layer.Cylinder.Header.Type = ovrLayerType_Cylinder;
+	layer.Cylinder.ColorTexture = chain;
+	layer.Cylinder.Viewport = ovrRecti{ { 0, 0 }, { 1024, 512 } };
+	layer.Cylinder.CylinderPoseCenter = TestPose(-2.0f);
+	layer.Cylinder.CylinderRadius = 2.0f;
+	layer.Cylinder.CylinderAngle = 1.5f;
+	layer.Cylinder.CylinderAspectRatio = 2.0f;
+}
+
+static void MakeCube(ovrLayer_Union& layer, ovrTextureSwapChain chain)
+{
+	memset(&layer, 0, sizeof(layer));
+	layer.Cube.Header.Type = ovrLayerType_Cube;
+	layer.Cube.Orientation = ovrQuatf{ 0.0f, 0.0f, 0.0f, 1.0f };
+	layer.Cube.CubeMapTexture = chain;
+}
+
+// A full frame of the layer types titles typically submit
+static void MakeFrame(ovrLayer_Union* layers, const ovrLayerHeader** layerPtrs, const TestChains& chains)
+{
+	for (int i = 0; i < ovrMaxLayerCount; i++)
+	{
+		if (i == 0)
+			MakeEyeFov(layers[i], chains[i], 1.0);
+		else if (i % 4 == 1)
+			MakeCylinder(layers[i], chains[i]);
+		else if (i % 4 == 2)
+			MakeCube(layers[i], chains[i]);
+		else
+			MakeQuad(layers[i], chains[i], -1.0f - i);
+		layerPtrs[i] = &layers[i].Header;
+	}
+}
+
+TEST(CompositionLayers_SixteenLayersNoAllocations)
+{
+	TestChains chains;
+	ovrLayer_Union layers[ovrMaxLayerCount];
+	const ovrLayerHeader* layerPtrs[ovrMaxLayerCount];
+	MakeFrame(layers, layerPtrs, chains);
+
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	LayerTranslationInfo info = TestInfo();
+	double sampleTime = 0.0;
+
+	uint64_t allocations = GetAllocationCount();
+	for (int frame = 0; frame < 100; frame++)
+	{
+		uint32_t count = TranslateLayers(*arena, info, nullptr, layerPtrs, ovrMaxLayerCount, &sampleTime);
+		CHECK(count == ovrMaxLayerCount);
+	}
+	CHECK(GetAllocationCount() - allocations == 0);
+
+	for (int i = 0; i < ovrMaxLayerCount; i++)
+	{
+		CHECK(arena->Headers[i] == &arena->Data[i].Header);
+		CHECK(arena->Headers[i]->space == TEST_SPACE_WORLD);
+		CHECK(arena->Headers[i]->layerFlags == XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT);
+	}
+	CHECK(arena->Data[0].Header.type == XR_TYPE_COMPOSITION_LAYER_PROJECTION);
+	CHECK(arena->Data[1].Header.type == XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR);
+	CHECK(arena->Data[2].Header.type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR);
+	CHECK(arena->Data[3].Header.type == XR_TYPE_COMPOSITION_LAYER_QUAD);
+}
+
+TEST(CompositionLayers_Quad)
+{
+	TestChains chains;
+	ovrLayer_Union layer;
+	MakeQuad(layer, chains[0], -3.0f);
+	layer.Quad.Header.Flags = ovrLayerFlag_HeadLocked;
+	const ovrLayerHeader* layerPtr = &layer.Header;
+
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	double sampleTime = 0.0;
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, &layerPtr, 1, &sampleTime) == 1);
+
+	const XrCompositionLayerQuad& quad = arena->Data[0].Quad;
+	CHECK(quad.space == TEST_SPACE_VIEW);
+	CHECK(quad.eyeVisibility == XR_EYE_VISIBILITY_BOTH);
+	CHECK(quad.subImage.swapchain == chains[0]->Swapchain);
+	CHECK(quad.subImage.imageRect.extent.width == 256);
+	CHECK(quad.subImage.imageRect.extent.height == 128);
+	CHECK(quad.pose.position.z == -3.0f);
+	CHECK(quad.pose.orientation.w == 1.0f);
+	CHECK(quad.size.width == 1.0f && quad.size.height == 0.5f);
+
+	// Quads don't carry a sample time
+	CHECK(sampleTime == 0.0);
+}
+
+TEST(CompositionLayers_ClampViewport)
+{
+	TestChains chains;
+	ovrLayer_Union layer;
+	MakeQuad(layer, chains[0], -1.0f);
+	const ovrLayerHeader* layerPtr = &layer.Header;
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	double sampleTime = 0.0;
+
+	// Negative offsets are clamped to the origin and the size to the swapchain
+	layer.Quad.Viewport = ovrRecti{ { -10, -20 }, { 4096, 4096 } };
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, &layerPtr, 1, &sampleTime) == 1);
+	XrRect2Di rect = arena->Data[0].Quad.subImage.imageRect;
+	CHECK(rect.offset.x == 0 && rect.offset.y == 0);
+	CHECK(rect.extent.width == 1024 && rect.extent.height == 512);
+
+	// An empty viewport covers the whole swapchain
+	layer.Quad.Viewport = ovrRecti{ { 16, 32 }, { 0, 0 } };
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, &layerPtr, 1, &sampleTime) == 1);
+	rect = arena->Data[0].Quad.subImage.imageRect;
+	CHECK(rect.offset.x == 16 && rect.offset.y == 32);
+	CHECK(rect.extent.width == 1024 && rect.extent.height == 512);
+}
+
+TEST(CompositionLayers_EyeFov)
+{
+	TestChains chains;
+	ovrLayer_Union layers[2];
+	MakeEyeFov(layers[0], chains[0], 2.0);
+	MakeEyeFov(layers[1], chains[1], 3.0);
+	layers[0].EyeFov.Fov[ovrEye_Left] = ovrFovPort{ 1.0f, 0.5f, 1.0f, 1.0f };
+	const ovrLayerHeader* layerPtrs[2] = { &layers[0].Header, &layers[1].Header };
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+
+	// Only the first eye layer of the frame sets the sample time
+	double sampleTime = 0.0;
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, layerPtrs, 2, &sampleTime) == 2);
+	CHECK(sampleTime == 2.0);
+
+	const XrCompositionLayerProjection& projection = arena->Data[0].Projection;
+	CHECK(projection.viewCount == ovrEye_Count);
+	CHECK(projection.views == arena->Views[0].Views);
+	const XrCompositionLayerProjectionView& left = projection.views[ovrEye_Left];
+	CHECK(left.subImage.swapchain == chains[0]->Swapchain);
+	CHECK(left.subImage.imageRect.offset.x == 0);
+	CHECK(projection.views[ovrEye_Right].subImage.imageRect.offset.x == 512);
+	CHECK(fabsf(left.fov.angleUp - atanf(1.0f)) < 1e-6f);
+	CHECK(fabsf(left.fov.angleDown + atanf(0.5f)) < 1e-6f);
+	CHECK(left.next == nullptr);
+
+	// The image is flipped by swapping the vertical angles
+	layers[0].EyeFov.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(fabsf(arena->Data[0].Projection.views[ovrEye_Left].fov.angleUp + atanf(0.5f)) < 1e-6f);
+
+	// OpenGL textures are already upside down, so the check is inverted
+	TestChains glChains(XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR);
+	MakeEyeFov(layers[0], glChains[0], 2.0);
+	layers[0].EyeFov.Fov[ovrEye_Left] = ovrFovPort{ 1.0f, 0.5f, 1.0f, 1.0f };
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(fabsf(arena->Data[0].Projection.views[ovrEye_Left].fov.angleUp + atanf(0.5f)) < 1e-6f);
+}
+
+TEST(CompositionLayers_EyeFovDepth)
+{
+	TestChains chains;
+	ovrLayer_Union layer;
+	MakeEyeFov(layer, chains[0], 1.0);
+	layer.EyeFovDepth.Header.Type = ovrLayerType_EyeFovDepth;
+	layer.EyeFovDepth.DepthTexture[ovrEye_Left] = chains[1];
+	layer.EyeFovDepth.DepthTexture[ovrEye_Right] = chains[1];
+	layer.EyeFovDepth.ProjectionDesc = ovrTimewarpProjectionDesc{ -0.5f, -0.1f, -1.0f };
+	const ovrLayerHeader* layerPtr = &layer.Header;
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	double sampleTime = 0.0;
+
+	ovrViewScaleDesc viewScale = {};
+	viewScale.HmdSpaceToWorldScaleInMeters = 2.0f;
+	CHECK(TranslateLayers(*arena, TestInfo(), &viewScale, &layerPtr, 1, &sampleTime) == 1);
+	const XrCompositionLayerProjectionView& view = arena->Data[0].Projection.views[ovrEye_Right];
+	const XrCompositionLayerDepthInfoKHR* depth = (const XrCompositionLayerDepthInfoKHR*)view.next;
+	CHECK(depth == &arena->Views[0].DepthInfo[ovrEye_Right]);
+	CHECK(depth->type == XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR);
+	CHECK(depth->subImage.swapchain == chains[1]->Swapchain);
+	CHECK(fabsf(depth->nearZ - 0.4f) < 1e-6f);
+	CHECK(fabsf(depth->farZ + 0.4f) < 1e-6f);
+
+	// Without the depth extension the layer is submitted without depth
+	LayerTranslationInfo info = TestInfo();
+	info.CompositionDepth = false;
+	CHECK(TranslateLayers(*arena, info, &viewScale, &layerPtr, 1, &sampleTime) == 1);
+	CHECK(arena->Data[0].Projection.views[ovrEye_Right].next == nullptr);
+}
+
+TEST(CompositionLayers_SkippedLayers)
+{
+	TestChains chains;
+	ovrLayer_Union layers[4];
+	MakeEyeFov(layers[0], chains[0], 1.0);
+	layers[0].EyeFov.Fov[ovrEye_Right] = ovrFovPort{ 0.0f, 0.0f, 0.0f, 0.0f };
+	MakeQuad(layers[1], nullptr, -1.0f);
+	memset(&layers[2], 0, sizeof(layers[2]));
+	MakeQuad(layers[3], chains[3], -1.0f);
+	const ovrLayerHeader* layerPtrs[5] = { &layers[0].Header, &layers[1].Header, nullptr, &layers[2].Header, &layers[3].Header };
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	double sampleTime = 0.0;
+
+	// Invalid fovs, missing textures, missing layers and disabled layers are all skipped
+	CHECK(TranslateLayers(*arena, TestInfo(), nullptr, layerPtrs, 5, &sampleTime) == 1);
+	CHECK(arena->Data[0].Quad.subImage.swapchain == chains[3]->Swapchain);
+}
+
+TEST(CompositionLayers_LegacyLayout)
+{
+	// Before 1.25 the layer header had no reserved data, so the layer data starts right after the type and flags
+	TestChains chains;
+	ovrLayer_Union layer;
+	MakeQuad(layer, chains[0], -4.0f);
+	alignas(ovrLayer_Union) char legacy[sizeof(ovrLayer_Union)] = {};
+	memcpy(legacy, &layer, offsetof(ovrLayerHeader, Reserved));
+	memcpy(legacy + offsetof(ovrLayerHeader, Reserved), (char*)&layer + sizeof(ovrLayerHeader),
+		sizeof(ovrLayerQuad) - sizeof(ovrLayerHeader));
+	const ovrLayerHeader* layerPtr = (const ovrLayerHeader*)legacy;
+
+	LayerTranslationInfo info = TestInfo();
+	info.MinorVersion = 24;
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	double sampleTime = 0.0;
+	CHECK(TranslateLayers(*arena, info, nullptr, &layerPtr, 1, &sampleTime) == 1);
+	CHECK(arena->Data[0].Quad.subImage.swapchain == chains[0]->Swapchain);
+	CHECK(arena->Data[0].Quad.pose.position.z == -4.0f);
+}
+
+TEST(CompositionLayers_CacheHit)
+{
+	TestChains chains;
+	ovrLayer_Union layers[2];
+	MakeQuad(layers[0], chains[0], -2.0f);
+	MakeCylinder(layers[1], chains[1]);
+	const ovrLayerHeader* layerPtrs[] = { &layers[0].Header, &layers[1].Header };
+
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	LayerTranslationInfo info = TestInfo();
+	double sampleTime = 0.0;
+
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 2, &sampleTime) == 2);
+	CHECK(arena->CacheHits == 0);
+	CHECK(arena->CacheMisses == 2);
+	XrCompositionLayerQuad quad = arena->Data[0].Quad;
+	XrCompositionLayerCylinderKHR cylinder = arena->Data[1].Cylinder;
+
+	// The flags are resolved every frame, even when the translation comes from the cache
+	layers[0].Header.Flags = ovrLayerFlag_HeadLocked;
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 2, &sampleTime) == 2);
+	CHECK(arena->CacheHits == 2);
+	CHECK(arena->CacheMisses == 2);
+	CHECK(arena->Data[0].Header.space == TEST_SPACE_VIEW);
+	CHECK(arena->Data[1].Header.space == TEST_SPACE_WORLD);
+	CHECK(arena->Data[0].Quad.subImage.swapchain == quad.subImage.swapchain);
+	CHECK(arena->Data[0].Quad.subImage.imageRect.extent.width == quad.subImage.imageRect.extent.width);
+	CHECK(arena->Data[0].Quad.pose.position.z == quad.pose.position.z);
+	CHECK(arena->Data[1].Cylinder.radius == cylinder.radius);
+	CHECK(arena->Data[1].Cylinder.pose.position.z == cylinder.pose.position.z);
+}
+
+TEST(CompositionLayers_CacheMiss)
+{
+	TestChains chains;
+	ovrLayer_Union layer;
+	MakeQuad(layer, chains[0], -2.0f);
+	const ovrLayerHeader* layerPtrs[] = { &layer.Header };
+
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	LayerTranslationInfo info = TestInfo();
+	double sampleTime = 0.0;
+
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+
+	// A moved quad must not reuse the old pose
+	layer.Quad.QuadPoseCenter.Position.z = -3.0f;
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(arena->CacheMisses == 2);
+	CHECK(arena->Data[0].Quad.pose.position.z == -3.0f);
+
+	// The same data submitted as a cylinder from the same swapchain isn't a hit either
+	MakeCylinder(layer, chains[0]);
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+	MakeQuad(layer, chains[0], -3.0f);
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(arena->CacheHits == 0);
+	CHECK(arena->CacheMisses == 4);
+	CHECK(arena->Data[0].Header.type == XR_TYPE_COMPOSITION_LAYER_QUAD);
+
+	// A stale hash with different source data is rejected by the comparison
+	chains[0]->Cache.Source.Quad.QuadSize.x = 2.0f;
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(arena->CacheHits == 0);
+	CHECK(arena->CacheMisses == 5);
+	CHECK(arena->Data[0].Quad.size.width == 1.0f);
+	CHECK(TranslateLayers(*arena, info, nullptr, layerPtrs, 1, &sampleTime) == 1);
+	CHECK(arena->CacheHits == 1);
+}
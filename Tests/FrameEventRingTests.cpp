@@ -0,0 +1,114 @@
+#include "Test.h"
+#include "Revive/FrameEventRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(FrameEventRing_InitialState)
+{
+	// The first frame doesn't have to wait on anything
+	FrameEventRing ring;
+	CHECK(ring.Wait(0, 0));
+	CHECK(!ring.Wait(1, 0));
+}
+
+TEST(FrameEventRing_Timeout)
+{
+	FrameEventRing ring;
+	ring.Reset(1);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	CHECK(!ring.Wait(1, 20));
+	CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+	ring.Signal(1);
+	CHECK(ring.Wait(1, 20));
+}
+
+TEST(FrameEventRing_QueueAhead)
+{
+	// Frames share a slot with the frame MAX_QUEUE_AHEAD frames earlier
+	FrameEventRing ring;
+	for (long long i = 1; i <= MAX_QUEUE_AHEAD; i++)
+		ring.Reset(i);
+	CHECK(!ring.Wait(0, 0));
+
+	for (long long i = 1; i <= MAX_QUEUE_AHEAD; i++)
+	{
+		ring.Signal(i);
+		CHECK(ring.Wait(i, 0));
+	}
+}
+
+// The app thread waits on the previous frame and begins the next one, while a render thread
+// ends the frames, like titles that submit from a different thread than the one they wait on.
+// WaitToBeginFrame must never return before the previous frame ended.
+TEST(FrameEventRing_Stress)
+{
+	const long long frames = 20000;
+
+	FrameEventRing ring;
+	std::atomic_llong begun(0);
+	std::atomic_llong ended(0);
+	std::atomic_bool ordered(true);
+
+	std::thread render([&]()
+	{
+		for (long long i = 1; i <= frames; i++)
+		{
+			// Wait until the app thread began the frame
+			while (begun.load() < i)
+				std::this_thread::yield();
+
+			ended.store(i);
+			ring.Signal(i);
+		}
+	});
+
+	bool timedOut = false;
+	for (long long i = 1; i <= frames; i++)
+	{
+		// WaitToBeginFrame
+		if (!ring.Wait(i - 1, 5000))
+		{
+			timedOut = true;
+			break;
+		}
+		if (ended.load() < i - 1)
+			ordered = false;
+
+		// BeginFrame
+		ring.Reset(i);
+		begun.store(i);
+	}
+	if (timedOut)
+		begun.store(frames);
+	render.join();
+
+	CHECK(!timedOut);
+	CHECK(ordered);
+	CHECK(ring.Wait(frames, 0));
+}
+
+// Several threads wait on the same frame, a single signal has to wake all of them
+TEST(FrameEventRing_WakeAll)
+{
+	const int waiters = 4;
+
+	for (long long frame = 1; frame <= 200; frame++)
+	{
+		FrameEventRing ring;
+		ring.Reset(frame);
+
+		std::atomic_int woken(0);
+		std::thread threads[waiters];
+		for (std::thread& thread : threads)
+			thread = std::thread([&]() { if (ring.Wait(frame, 5000)) woken++; });
+
+		ring.Signal(frame);
+		for (std::thread& thread : threads)
+			thread.join();
+		CHECK(woken == waiters);
+	}
+}
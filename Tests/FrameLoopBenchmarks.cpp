@@ -0,0 +1,39 @@
+#include "Benchmark.h"
+#include "Revive/FramePacingModel.h"
+#include "ReviveXR/TouchInput.h"
+
+#include <string.h>
+
+// The pacing decision made every frame in ovr_WaitToBeginFrame
+BENCHMARK(FramePacingModel_Frame, 10000000)
+{
+	FramePacingModel model;
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		model.AddVsync(i + 1);
+		model.AddGpuTime(0.002);
+		DoNotOptimize(model.GetDelay(1.0 / 90.0, 0.0005));
+		model.AddCpuTime(0.003 + (i & 7) * 0.0001);
+	}
+}
+
+// The conversion made on every ovr_GetInputState call for Touch controllers
+BENCHMARK(TouchInput_SnapshotToInputState, 10000000)
+{
+	TouchActionSnapshot snapshot;
+	memset(&snapshot, 0, sizeof(snapshot));
+	for (int i = 0; i < ovrHand_Count; i++)
+	{
+		snapshot.IndexTrigger[i] = 0.5f;
+		snapshot.Thumbstick[i] = ovrVector2f{ 0.3f, -0.7f };
+	}
+
+	ovrInputState state;
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		memset(&state, 0, sizeof(state));
+		snapshot.Button_AX[0] = (i & 1) != 0;
+		TouchSnapshotToInputState(snapshot, false, &state);
+		DoNotOptimize(state);
+	}
+}
@@ -0,0 +1,149 @@
+#include "Test.h"
+#include "MockRuntime.h"
+#include "ReviveXR/CompositionLayers.h"
+#include "ReviveXR/SwapChain.h"
+#include "ReviveXR/SwapChainWaiter.h"
+
+#include <memory>
+#include <string.h>
+
+static XrResult WaitFrame(XrSession session)
+{
+	XrFrameWaitInfo waitInfo = XR_TYPE(FRAME_WAIT_INFO);
+	XrFrameState frameState = XR_TYPE(FRAME_STATE);
+	return xrWaitFrame(session, &waitInfo, &frameState);
+}
+
+static XrResult BeginFrame(XrSession session)
+{
+	XrFrameBeginInfo beginInfo = XR_TYPE(FRAME_BEGIN_INFO);
+	return xrBeginFrame(session, &beginInfo);
+}
+
+static XrResult EndFrame(XrSession session, XrCompositionLayerBaseHeader* const* layers, uint32_t layerCount)
+{
+	XrFrameEndInfo endInfo = XR_TYPE(FRAME_END_INFO);
+	endInfo.displayTime = 1;
+	endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+	endInfo.layerCount = layerCount;
+	endInfo.layers = layers;
+	return xrEndFrame(session, &endInfo);
+}
+
+// The mock runtime rejects frames that are out of order, like the validation layer would
+TEST(FrameLoop_CallOrder)
+{
+	MockRuntime::Reset();
+	XrSession session = MockRuntime::CreateSession();
+
+	CHECK(BeginFrame(session) == XR_ERROR_CALL_ORDER_INVALID);
+	CHECK(EndFrame(session, nullptr, 0) == XR_ERROR_CALL_ORDER_INVALID);
+	CHECK(MockRuntime::GetErrors() == 2);
+
+	CHECK(WaitFrame(session) == XR_SUCCESS);
+	CHECK(WaitFrame(session) == XR_ERROR_CALL_ORDER_INVALID);
+	CHECK(BeginFrame(session) == XR_SUCCESS);
+	CHECK(EndFrame(session, nullptr, 0) == XR_SUCCESS);
+
+	// Beginning a frame without ending the previous one discards it
+	CHECK(WaitFrame(session) == XR_SUCCESS);
+	CHECK(BeginFrame(session) == XR_SUCCESS);
+	CHECK(WaitFrame(session) == XR_SUCCESS);
+	CHECK(BeginFrame(session) == XR_FRAME_DISCARDED);
+	CHECK(EndFrame(session, nullptr, 0) == XR_SUCCESS);
+
+	MockRuntime::FrameStats stats = MockRuntime::GetFrameStats(session);
+	CHECK(stats.Waited == 3 && stats.Begun == 3 && stats.Ended == 3);
+	CHECK(MockRuntime::GetErrors() == 3);
+	MockRuntime::DestroySession(session);
+}
+
+// The frame loop of ReviveXR against the mock runtime, the translated layers have to pass its validation
+TEST(FrameLoop_Layers)
+{
+	MockRuntime::Reset();
+	XrSession session = MockRuntime::CreateSession();
+	XrSpace viewSpace = MockRuntime::CreateSpace();
+	XrSpace worldSpace = MockRuntime::CreateSpace();
+
+	XrSwapchainImageBaseHeader image = { XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR, nullptr };
+	std::unique_ptr<ovrTextureSwapChainData> chains[2];
+	for (auto& chain : chains)
+	{
+		chain.reset(new ovrTextureSwapChainData());
+		chain->Desc.Width = 1024;
+		chain->Desc.Height = 512;
+		chain->Swapchain = MockRuntime::CreateSwapchain();
+		chain->Images = &image;
+		chain->ImageReady = true;
+	}
+
+	ovrLayer_Union layers[2];
+	memset(layers, 0, sizeof(layers));
+	layers[0].EyeFov.Header.Type = ovrLayerType_EyeFov;
+	for (int eye = 0; eye < ovrEye_Count; eye++)
+	{
+		layers[0].EyeFov.ColorTexture[eye] = chains[0].get();
+		layers[0].EyeFov.Viewport[eye] = ovrRecti{ { eye * 512, 0 }, { 512, 512 } };
+		layers[0].EyeFov.Fov[eye] = ovrFovPort{ 1.0f, 1.0f, 1.0f, 1.0f };
+		layers[0].EyeFov.RenderPose[eye].Orientation.w = 1.0f;
+	}
+	layers[1].Quad.Header.Type = ovrLayerType_Quad;
+	layers[1].Quad.ColorTexture = chains[1].get();
+	layers[1].Quad.Viewport = ovrRecti{ { 0, 0 }, { 256, 128 } };
+	layers[1].Quad.QuadPoseCenter.Orientation.w = 1.0f;
+	layers[1].Quad.QuadSize = ovrVector2f{ 1.0f, 0.5f };
+	const ovrLayerHeader* layerPtrs[2] = { &layers[0].Header, &layers[1].Header };
+
+	std::unique_ptr<LayerArena> arena(new LayerArena());
+	LayerTranslationInfo info = { 25, true, true, true, viewSpace, worldSpace };
+
+	// None of the images were released yet, so the runtime has nothing to display
+	double sampleTime = 0.0;
+	uint32_t numLayers = TranslateLayers(*arena, info, nullptr, layerPtrs, 2, &sampleTime);
+	CHECK(numLayers == 2);
+	CHECK(WaitFrame(session) == XR_SUCCESS);
+	CHECK(BeginFrame(session) == XR_SUCCESS);
+	CHECK(EndFrame(session, arena->Headers, numLayers) == XR_ERROR_LAYER_INVALID);
+	MockRuntime::Reset();
+
+	SwapChainWaiter waiter;
+	waiter.Start();
+	for (int frame = 0; frame < 10; frame++)
+	{
+		if (frame > 0)
+		{
+			CHECK(WaitFrame(session) == XR_SUCCESS);
+			CHECK(waiter.WaitAll() == XR_SUCCESS);
+			CHECK(BeginFrame(session) == XR_SUCCESS);
+		}
+
+		for (auto& chain : chains)
+		{
+			waiter.WaitReady(chain.get());
+			XrSwapchainImageReleaseInfo releaseInfo = XR_TYPE(SWAPCHAIN_IMAGE_RELEASE_INFO);
+			CHECK(xrReleaseSwapchainImage(chain->Swapchain, &releaseInfo) == XR_SUCCESS);
+			XrSwapchainImageAcquireInfo acquireInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
+			CHECK(xrAcquireSwapchainImage(chain->Swapchain, &acquireInfo, &chain->CurrentIndex) == XR_SUCCESS);
+			waiter.Submit(chain.get());
+		}
+
+		sampleTime = 0.0;
+		numLayers = TranslateLayers(*arena, info, nullptr, layerPtrs, 2, &sampleTime);
+		CHECK(EndFrame(session, arena->Headers, numLayers) == XR_SUCCESS);
+	}
+	CHECK(waiter.WaitAll() == XR_SUCCESS);
+	waiter.Stop();
+
+	MockRuntime::FrameStats stats = MockRuntime::GetFrameStats(session);
+	CHECK(stats.Waited == 10 && stats.Begun == 10 && stats.Ended == 10);
+	CHECK(stats.Layers == 20);
+	CHECK(arena->CacheHits == 10 && arena->CacheMisses == 1);
+	CHECK(MockRuntime::GetErrors() == 0);
+
+	for (auto& chain : chains)
+		MockRuntime::DestroySwapchain(chain->Swapchain);
+	MockRuntime::DestroySpace(viewSpace);
+	MockRuntime::DestroySpace(worldSpace);
+	MockRuntime::DestroySession(session);
+}
@@ -0,0 +1,217 @@
+#include "Test.h"
+#include "Revive/FramePacingModel.h"
+#include "Shared/SpikeDetector.h"
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Simulates an app running against the compositor at the given refresh rate. The compositor releases
+// the app shortly after a vsync, the app then spends its CPU and GPU time and the frame is displayed
+// unless it misses the deadline, in which case a vsync is skipped.
+struct PacingSimulation
+{
+	PacingSimulation(double refreshRate, double cpuTime, double gpuTime, double jitter)
+		: Period(1.0 / refreshRate)
+		, CpuTime(cpuTime)
+		, GpuTime(gpuTime)
+		, Jitter(jitter)
+		, Random(1234)
+		, VsyncCounter(1)
+		, Frames(0)
+		, Missed(0)
+		, Paced(0)
+		, Pacing(true)
+	{
+	}
+
+	// Returns the delay applied to the frame
+	double RunFrame(double extraCpuTime = 0.0)
+	{
+		std::uniform_real_distribution<double> noise(-Jitter, Jitter);
+		return RunFrame(CpuTime + noise(Random) + extraCpuTime, GpuTime);
+	}
+
+	// Runs a frame with the given cost, the model is always updated but the delay is only applied with pacing
+	double RunFrame(double cpuTime, double gpuTime)
+	{
+		const double secondsSinceVsync = 0.0005;
+
+		Model.AddVsync(VsyncCounter);
+		Model.AddGpuTime(gpuTime);
+		double delay = Pacing ? Model.GetDelay(Period, secondsSinceVsync) : 0.0;
+		if (delay > 0.0)
+			Paced++;
+
+		Model.AddCpuTime(cpuTime);
+		Frames++;
+
+		// The frame has to be done before the vsync after the next one
+		double finish = secondsSinceVsync + delay + cpuTime + gpuTime;
+		double deadline = 2.0 * Period - REV_PACING_MARGIN;
+		if (finish > deadline)
+		{
+			Missed++;
+			VsyncCounter += 2;
+		}
+		else
+		{
+			VsyncCounter++;
+		}
+		return delay;
+	}
+
+	double Period, CpuTime, GpuTime, Jitter;
+	std::mt19937 Random;
+	FramePacingModel Model;
+	uint64_t VsyncCounter;
+	uint32_t Frames, Missed, Paced;
+	bool Pacing;
+};
+
+// Reads the frames of a spike detector capture, returns false if it isn't a valid capture
+static bool ReadCapture(FILE* file, std::vector<SpikeFrame>& frames)
+{
+	SpikeFileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != REV_SPIKE_FILE_MAGIC)
+		return false;
+	if (header.Version > REV_SPIKE_FILE_VERSION || header.FrameSize < sizeof(SpikeFrame))
+		return false;
+
+	std::vector<char> record(header.FrameSize);
+	for (uint32_t i = 0; i < header.FrameCount; i++)
+	{
+		if (fread(record.data(), header.FrameSize, 1, file) != 1)
+			return false;
+
+		SpikeFrame frame;
+		memcpy(&frame, record.data(), sizeof(frame));
+		frames.push_back(frame);
+	}
+	return true;
+}
+
+// Replays recorded frames, the captures don't separate the GPU time so the work between the end of
+// ovr_WaitToBeginFrame and the submission of the frame is all counted as CPU time
+static PacingSimulation ReplayCapture(const std::vector<SpikeFrame>& frames, double refreshRate, bool pacing)
+{
+	PacingSimulation sim(refreshRate, 0.0, 0.0, 0.0);
+	sim.Pacing = pacing;
+	for (const SpikeFrame& frame : frames)
+	{
+		uint32_t work = frame.Interval > frame.WaitTime ? frame.Interval - frame.WaitTime : 0;
+		sim.RunFrame(work / 1000000.0, 0.0);
+	}
+	return sim;
+}
+
+static void PrintReplay(const char* name, const std::vector<SpikeFrame>& frames, double refreshRate)
+{
+	PacingSimulation unpaced = ReplayCapture(frames, refreshRate, false);
+	PacingSimulation paced = ReplayCapture(frames, refreshRate, true);
+	printf("  %s: %u frames at %.0f Hz, missed %.2f%% without pacing, %.2f%% with pacing (%u paced)\n",
+		name, paced.Frames, refreshRate, 100.0 * unpaced.Missed / unpaced.Frames,
+		100.0 * paced.Missed / paced.Frames, paced.Paced);
+}
+
+TEST(FramePacing_Warmup)
+{
+	PacingSimulation sim(90.0, 0.003, 0.002, 0.0);
+	for (int i = 0; i < REV_PACING_MIN_FRAMES; i++)
+		CHECK(sim.RunFrame() == 0.0);
+	CHECK(sim.RunFrame() > 0.0);
+}
+
+TEST(FramePacing_LightApp)
+{
+	// A light app is held back, but never long enough to miss a frame
+	PacingSimulation sim(90.0, 0.003, 0.002, 0.0005);
+	for (int i = 0; i < 1000; i++)
+	{
+		double delay = sim.RunFrame();
+		CHECK(delay <= sim.Period / 2.0);
+	}
+	CHECK(sim.Missed == 0);
+	CHECK(sim.Paced >= 1000 - REV_PACING_MIN_FRAMES);
+}
+
+TEST(FramePacing_HeavyApp)
+{
+	// An app that needs most of the frame budget is never held back
+	PacingSimulation sim(90.0, 0.014, 0.006, 0.0005);
+	for (int i = 0; i < 1000; i++)
+		CHECK(sim.RunFrame() == 0.0);
+}
+
+TEST(FramePacing_Backoff)
+{
+	PacingSimulation sim(90.0, 0.003, 0.002, 0.0);
+	for (int i = 0; i < 100; i++)
+		sim.RunFrame();
+	CHECK(sim.Missed == 0);
+
+	// A single slow frame misses a vsync, pacing stops for the backoff period
+	sim.RunFrame(0.030);
+	CHECK(sim.Missed == 1);
+	for (int i = 0; i < REV_PACING_BACKOFF_FRAMES; i++)
+		CHECK(sim.RunFrame() == 0.0);
+	CHECK(sim.RunFrame() > 0.0);
+	CHECK(sim.Missed == 1);
+}
+
+// Replays a synthetic capture through the same path as a recorded one. Set REVIVE_PACING_TRACE to the
+// path of a spike detector capture to also replay it, REVIVE_PACING_REFRESH sets the refresh rate.
+TEST(FramePacing_Replay)
+{
+	// A light app waiting on the compositor every frame, with a single spike
+	const uint32_t period = 1000000 / 90;
+	SpikeFileHeader header = { REV_SPIKE_FILE_MAGIC, REV_SPIKE_FILE_VERSION, (uint16_t)sizeof(SpikeFrame), REV_SPIKE_FRAMES, 0 };
+	FILE* file = tmpfile();
+	CHECK(file);
+	fwrite(&header, sizeof(header), 1, file);
+	for (uint32_t i = 0; i < REV_SPIKE_FRAMES; i++)
+	{
+		SpikeFrame frame = {};
+		frame.FrameIndex = i;
+		frame.Interval = i == 200 ? 3 * period : period;
+		frame.WaitTime = i == 200 ? 0 : period - 4000;
+		fwrite(&frame, sizeof(frame), 1, file);
+	}
+	rewind(file);
+
+	std::vector<SpikeFrame> frames;
+	bool valid = ReadCapture(file, frames);
+	fclose(file);
+	CHECK(valid);
+	CHECK(frames.size() == REV_SPIKE_FRAMES);
+
+	PacingSimulation unpaced = ReplayCapture(frames, 90.0, false);
+	PacingSimulation paced = ReplayCapture(frames, 90.0, true);
+	CHECK(unpaced.Missed == 1 && unpaced.Paced == 0);
+	CHECK(paced.Missed == 1 && paced.Paced > 0);
+	PrintReplay("synthetic", frames, 90.0);
+
+	const char* path = getenv("REVIVE_PACING_TRACE");
+	if (!path)
+		return;
+
+	file = fopen(path, "rb");
+	if (!file)
+	{
+		printf("  Failed to open %s\n", path);
+		return;
+	}
+	frames.clear();
+	valid = ReadCapture(file, frames);
+	fclose(file);
+	if (!valid || frames.empty())
+	{
+		printf("  %s is not a spike capture\n", path);
+		return;
+	}
+
+	const char* refresh = getenv("REVIVE_PACING_REFRESH");
+	PrintReplay(path, frames, refresh ? atof(refresh) : 90.0);
+}
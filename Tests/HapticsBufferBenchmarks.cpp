@@ -0,0 +1,27 @@
+#include "Benchmark.h"
+#include "Revive/HapticsBuffer.h"
+
+static uint8_t s_Samples[OVR_HAPTICS_BUFFER_SAMPLES_MAX];
+
+// Fills the whole ring with a single submission and drains it again
+BENCHMARK(HapticsBuffer_AddSamples, 200000)
+{
+	HapticsBuffer haptics;
+	ovrHapticsBuffer buffer = { s_Samples, OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1, ovrHapticsBufferSubmit_Enqueue };
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		haptics.AddSamples(&buffer);
+		while (haptics.GetState().SamplesQueued > 0)
+			DoNotOptimize(haptics.GetSample());
+	}
+}
+
+// Titles poll the playback state every frame to decide how many samples to submit
+BENCHMARK(HapticsBuffer_GetState, 10000000)
+{
+	HapticsBuffer haptics;
+	ovrHapticsBuffer buffer = { s_Samples, 100, ovrHapticsBufferSubmit_Enqueue };
+	haptics.AddSamples(&buffer);
+	for (uint64_t i = 0; i < iterations; i++)
+		DoNotOptimize(haptics.GetState());
+}
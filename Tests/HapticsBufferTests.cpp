@@ -0,0 +1,204 @@
+#include "Test.h"
+#include "Revive/HapticsBuffer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <thread>
+
+static void AddSamples(HapticsBuffer& haptics, const uint8_t* samples, int count)
+{
+	ovrHapticsBuffer buffer = { samples, count, ovrHapticsBufferSubmit_Enqueue };
+	haptics.AddSamples(&buffer);
+}
+
+TEST(HapticsBuffer_State)
+{
+	HapticsBuffer haptics;
+	ovrHapticsPlaybackState state = haptics.GetState();
+	CHECK(state.SamplesQueued == 0);
+	CHECK(state.RemainingQueueSpace == OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1);
+
+	uint8_t samples[OVR_HAPTICS_BUFFER_SAMPLES_MAX + 44];
+	for (int i = 0; i < (int)sizeof(samples); i++)
+		samples[i] = 1 + i % 255;
+	AddSamples(haptics, samples, 100);
+	state = haptics.GetState();
+	CHECK(state.SamplesQueued == 100);
+	CHECK(state.SamplesQueued + state.RemainingQueueSpace == OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1);
+
+	// Samples that don't fit are dropped, a full buffer reports no space left
+	AddSamples(haptics, samples + 100, (int)sizeof(samples) - 100);
+	state = haptics.GetState();
+	CHECK(state.SamplesQueued == OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1);
+	CHECK(state.RemainingQueueSpace == 0);
+
+	// All queued samples come out in order
+	for (int i = 0; i < OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1; i++)
+		CHECK(lroundf(haptics.GetSample() * 255.0f) == samples[i]);
+	CHECK(haptics.GetSample() == 0.0f);
+	state = haptics.GetState();
+	CHECK(state.SamplesQueued == 0);
+	CHECK(state.RemainingQueueSpace == OVR_HAPTICS_BUFFER_SAMPLES_MAX - 1);
+}
+
+// The application thread submits samples while the scheduler thread consumes them, every sample
+// must come out exactly once and in order. The producer never submits more than the reported
+// free space, so an overstated RemainingQueueSpace shows up as a dropped sample.
+TEST(HapticsBuffer_Stress)
+{
+	const uint32_t total = 2000000;
+
+	HapticsBuffer haptics;
+	std::thread producer([&]()
+	{
+		uint8_t samples[64];
+		uint32_t sent = 0;
+		while (sent < total)
+		{
+			int space = haptics.GetState().RemainingQueueSpace;
+			int count = std::min(std::min(space, (int)sizeof(samples)), (int)(total - sent));
+			if (count <= 0)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Samples cycle through 1..255, a zero sample means the buffer is empty
+			for (int i = 0; i < count; i++)
+				samples[i] = 1 + (sent + i) % 255;
+			AddSamples(haptics, samples, count);
+			sent += count;
+		}
+	});
+
+	uint32_t received = 0;
+	bool ordered = true;
+	while (received < total)
+	{
+		long sample = lroundf(haptics.GetSample() * 255.0f);
+		if (sample == 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		if (sample != 1 + received % 255)
+			ordered = false;
+		received++;
+	}
+	producer.join();
+
+	CHECK(ordered);
+	CHECK(received == total);
+	CHECK(haptics.GetState().SamplesQueued == 0);
+}
+
+static void AddPattern(HapticsBuffer& haptics, const uint8_t* pattern, int period, int count)
+{
+	uint8_t samples[OVR_HAPTICS_BUFFER_SAMPLES_MAX];
+	for (int i = 0; i < count; i++)
+		samples[i] = pattern[i % period];
+	AddSamples(haptics, samples, count);
+}
+
+TEST(HapticsBuffer_SegmentConstant)
+{
+	HapticsBuffer haptics;
+	HapticsEnvelope envelope = { 16, 32, 8, true };
+	HapticsSegment segment;
+	CHECK(!haptics.PeekSegment(envelope, &segment));
+
+	const uint8_t pattern[] = { 128 };
+	AddPattern(haptics, pattern, 1, 64);
+	CHECK(haptics.PeekSegment(envelope, &segment));
+	CHECK(segment.Samples == 32);
+	CHECK(fabsf(segment.Amplitude - 128 / 255.0f) < 1e-4f);
+	CHECK(segment.Frequency == 0.0f);
+
+	// Peeking doesn't consume the samples
+	CHECK(haptics.GetState().SamplesQueued == 64);
+}
+
+TEST(HapticsBuffer_SegmentFrequency)
+{
+	HapticsEnvelope envelope = { 2, 64, 8, true };
+	HapticsSegment segment;
+
+	// Pulse trains are resolved even with a short block length in the envelope
+	const uint8_t pulse160[] = { 255, 0 };
+	const uint8_t pulse80[] = { 255, 255, 0, 0 };
+	const uint8_t pulse40[] = { 255, 255, 255, 255, 0, 0, 0, 0 };
+	const uint8_t pulse20[] = { 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 0, 0, 0, 0, 0 };
+	struct { const uint8_t* Pattern; int Period; float Frequency; } cases[] = {
+		{ pulse160, 2, 160.0f }, { pulse80, 4, 80.0f }, { pulse40, 8, 40.0f }, { pulse20, 16, 20.0f }
+	};
+
+	for (auto& test : cases)
+	{
+		HapticsBuffer haptics;
+		AddPattern(haptics, test.Pattern, test.Period, 64);
+		CHECK(haptics.PeekSegment(envelope, &segment));
+		CHECK(segment.Samples == 64);
+		CHECK(segment.Frequency == test.Frequency);
+
+		// The amplitude is the RMS level, not the peak of the pulses
+		CHECK(fabsf(segment.Amplitude - sqrtf(0.5f)) < 1e-4f);
+	}
+
+	// Actuators that can't follow a frequency don't get one
+	HapticsBuffer haptics;
+	AddPattern(haptics, pulse80, 4, 64);
+	envelope.UseFrequency = false;
+	CHECK(haptics.PeekSegment(envelope, &segment));
+	CHECK(segment.Frequency == 0.0f);
+}
+
+TEST(HapticsBuffer_SegmentSplit)
+{
+	HapticsBuffer haptics;
+	HapticsEnvelope envelope = { 8, 64, 16, false };
+	HapticsSegment segment;
+
+	// A level change beyond the tolerance starts a new segment, one within it doesn't
+	uint8_t samples[48];
+	for (int i = 0; i < 48; i++)
+		samples[i] = i < 16 ? 200 : i < 24 ? 190 : 100;
+	AddSamples(haptics, samples, 48);
+	CHECK(haptics.PeekSegment(envelope, &segment));
+	CHECK(segment.Samples == 24);
+
+	for (unsigned int i = 0; i < segment.Samples; i++)
+		haptics.GetSample();
+	CHECK(haptics.PeekSegment(envelope, &segment));
+	CHECK(segment.Samples == 24);
+	CHECK(fabsf(segment.Amplitude - 100 / 255.0f) < 1e-4f);
+
+	// A change in the pulse pattern starts a new segment as well
+	HapticsBuffer pulses;
+	const uint8_t pattern[] = { 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 255, 0, 255, 0, 255, 0 };
+	AddPattern(pulses, pattern, 16, 16);
+	CHECK(pulses.PeekSegment(envelope, &segment));
+	CHECK(segment.Samples == 8);
+}
+
+// Segments cut the number of vibrations that are sent to the runtime by an order of magnitude
+TEST(HapticsBuffer_SegmentCount)
+{
+	HapticsBuffer haptics;
+	HapticsEnvelope envelope = { 16, 32, 8, true };
+	const uint8_t pattern[] = { 200, 0, 0, 0 };
+	AddPattern(haptics, pattern, 4, 192);
+
+	unsigned int segments = 0, samples = 0;
+	HapticsSegment segment;
+	while (haptics.PeekSegment(envelope, &segment))
+	{
+		CHECK(segment.Frequency == 80.0f);
+		for (unsigned int i = 0; i < segment.Samples; i++)
+			haptics.GetSample();
+		samples += segment.Samples;
+		segments++;
+	}
+	CHECK(samples == 192);
+	CHECK(segments * 10 <= samples);
+}
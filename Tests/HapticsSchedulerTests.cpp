@@ -0,0 +1,234 @@
+#include "Test.h"
+#include "Revive/HapticsBuffer.h"
+#include "Shared/HapticsScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <math.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Simulated time, sleeping advances the clock instantly. Waiting for a wake counts as going idle,
+// so a test can wait until the scheduler has drained all buffers.
+class TestClock : public HapticsClock
+{
+public:
+	TestClock() : m_Time(0), m_Sleeps(0), m_Idle(0), m_Woken(false) { }
+
+	virtual TimePoint Now() override { return TimePoint(std::chrono::nanoseconds(m_Time.load())); }
+
+	virtual void SleepUntil(TimePoint deadline) override
+	{
+		int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+		if (time > m_Time)
+			m_Time = time;
+		m_Sleeps++;
+	}
+
+	virtual void WaitForWake() override
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+		m_Idle++;
+		m_Changed.notify_all();
+		m_Changed.wait(lk, [this] { return m_Woken; });
+		m_Woken = false;
+	}
+
+	virtual void Wake() override
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_Mutex);
+			m_Woken = true;
+		}
+		m_Changed.notify_all();
+	}
+
+	// Blocks until the scheduler went idle the given number of times
+	void WaitIdle(uint32_t count)
+	{
+		std::unique_lock<std::mutex> lk(m_Mutex);
+		m_Changed.wait(lk, [this, count] { return m_Idle >= count; });
+	}
+
+	uint32_t GetIdle()
+	{
+		std::lock_guard<std::mutex> lk(m_Mutex);
+		return m_Idle;
+	}
+
+	std::atomic_int64_t m_Time;
+	std::atomic_uint32_t m_Sleeps;
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_Changed;
+	uint32_t m_Idle;
+	bool m_Woken;
+};
+
+static const int64_t s_Period = 1000000000 / REV_HAPTICS_SAMPLE_RATE;
+
+static void AddSamples(HapticsBuffer& haptics, uint8_t level, int count)
+{
+	std::vector<uint8_t> samples(count, level);
+	ovrHapticsBuffer buffer = { samples.data(), count, ovrHapticsBufferSubmit_Enqueue };
+	haptics.AddSamples(&buffer);
+}
+
+// Collects the segments started for an output
+struct TestOutput
+{
+	HapticsBuffer Buffer;
+	std::mutex Mutex;
+	std::vector<HapticsSegment> Segments;
+
+	HapticsScheduler::VibrateFunc Vibrate()
+	{
+		return [this](const HapticsSegment& segment)
+		{
+			std::lock_guard<std::mutex> lk(Mutex);
+			Segments.push_back(segment);
+		};
+	}
+};
+
+// A steady signal is coalesced into the longest segments the envelope allows, and the outputs are
+// all served by the same ticks at the sample rate
+TEST(HapticsScheduler_Coalescing)
+{
+	TestClock* clock = new TestClock();
+	HapticsScheduler scheduler((std::unique_ptr<HapticsClock>(clock)));
+	HapticsEnvelope envelope = { 8, 32, 8, false };
+
+	TestOutput outputs[2];
+	scheduler.AddOutput(&outputs[0].Buffer, envelope, outputs[0].Vibrate());
+	scheduler.AddOutput(&outputs[1].Buffer, envelope, outputs[1].Vibrate());
+	clock->WaitIdle(1);
+
+	AddSamples(outputs[0].Buffer, 200, 64);
+	AddSamples(outputs[1].Buffer, 100, 64);
+	int64_t start = clock->m_Time;
+	scheduler.Wake();
+	clock->WaitIdle(2);
+
+	CHECK(clock->m_Sleeps == 64);
+	CHECK(clock->m_Time - start == 64 * s_Period);
+	for (TestOutput& output : outputs)
+	{
+		CHECK(output.Buffer.GetState().SamplesQueued == 0);
+		CHECK(output.Segments.size() == 2);
+		CHECK(output.Segments[0].Samples == 32 && output.Segments[1].Samples == 32);
+	}
+	CHECK(fabsf(outputs[0].Segments[0].Amplitude - 200 / 255.0f) < 1e-3f);
+	CHECK(fabsf(outputs[1].Segments[1].Amplitude - 100 / 255.0f) < 1e-3f);
+
+	// A change in level starts a new segment
+	AddSamples(outputs[0].Buffer, 200, 16);
+	AddSamples(outputs[0].Buffer, 50, 16);
+	scheduler.Wake();
+	clock->WaitIdle(3);
+	CHECK(outputs[0].Segments.size() == 4);
+	CHECK(outputs[0].Segments[2].Samples == 16 && outputs[0].Segments[3].Samples == 16);
+
+	scheduler.RemoveOutput(&outputs[0].Buffer);
+	scheduler.RemoveOutput(&outputs[1].Buffer);
+}
+
+// Without samples the scheduler doesn't tick, a wake only checks the buffers once
+TEST(HapticsScheduler_Idle)
+{
+	TestClock* clock = new TestClock();
+	HapticsScheduler scheduler((std::unique_ptr<HapticsClock>(clock)));
+	HapticsEnvelope envelope = { 1, 1, 0, false };
+
+	TestOutput output;
+	scheduler.AddOutput(&output.Buffer, envelope, output.Vibrate());
+	clock->WaitIdle(1);
+
+	scheduler.Wake();
+	clock->WaitIdle(2);
+	CHECK(clock->m_Sleeps == 0);
+	CHECK(clock->m_Time == 0);
+	CHECK(output.Segments.empty());
+
+	// Silent samples are consumed at the sample rate, but don't vibrate
+	AddSamples(output.Buffer, 0, 10);
+	scheduler.Wake();
+	clock->WaitIdle(3);
+	CHECK(clock->m_Sleeps == 10);
+	CHECK(output.Segments.empty());
+	CHECK(output.Buffer.GetState().SamplesQueued == 0);
+
+	// The thread stops with the last output, and starts again with the next one
+	scheduler.RemoveOutput(&output.Buffer);
+	CHECK(clock->GetIdle() == 3);
+	scheduler.AddOutput(&output.Buffer, envelope, output.Vibrate());
+	clock->WaitIdle(4);
+	scheduler.RemoveOutput(&output.Buffer);
+}
+
+// RemoveOutput has to wait for a callback that's running, and the callback is never called again
+TEST(HapticsScheduler_RemoveDuringDispatch)
+{
+	TestClock* clock = new TestClock();
+	HapticsScheduler scheduler((std::unique_ptr<HapticsClock>(clock)));
+	HapticsEnvelope envelope = { 1, 1, 0, false };
+
+	HapticsBuffer blocked;
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool dispatching = false, release = false;
+	std::atomic_uint32_t calls(0);
+	scheduler.AddOutput(&blocked, envelope, [&](const HapticsSegment&)
+	{
+		calls++;
+		std::unique_lock<std::mutex> lk(mutex);
+		dispatching = true;
+		changed.notify_all();
+		changed.wait(lk, [&] { return release; });
+	});
+
+	// A second output keeps the thread running after the first one is removed
+	TestOutput other;
+	scheduler.AddOutput(&other.Buffer, envelope, other.Vibrate());
+	clock->WaitIdle(1);
+
+	AddSamples(blocked, 255, 1);
+	scheduler.Wake();
+	{
+		std::unique_lock<std::mutex> lk(mutex);
+		changed.wait(lk, [&] { return dispatching; });
+	}
+
+	std::atomic_bool removed(false);
+	std::thread remover([&]()
+	{
+		scheduler.RemoveOutput(&blocked);
+		removed = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	bool removedEarly = removed;
+	{
+		std::lock_guard<std::mutex> lk(mutex);
+		release = true;
+	}
+	changed.notify_all();
+	remover.join();
+	CHECK(!removedEarly);
+	CHECK(removed);
+
+	// The removed output isn't played anymore, the remaining one still is
+	clock->WaitIdle(2);
+	AddSamples(blocked, 255, 4);
+	AddSamples(other.Buffer, 255, 4);
+	scheduler.Wake();
+	clock->WaitIdle(3);
+	CHECK(calls == 1);
+	CHECK(other.Segments.size() == 4);
+	CHECK(blocked.GetState().SamplesQueued == 4);
+
+	scheduler.RemoveOutput(&other.Buffer);
+}
@@ -0,0 +1,106 @@
+#include "Test.h"
+#include "Json.h"
+
+#include <stdio.h>
+#include <string>
+
+TEST(Json_Scalars)
+{
+	JsonValue value;
+	CHECK(JsonValue::Parse("true", &value) && value.IsBool() && value.Bool());
+	CHECK(JsonValue::Parse(" false ", &value) && value.IsBool() && !value.Bool());
+	CHECK(JsonValue::Parse("null", &value) && value.GetType() == JsonValue::TYPE_NULL);
+	CHECK(JsonValue::Parse("-12.5e1", &value) && value.IsNumber() && value.Number() == -125.0);
+	CHECK(JsonValue::Parse("\"text\"", &value) && value.IsString() && value.String() == "text");
+}
+
+TEST(Json_Escapes)
+{
+	JsonValue value;
+	CHECK(JsonValue::Parse("\"a\\\"b\\\\c\\/d\\n\\t\"", &value));
+	CHECK(value.String() == "a\"b\\c/d\n\t");
+
+	// Only ASCII code points are decoded
+	CHECK(JsonValue::Parse("\"\\u0041\\u00e9\"", &value));
+	CHECK(value.String() == "A?");
+
+	CHECK(!JsonValue::Parse("\"\\u00g1\"", &value));
+	CHECK(!JsonValue::Parse("\"\\x\"", &value));
+	CHECK(!JsonValue::Parse("\"unterminated", &value));
+}
+
+TEST(Json_Containers)
+{
+	JsonValue root;
+	CHECK(JsonValue::Parse("{ \"list\": [1, \"two\", [], {}], \"nested\": { \"flag\": true } }", &root));
+	CHECK(root.IsObject());
+	CHECK(root.MemberCount() == 2);
+	CHECK(root.GetKey(0) == "list");
+
+	const JsonValue* list = root.Find("list");
+	CHECK(list && list->IsArray() && list->Size() == 4);
+	CHECK((*list)[0].Number() == 1.0);
+	CHECK((*list)[1].String() == "two");
+	CHECK((*list)[2].IsArray() && (*list)[2].Size() == 0);
+	CHECK((*list)[3].IsObject() && (*list)[3].MemberCount() == 0);
+
+	const JsonValue* nested = root.Find("nested");
+	CHECK(nested && nested->GetBool("flag", false));
+	CHECK(!root.Find("missing"));
+	CHECK(!(*list)[0].Find("list"));
+}
+
+TEST(Json_Fallbacks)
+{
+	// The typed getters fall back if the member is missing or has a different type
+	JsonValue root;
+	CHECK(JsonValue::Parse("{ \"number\": 1, \"string\": \"s\", \"bool\": true }", &root));
+	CHECK(root.GetNumber("number", 0.0) == 1.0);
+	CHECK(root.GetNumber("string", 2.0) == 2.0);
+	CHECK(root.GetString("string", "") == "s");
+	CHECK(root.GetString("bool", "fallback") == "fallback");
+	CHECK(root.GetBool("bool", false));
+	CHECK(!root.GetBool("missing", false));
+}
+
+TEST(Json_Malformed)
+{
+	JsonValue value;
+	CHECK(!JsonValue::Parse("", &value));
+	CHECK(!JsonValue::Parse("{ \"key\" 1 }", &value));
+	CHECK(!JsonValue::Parse("{ \"key\": 1, }", &value));
+	CHECK(!JsonValue::Parse("[1, 2", &value));
+	CHECK(!JsonValue::Parse("[1 2]", &value));
+	CHECK(!JsonValue::Parse("{ key: 1 }", &value));
+	CHECK(!JsonValue::Parse("tru", &value));
+	CHECK(!JsonValue::Parse("-", &value));
+	CHECK(!JsonValue::Parse("{} {}", &value));
+}
+
+TEST(Json_Depth)
+{
+	// Deeply nested documents are rejected instead of overflowing the stack
+	JsonValue value;
+	std::string shallow = std::string(10, '[') + std::string(10, ']');
+	CHECK(JsonValue::Parse(shallow.c_str(), &value));
+
+	std::string deep = std::string(1000, '[') + std::string(1000, ']');
+	CHECK(!JsonValue::Parse(deep.c_str(), &value));
+}
+
+TEST(Json_ParseFile)
+{
+	// Files saved by Notepad start with a byte order mark
+	const char* path = "JsonTest.json";
+	FILE* file = fopen(path, "wb");
+	CHECK(file);
+	fputs("\xEF\xBB\xBF{ \"version\": 1 }\r\n", file);
+	fclose(file);
+
+	JsonValue root;
+	bool parsed = JsonValue::ParseFile(path, &root);
+	remove(path);
+	CHECK(parsed);
+	CHECK(root.GetNumber("version", 0.0) == 1.0);
+	CHECK(!JsonValue::ParseFile("JsonTestMissing.json", &root));
+}
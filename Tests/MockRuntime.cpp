@@ -0,0 +1,339 @@
+#include "MockRuntime.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// Maximum number of layers a frame can submit, like most runtimes
+#define MOCK_MAX_LAYERS 16
+
+struct XrSwapchain_T
+{
+	uint32_t Length;
+	std::atomic_uint64_t Acquired;
+	std::atomic_uint64_t Waited;
+	std::atomic_uint64_t Released;
+
+	// The application has to synchronize the calls on a swapchain, so they should never overlap
+	std::atomic_bool Busy;
+};
+
+struct XrSession_T
+{
+	// The frame calls may come from different threads, but they're serialized
+	std::mutex Mutex;
+	int64_t DisplayPeriod;
+	std::chrono::steady_clock::time_point Start;
+	uint64_t Waited;
+	uint64_t Begun;
+	uint64_t Ended;
+	uint64_t Layers;
+};
+
+// Spaces have no state, the handle only has to be valid
+struct XrSpace_T
+{
+};
+
+static std::atomic_uint64_t s_Errors(0);
+static std::atomic_uint32_t s_MinWaitTime(0);
+static std::atomic_uint32_t s_MaxWaitTime(0);
+
+// Marks a swapchain as busy for the duration of a call
+class SwapchainCall
+{
+public:
+	SwapchainCall(XrSwapchain swapchain) : m_Swapchain(swapchain)
+	{
+		if (m_Swapchain->Busy.exchange(true))
+			s_Errors++;
+	}
+	~SwapchainCall() { m_Swapchain->Busy = false; }
+
+private:
+	XrSwapchain m_Swapchain;
+};
+
+static void Spin(uint32_t microseconds)
+{
+	auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+	while (std::chrono::steady_clock::now() < end)
+		;
+}
+
+XrSwapchain MockRuntime::CreateSwapchain(uint32_t length)
+{
+	XrSwapchain swapchain = new XrSwapchain_T();
+	swapchain->Length = length;
+	swapchain->Acquired = 1;
+	swapchain->Waited = 1;
+	swapchain->Released = 0;
+	swapchain->Busy = false;
+	return swapchain;
+}
+
+void MockRuntime::DestroySwapchain(XrSwapchain swapchain)
+{
+	if (swapchain->Busy)
+		s_Errors++;
+	delete swapchain;
+}
+
+MockRuntime::SwapchainStats MockRuntime::GetSwapchainStats(XrSwapchain swapchain)
+{
+	SwapchainStats stats = { swapchain->Acquired, swapchain->Waited, swapchain->Released };
+	return stats;
+}
+
+XrSession MockRuntime::CreateSession(int64_t displayPeriod)
+{
+	XrSession session = new XrSession_T();
+	session->DisplayPeriod = displayPeriod;
+	session->Start = std::chrono::steady_clock::now();
+	session->Waited = 0;
+	session->Begun = 0;
+	session->Ended = 0;
+	session->Layers = 0;
+	return session;
+}
+
+void MockRuntime::DestroySession(XrSession session)
+{
+	delete session;
+}
+
+MockRuntime::FrameStats MockRuntime::GetFrameStats(XrSession session)
+{
+	std::lock_guard<std::mutex> lk(session->Mutex);
+	FrameStats stats = { session->Waited, session->Begun, session->Ended, session->Layers };
+	return stats;
+}
+
+XrSpace MockRuntime::CreateSpace()
+{
+	return new XrSpace_T();
+}
+
+void MockRuntime::DestroySpace(XrSpace space)
+{
+	delete space;
+}
+
+void MockRuntime::SetImageWaitTime(uint32_t minTime, uint32_t maxTime)
+{
+	s_MinWaitTime = minTime;
+	s_MaxWaitTime = maxTime;
+}
+
+uint64_t MockRuntime::GetErrors()
+{
+	return s_Errors;
+}
+
+void MockRuntime::Reset()
+{
+	s_Errors = 0;
+	s_MinWaitTime = 0;
+	s_MaxWaitTime = 0;
+}
+
+XrResult xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index)
+{
+	if (!swapchain || !acquireInfo || !index)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	SwapchainCall call(swapchain);
+
+	// All images are acquired and none have been released yet
+	if (swapchain->Acquired - swapchain->Released >= swapchain->Length)
+	{
+		s_Errors++;
+		return XR_ERROR_CALL_ORDER_INVALID;
+	}
+
+	*index = (uint32_t)(swapchain->Acquired++ % swapchain->Length);
+	return XR_SUCCESS;
+}
+
+XrResult xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo)
+{
+	if (!swapchain || !waitInfo)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	SwapchainCall call(swapchain);
+
+	// Only the oldest acquired image can be waited on, and only after the previous waited image was released
+	if (swapchain->Waited >= swapchain->Acquired || swapchain->Waited > swapchain->Released)
+	{
+		s_Errors++;
+		return XR_ERROR_CALL_ORDER_INVALID;
+	}
+
+	uint32_t minTime = s_MinWaitTime, maxTime = s_MaxWaitTime;
+	if (maxTime > 0)
+	{
+		thread_local std::minstd_rand random;
+		Spin(minTime + (uint32_t)(random() % (maxTime - minTime + 1)));
+	}
+
+	swapchain->Waited++;
+	return XR_SUCCESS;
+}
+
+XrResult xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo)
+{
+	if (!swapchain || !releaseInfo)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	SwapchainCall call(swapchain);
+
+	// Only a waited image can be released
+	if (swapchain->Released >= swapchain->Waited)
+	{
+		s_Errors++;
+		return XR_ERROR_CALL_ORDER_INVALID;
+	}
+
+	swapchain->Released++;
+	return XR_SUCCESS;
+}
+
+XrResult xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState)
+{
+	if (!session || !frameWaitInfo || !frameState)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	// A real runtime would block until the previous frame began, but that would deadlock a single thread
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	int64_t period = session->DisplayPeriod > 0 ? session->DisplayPeriod : 11111111;
+	int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - session->Start).count();
+	int64_t next = (elapsed / period + 1) * period;
+	{
+		std::lock_guard<std::mutex> lk(session->Mutex);
+		if (session->Waited > session->Begun)
+		{
+			s_Errors++;
+			return XR_ERROR_CALL_ORDER_INVALID;
+		}
+		session->Waited++;
+	}
+
+	if (session->DisplayPeriod > 0)
+		std::this_thread::sleep_until(session->Start + std::chrono::nanoseconds(next));
+
+	frameState->predictedDisplayTime = next + period;
+	frameState->predictedDisplayPeriod = period;
+	frameState->shouldRender = 1;
+	return XR_SUCCESS;
+}
+
+XrResult xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo)
+{
+	if (!session || !frameBeginInfo)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	std::lock_guard<std::mutex> lk(session->Mutex);
+
+	// Every frame has to be waited on before it begins
+	if (session->Begun >= session->Waited)
+	{
+		s_Errors++;
+		return XR_ERROR_CALL_ORDER_INVALID;
+	}
+
+	// Beginning a frame while the previous one never ended discards it
+	bool discarded = session->Begun > session->Ended;
+	if (discarded)
+		session->Ended++;
+	session->Begun++;
+	return discarded ? XR_FRAME_DISCARDED : XR_SUCCESS;
+}
+
+static bool IsValidSubImage(const XrSwapchainSubImage& subImage)
+{
+	// An image of the swapchain has to be released before it can be displayed
+	return subImage.swapchain && subImage.swapchain->Released > 0 &&
+		subImage.imageRect.extent.width > 0 && subImage.imageRect.extent.height > 0;
+}
+
+static bool IsValidLayer(const XrCompositionLayerBaseHeader* layer)
+{
+	if (!layer || !layer->space)
+		return false;
+
+	switch (layer->type)
+	{
+	case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
+	{
+		const XrCompositionLayerProjection* projection = (const XrCompositionLayerProjection*)layer;
+		if (projection->viewCount != 2 || !projection->views)
+			return false;
+		for (uint32_t i = 0; i < projection->viewCount; i++)
+		{
+			if (!IsValidSubImage(projection->views[i].subImage))
+				return false;
+		}
+		return true;
+	}
+	case XR_TYPE_COMPOSITION_LAYER_QUAD:
+		return IsValidSubImage(((const XrCompositionLayerQuad*)layer)->subImage);
+	case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR:
+		return IsValidSubImage(((const XrCompositionLayerCylinderKHR*)layer)->subImage);
+	case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR:
+		return ((const XrCompositionLayerCubeKHR*)layer)->swapchain != XR_NULL_HANDLE;
+	default:
+		return false;
+	}
+}
+
+XrResult xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo)
+{
+	if (!session || !frameEndInfo || (frameEndInfo->layerCount > 0 && !frameEndInfo->layers))
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	std::lock_guard<std::mutex> lk(session->Mutex);
+
+	if (session->Ended >= session->Begun)
+	{
+		s_Errors++;
+		return XR_ERROR_CALL_ORDER_INVALID;
+	}
+
+	if (frameEndInfo->layerCount > MOCK_MAX_LAYERS)
+	{
+		s_Errors++;
+		return XR_ERROR_LAYER_LIMIT_EXCEEDED;
+	}
+
+	for (uint32_t i = 0; i < frameEndInfo->layerCount; i++)
+	{
+		if (!IsValidLayer(frameEndInfo->layers[i]))
+		{
+			s_Errors++;
+			return XR_ERROR_LAYER_INVALID;
+		}
+	}
+
+	session->Ended++;
+	session->Layers += frameEndInfo->layerCount;
+	return XR_SUCCESS;
+}
+
+XrResult xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location)
+{
+	if (!space || !baseSpace || !location || time <= 0)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+		XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+	location->pose.orientation.x = 0.0f;
+	location->pose.orientation.y = 0.0f;
+	location->pose.orientation.z = 0.0f;
+	location->pose.orientation.w = 1.0f;
+	location->pose.position.x = 0.0f;
+	location->pose.position.y = 0.0f;
+	location->pose.position.z = 0.0f;
+	return XR_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// A headless OpenXR runtime for the tests. It implements the calls made by the units under test and
+// counts every call that's made out of order, or concurrently with another call on the same handle.
+#include <openxr/openxr.h>
+#include <stdint.h>
+
+namespace MockRuntime
+{
+	// Creates a swapchain with one image acquired and waited on, like a swapchain ReviveXR just created
+	XrSwapchain CreateSwapchain(uint32_t length = 3);
+	void DestroySwapchain(XrSwapchain swapchain);
+
+	struct SwapchainStats
+	{
+		uint64_t Acquired;
+		uint64_t Waited;
+		uint64_t Released;
+	};
+	SwapchainStats GetSwapchainStats(XrSwapchain swapchain);
+
+	// Creates a session that's ready to run frames. Without a display period xrWaitFrame returns immediately,
+	// otherwise it blocks until the next period like a compositor.
+	XrSession CreateSession(int64_t displayPeriod = 0);
+	void DestroySession(XrSession session);
+
+	struct FrameStats
+	{
+		uint64_t Waited;
+		uint64_t Begun;
+		uint64_t Ended;
+		uint64_t Layers;	// Layers submitted by all frames
+	};
+	FrameStats GetFrameStats(XrSession session);
+
+	// Spaces are always located at the origin of their base space
+	XrSpace CreateSpace();
+	void DestroySpace(XrSpace space);
+
+	// xrWaitSwapchainImage spins for a random time in this range in microseconds, like a GPU finishing a frame
+	void SetImageWaitTime(uint32_t minTime, uint32_t maxTime);
+
+	// Number of invalid calls since the last reset
+	uint64_t GetErrors();
+
+	void Reset();
+}
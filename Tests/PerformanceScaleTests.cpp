@@ -0,0 +1,82 @@
+#include "Test.h"
+#include "PerformanceScale.h"
+
+#include <math.h>
+
+static const float FrameBudget = 1.0f / 90.0f;
+
+TEST(PerformanceScale_Initial)
+{
+	PerformanceScale scale;
+	CHECK(scale.GetScale() == 1.0f);
+
+	// Invalid timings are ignored
+	scale.AddFrame(0.0f, FrameBudget);
+	scale.AddFrame(0.005f, 0.0f);
+	CHECK(scale.GetScale() == 1.0f);
+}
+
+TEST(PerformanceScale_Converges)
+{
+	// An app using half of the budget can scale up until it uses the target fraction
+	PerformanceScale light;
+	for (int i = 0; i < 200; i++)
+		light.AddFrame(0.5f * FrameBudget, FrameBudget);
+	CHECK(fabsf(light.GetScale() - REV_PERF_SCALE_TARGET / 0.5f) < 0.1f);
+
+	// An app over the budget has to scale down
+	PerformanceScale heavy;
+	for (int i = 0; i < 200; i++)
+		heavy.AddFrame(1.2f * FrameBudget, FrameBudget);
+	CHECK(fabsf(heavy.GetScale() - REV_PERF_SCALE_TARGET / 1.2f) < 0.05f);
+}
+
+TEST(PerformanceScale_Clamped)
+{
+	PerformanceScale scale;
+	for (int i = 0; i < 200; i++)
+		scale.AddFrame(0.01f * FrameBudget, FrameBudget);
+	CHECK(scale.GetScale() == REV_PERF_SCALE_MAX);
+
+	for (int i = 0; i < 500; i++)
+		scale.AddFrame(10.0f * FrameBudget, FrameBudget);
+	CHECK(scale.GetScale() == REV_PERF_SCALE_MIN);
+}
+
+TEST(PerformanceScale_BacksOffFaster)
+{
+	// A sudden spike in the GPU time lowers the scale within a few frames,
+	// while a sudden drop only raises it slowly
+	PerformanceScale scale;
+	for (int i = 0; i < 200; i++)
+		scale.AddFrame(REV_PERF_SCALE_TARGET * FrameBudget, FrameBudget);
+	CHECK(scale.GetScale() == 1.0f);
+
+	int framesDown = 0;
+	while (scale.GetScale() >= 1.0f && framesDown < 100)
+	{
+		scale.AddFrame(1.5f * FrameBudget, FrameBudget);
+		framesDown++;
+	}
+
+	PerformanceScale other;
+	for (int i = 0; i < 200; i++)
+		other.AddFrame(REV_PERF_SCALE_TARGET * FrameBudget, FrameBudget);
+	int framesUp = 0;
+	while (other.GetScale() <= 1.0f && framesUp < 100)
+	{
+		other.AddFrame(0.3f * FrameBudget, FrameBudget);
+		framesUp++;
+	}
+
+	CHECK(framesDown < framesUp);
+}
+
+TEST(PerformanceScale_Hysteresis)
+{
+	// Small fluctuations around the target don't change the reported scale
+	PerformanceScale scale;
+	for (int i = 0; i < 200; i++)
+		scale.AddFrame(REV_PERF_SCALE_TARGET * FrameBudget * (i % 2 ? 1.02f : 0.98f), FrameBudget);
+	CHECK(scale.GetScale() == 1.0f);
+}
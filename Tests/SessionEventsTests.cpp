@@ -0,0 +1,101 @@
+#include "Test.h"
+#include "Revive/SessionEvents.h"
+
+#include <vector>
+
+// The class of each device in the synthetic streams
+static vr::ETrackedDeviceClass DeviceClass(vr::TrackedDeviceIndex_t index)
+{
+	if (index == vr::k_unTrackedDeviceIndex_Hmd)
+		return vr::TrackedDeviceClass_HMD;
+	if (index < 3)
+		return vr::TrackedDeviceClass_Controller;
+	if (index < 5)
+		return vr::TrackedDeviceClass_TrackingReference;
+	return vr::TrackedDeviceClass_GenericTracker;
+}
+
+static vr::VREvent_t Event(vr::EVREventType type, vr::TrackedDeviceIndex_t index = vr::k_unTrackedDeviceIndex_Hmd)
+{
+	vr::VREvent_t event = {};
+	event.eventType = type;
+	event.trackedDeviceIndex = index;
+	return event;
+}
+
+// Handles a batch of events the same way the session thread does, and counts the device class queries
+static SessionEventBatch Poll(const std::vector<vr::VREvent_t>& events, int* queries = nullptr)
+{
+	SessionEventBatch batch = {};
+	for (const vr::VREvent_t& event : events)
+	{
+		vr::ETrackedDeviceClass deviceClass = vr::TrackedDeviceClass_Invalid;
+		if (NeedsDeviceClass(event))
+		{
+			deviceClass = DeviceClass(event.trackedDeviceIndex);
+			if (queries)
+				(*queries)++;
+		}
+		AddSessionEvent(batch, event, deviceClass);
+	}
+	return batch;
+}
+
+// A burst of device changes is coalesced into a single update of each kind
+TEST(SessionEvents_Coalescing)
+{
+	int queries = 0;
+	SessionEventBatch batch = Poll({
+		Event(vr::VREvent_TrackedDeviceActivated, 1),
+		Event(vr::VREvent_TrackedDeviceActivated, 2),
+		Event(vr::VREvent_TrackedDeviceRoleChanged, 1),
+		Event(vr::VREvent_TrackedDeviceActivated, 3),
+		Event(vr::VREvent_TrackedDeviceDeactivated, 4),
+		Event(vr::VREvent_DashboardActivated),
+	}, &queries);
+	CHECK(batch.Received);
+	CHECK(batch.UpdateControllers);
+	CHECK(batch.UpdateTrackers);
+	CHECK(queries == 4);
+
+	// Generic trackers and status events don't need a device update
+	batch = Poll({
+		Event(vr::VREvent_TrackedDeviceActivated, 5),
+		Event(vr::VREvent_TrackedDeviceUserInteractionStarted),
+		Event(vr::VREvent_InputFocusChanged),
+		Event(vr::VREvent_SceneApplicationChanged),
+		Event(vr::VREvent_Quit),
+	});
+	CHECK(batch.Received);
+	CHECK(!batch.UpdateControllers && !batch.UpdateTrackers);
+
+	// A role change alone updates the controllers without querying the device class
+	queries = 0;
+	batch = Poll({ Event(vr::VREvent_TrackedDeviceRoleChanged, 2) }, &queries);
+	CHECK(batch.UpdateControllers && !batch.UpdateTrackers);
+	CHECK(queries == 0);
+
+	batch = Poll({});
+	CHECK(!batch.Received && !batch.UpdateControllers && !batch.UpdateTrackers);
+}
+
+// The interval backs off to the maximum while no events arrive and resets as soon as one does
+TEST(SessionEvents_PollInterval)
+{
+	uint32_t interval = REV_EVENT_POLL_MIN_INTERVAL;
+	std::vector<uint32_t> intervals;
+	for (int i = 0; i < 8; i++)
+	{
+		interval = GetEventPollInterval(interval, false);
+		intervals.push_back(interval);
+	}
+	CHECK(intervals == std::vector<uint32_t>({ 2, 4, 8, 16, 32, 50, 50, 50 }));
+
+	interval = GetEventPollInterval(interval, Poll({ Event(vr::VREvent_TrackedDeviceActivated, 1) }).Received);
+	CHECK(interval == REV_EVENT_POLL_MIN_INTERVAL);
+	interval = GetEventPollInterval(interval, Poll({}).Received);
+	CHECK(interval == 2 * REV_EVENT_POLL_MIN_INTERVAL);
+
+	// The interval never reaches zero
+	CHECK(GetEventPollInterval(0, false) > 0);
+}
@@ -0,0 +1,140 @@
+#include "Test.h"
+#include "SpikeDetector.h"
+
+#include <stdio.h>
+
+static const char* CapturePath = "SpikeDetectorTest.bin";
+static const char* SecondCapturePath = "SpikeDetectorTest.1.bin";
+
+// Submits frames with a fixed interval in microseconds, returns the number of spikes
+static int SubmitFrames(SpikeDetector& detector, int64_t& now, long long& frameIndex, int count, int64_t interval)
+{
+	int spikes = 0;
+	int64_t ticks = interval * SpikeDetector::GetFrequency() / 1000000;
+	for (int i = 0; i < count; i++)
+	{
+		now += ticks;
+		if (detector.EndFrame(frameIndex++, 1, now))
+			spikes++;
+	}
+	return spikes;
+}
+
+static bool ReadCapture(const char* path, SpikeFileHeader& header, SpikeFrame* frames)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	bool read = fread(&header, sizeof(header), 1, file) == 1 &&
+		header.FrameCount <= REV_SPIKE_FRAMES &&
+		fread(frames, sizeof(SpikeFrame), header.FrameCount, file) == header.FrameCount;
+	fclose(file);
+	return read;
+}
+
+TEST(SpikeDetector_Disabled)
+{
+	SpikeDetector detector(nullptr, REV_SPIKE_DEFAULT_PERCENTILE);
+	CHECK(!detector.IsEnabled());
+
+	int64_t now = SpikeDetector::GetTimestamp();
+	long long frameIndex = 0;
+	CHECK(SubmitFrames(detector, now, frameIndex, 200, 11111) == 0);
+	CHECK(SubmitFrames(detector, now, frameIndex, 1, 100000) == 0);
+}
+
+TEST(SpikeDetector_SteadyFrames)
+{
+	// Jitter below the margin never counts as a spike
+	SpikeDetector detector(CapturePath, REV_SPIKE_DEFAULT_PERCENTILE);
+	int64_t now = SpikeDetector::GetTimestamp();
+	long long frameIndex = 0;
+	int spikes = 0;
+	for (int i = 0; i < 500; i++)
+		spikes += SubmitFrames(detector, now, frameIndex, 1, i % 2 ? 11111 : 13000);
+	CHECK(spikes == 0);
+}
+
+TEST(SpikeDetector_Capture)
+{
+	remove(CapturePath);
+	{
+		SpikeDetector detector(CapturePath, REV_SPIKE_DEFAULT_PERCENTILE);
+		CHECK(detector.IsEnabled());
+
+		// No spikes are detected until enough intervals are measured
+		int64_t now = SpikeDetector::GetTimestamp();
+		long long frameIndex = 0;
+		CHECK(SubmitFrames(detector, now, frameIndex, 1, 11111) == 0);
+		CHECK(SubmitFrames(detector, now, frameIndex, 10, 11111) == 0);
+		CHECK(SubmitFrames(detector, now, frameIndex, 1, 50000) == 0);
+
+		CHECK(SubmitFrames(detector, now, frameIndex, 300, 11111) == 0);
+		detector.CountCommit();
+		detector.CountCommit();
+		detector.CountTrackingQuery();
+		detector.CountInputQuery();
+		detector.AddCallTime(SpikeDetector::CALL_END, 0, 2 * SpikeDetector::GetFrequency() / 1000);
+		CHECK(SubmitFrames(detector, now, frameIndex, 1, 30000) == 1);
+
+		// A spike during the cooldown isn't captured
+		CHECK(SubmitFrames(detector, now, frameIndex, 1, 30000) == 0);
+	}
+
+	// The detector waits for the capture to be written when it's destroyed
+	SpikeFileHeader header;
+	SpikeFrame frames[REV_SPIKE_FRAMES];
+	CHECK(ReadCapture(CapturePath, header, frames));
+	CHECK(header.Magic == REV_SPIKE_FILE_MAGIC);
+	CHECK(header.Version == REV_SPIKE_FILE_VERSION);
+	CHECK(header.FrameSize == sizeof(SpikeFrame));
+	CHECK(header.FrameCount == REV_SPIKE_FRAMES);
+	CHECK(header.Threshold == 11111);
+
+	// The spike is the newest frame in the capture
+	const SpikeFrame& spike = frames[REV_SPIKE_FRAMES - 1];
+	CHECK(spike.FrameIndex == 312);
+	CHECK(spike.Interval == 30000);
+	CHECK(spike.EndTime == 2000);
+	CHECK(spike.Layers == 1);
+	CHECK(spike.Commits == 2);
+	CHECK(spike.TrackingQueries == 1);
+	CHECK(spike.InputQueries == 1);
+	CHECK(frames[0].FrameIndex == spike.FrameIndex - REV_SPIKE_FRAMES + 1);
+	CHECK(frames[REV_SPIKE_FRAMES - 2].Interval == 11111);
+	CHECK(frames[REV_SPIKE_FRAMES - 2].Commits == 0);
+	remove(CapturePath);
+}
+
+TEST(SpikeDetector_Percentile)
+{
+	// With the median as the threshold, the slowest tenth of the frames counts as spikes
+	remove(CapturePath);
+	remove(SecondCapturePath);
+	{
+		SpikeDetector detector(CapturePath, 50.0);
+		int64_t now = SpikeDetector::GetTimestamp();
+		long long frameIndex = 0;
+		int spikes = 0;
+		for (int i = 0; i < 200; i++)
+			spikes += SubmitFrames(detector, now, frameIndex, 1, i % 10 ? 10000 : 14000);
+		CHECK(spikes == 1);
+		detector.Flush();
+
+		// The next spike after the cooldown gets a numbered file
+		for (int i = 0; i < REV_SPIKE_COOLDOWN_FRAMES; i++)
+			spikes += SubmitFrames(detector, now, frameIndex, 1, 10000);
+		CHECK(spikes == 1);
+		CHECK(SubmitFrames(detector, now, frameIndex, 1, 14000) == 1);
+	}
+
+	SpikeFileHeader header;
+	SpikeFrame frames[REV_SPIKE_FRAMES];
+	CHECK(ReadCapture(CapturePath, header, frames));
+	CHECK(header.Threshold == 10000);
+	CHECK(ReadCapture(SecondCapturePath, header, frames));
+	CHECK(frames[header.FrameCount - 1].Interval == 14000);
+	remove(CapturePath);
+	remove(SecondCapturePath);
+}
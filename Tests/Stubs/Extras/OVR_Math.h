@@ -0,0 +1,202 @@
+#pragma once
+
+// The subset of the LibOVR math library used by the units under test, with the same layout and
+// semantics as the real classes. Only used when the Oculus SDK isn't in Externals/LibOVR.
+#include "OVR_CAPI.h"
+
+#include <math.h>
+
+namespace OVR {
+
+template<class T>
+inline void OVRMath_Swap(T& a, T& b)
+{
+	T temp(a);
+	a = b;
+	b = temp;
+}
+
+template<class T>
+inline const T OVRMath_Min(const T a, const T b)
+{
+	return (a < b) ? a : b;
+}
+
+template<class T>
+inline const T OVRMath_Max(const T a, const T b)
+{
+	return (b < a) ? a : b;
+}
+
+template<class T>
+class Vector2
+{
+public:
+	T x, y;
+
+	Vector2() : x(0), y(0) { }
+	Vector2(T x_, T y_) : x(x_), y(y_) { }
+	Vector2(const ovrVector2i& s) : x((T)s.x), y((T)s.y) { }
+	Vector2(const ovrVector2f& s) : x((T)s.x), y((T)s.y) { }
+
+	operator ovrVector2i() const { return ovrVector2i{ (int)x, (int)y }; }
+	operator ovrVector2f() const { return ovrVector2f{ (float)x, (float)y }; }
+
+	Vector2 operator*(T s) const { return Vector2(x * s, y * s); }
+	T LengthSq() const { return x * x + y * y; }
+	T Length() const { return (T)sqrt((double)LengthSq()); }
+
+	static Vector2 Min(const Vector2& a, const Vector2& b) { return Vector2(OVRMath_Min(a.x, b.x), OVRMath_Min(a.y, b.y)); }
+	static Vector2 Max(const Vector2& a, const Vector2& b) { return Vector2(OVRMath_Max(a.x, b.x), OVRMath_Max(a.y, b.y)); }
+};
+
+typedef Vector2<float> Vector2f;
+typedef Vector2<int> Vector2i;
+
+template<class T>
+class Size
+{
+public:
+	T w, h;
+
+	Size() : w(0), h(0) { }
+	Size(T w_, T h_) : w(w_), h(h_) { }
+	Size(const ovrSizei& s) : w((T)s.w), h((T)s.h) { }
+
+	operator ovrSizei() const { return ovrSizei{ (int)w, (int)h }; }
+
+	static Size Min(const Size& a, const Size& b) { return Size(OVRMath_Min(a.w, b.w), OVRMath_Min(a.h, b.h)); }
+	static Size Max(const Size& a, const Size& b) { return Size(OVRMath_Max(a.w, b.w), OVRMath_Max(a.h, b.h)); }
+};
+
+typedef Size<int> Sizei;
+typedef Size<float> Sizef;
+
+template<class T>
+class Rect
+{
+public:
+	T x, y, w, h;
+
+	Rect() : x(0), y(0), w(0), h(0) { }
+	Rect(T x_, T y_, T w_, T h_) : x(x_), y(y_), w(w_), h(h_) { }
+	Rect(const Vector2<T>& pos, const Size<T>& sz) : x(pos.x), y(pos.y), w(sz.w), h(sz.h) { }
+	Rect(const ovrRecti& s) : x((T)s.Pos.x), y((T)s.Pos.y), w((T)s.Size.w), h((T)s.Size.h) { }
+
+	operator ovrRecti() const { return ovrRecti{ { (int)x, (int)y }, { (int)w, (int)h } }; }
+
+	Vector2<T> GetPos() const { return Vector2<T>(x, y); }
+	Size<T> GetSize() const { return Size<T>(w, h); }
+};
+
+typedef Rect<int> Recti;
+
+template<class T>
+class Vector3
+{
+public:
+	T x, y, z;
+
+	Vector3() : x(0), y(0), z(0) { }
+	Vector3(T x_, T y_, T z_) : x(x_), y(y_), z(z_) { }
+	Vector3(const ovrVector3f& s) : x((T)s.x), y((T)s.y), z((T)s.z) { }
+
+	operator ovrVector3f() const { return ovrVector3f{ (float)x, (float)y, (float)z }; }
+};
+
+typedef Vector3<float> Vector3f;
+
+template<class T>
+class Quat
+{
+public:
+	T x, y, z, w;
+
+	Quat() : x(0), y(0), z(0), w(1) { }
+	Quat(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) { }
+	Quat(const ovrQuatf& s) : x((T)s.x), y((T)s.y), z((T)s.z), w((T)s.w) { }
+
+	operator ovrQuatf() const { return ovrQuatf{ (float)x, (float)y, (float)z, (float)w }; }
+
+	static Quat Identity() { return Quat(0, 0, 0, 1); }
+};
+
+typedef Quat<float> Quatf;
+
+template<class T>
+class Pose
+{
+public:
+	Quat<T> Rotation;
+	Vector3<T> Translation;
+
+	Pose() { }
+	Pose(const Quat<T>& orientation, const Vector3<T>& pos) : Rotation(orientation), Translation(pos) { }
+	Pose(const ovrPosef& s) : Rotation(s.Orientation), Translation(s.Position) { }
+
+	operator ovrPosef() const { return ovrPosef{ Rotation, Translation }; }
+
+	static Pose Identity() { return Pose(Quat<T>(0, 0, 0, 1), Vector3<T>(0, 0, 0)); }
+};
+
+typedef Pose<float> Posef;
+
+template<class T>
+class Matrix4
+{
+public:
+	T M[4][4];
+
+	Matrix4()
+	{
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				M[i][j] = (i == j) ? T(1) : T(0);
+	}
+
+	Matrix4(const ovrMatrix4f& s)
+	{
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				M[i][j] = (T)s.M[i][j];
+	}
+};
+
+typedef Matrix4<float> Matrix4f;
+
+struct ScaleAndOffset2D
+{
+	Vector2f Scale;
+	Vector2f Offset;
+
+	ScaleAndOffset2D(float sx = 0.0f, float sy = 0.0f, float ox = 0.0f, float oy = 0.0f)
+		: Scale(sx, sy), Offset(ox, oy) { }
+};
+
+class FovPort
+{
+public:
+	float UpTan;
+	float DownTan;
+	float LeftTan;
+	float RightTan;
+
+	FovPort(float sideTan = 0.0f) : UpTan(sideTan), DownTan(sideTan), LeftTan(sideTan), RightTan(sideTan) { }
+	FovPort(float u, float d, float l, float r) : UpTan(u), DownTan(d), LeftTan(l), RightTan(r) { }
+	FovPort(const ovrFovPort& s) : UpTan(s.UpTan), DownTan(s.DownTan), LeftTan(s.LeftTan), RightTan(s.RightTan) { }
+
+	operator ovrFovPort() const { return ovrFovPort{ UpTan, DownTan, LeftTan, RightTan }; }
+
+	float GetMaxSideTan() const { return OVRMath_Max(OVRMath_Max(UpTan, DownTan), OVRMath_Max(LeftTan, RightTan)); }
+
+	static ScaleAndOffset2D CreateNDCScaleAndOffsetFromFov(FovPort tanHalfFov)
+	{
+		float projXScale = 2.0f / (tanHalfFov.LeftTan + tanHalfFov.RightTan);
+		float projXOffset = (tanHalfFov.LeftTan - tanHalfFov.RightTan) * projXScale * 0.5f;
+		float projYScale = 2.0f / (tanHalfFov.UpTan + tanHalfFov.DownTan);
+		float projYOffset = (tanHalfFov.UpTan - tanHalfFov.DownTan) * projYScale * 0.5f;
+		return ScaleAndOffset2D(projXScale, projYScale, projXOffset, projYOffset);
+	}
+};
+
+} // namespace OVR
@@ -0,0 +1,4 @@
+#pragma once
+
+// None of the stereo projection helpers are used by the units under test
+#include "Extras/OVR_Math.h"
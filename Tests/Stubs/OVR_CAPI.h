@@ -0,0 +1,301 @@
+#pragma once
+
+// The subset of the LibOVR declarations used by the units under test. This header is only used
+// when the Oculus SDK isn't in Externals/LibOVR, so the tests can also build on Linux.
+#include <stdint.h>
+
+#define OVR_ALIGNAS(n) alignas(n)
+#define OVR_PTR_SIZE sizeof(void*)
+
+typedef char ovrBool;
+#define ovrFalse 0
+#define ovrTrue 1
+
+typedef int32_t ovrResult;
+#define OVR_SUCCESS(result) (result >= 0)
+#define OVR_FAILURE(result) (!OVR_SUCCESS(result))
+
+typedef enum ovrSuccessType_
+{
+	ovrSuccess = 0
+} ovrSuccessType;
+
+typedef enum ovrErrorType_
+{
+	ovrError_MemoryAllocationFailure = -1000,
+	ovrError_InvalidSession = -1002,
+	ovrError_Timeout = -1003,
+	ovrError_NotInitialized = -1004,
+	ovrError_InvalidParameter = -1005,
+	ovrError_ServiceError = -1006,
+	ovrError_NoHmd = -1007,
+	ovrError_Unsupported = -1009,
+	ovrError_InvalidOperation = -1015
+} ovrErrorType;
+
+// Math
+typedef struct OVR_ALIGNAS(4) ovrVector2i_ { int x, y; } ovrVector2i;
+typedef struct OVR_ALIGNAS(4) ovrSizei_ { int w, h; } ovrSizei;
+typedef struct OVR_ALIGNAS(4) ovrRecti_ { ovrVector2i Pos; ovrSizei Size; } ovrRecti;
+typedef struct OVR_ALIGNAS(4) ovrQuatf_ { float x, y, z, w; } ovrQuatf;
+typedef struct OVR_ALIGNAS(4) ovrVector2f_ { float x, y; } ovrVector2f;
+typedef struct OVR_ALIGNAS(4) ovrVector3f_ { float x, y, z; } ovrVector3f;
+typedef struct OVR_ALIGNAS(4) ovrMatrix4f_ { float M[4][4]; } ovrMatrix4f;
+typedef struct OVR_ALIGNAS(4) ovrPosef_ { ovrQuatf Orientation; ovrVector3f Position; } ovrPosef;
+typedef struct OVR_ALIGNAS(4) ovrFovPort_ { float UpTan; float DownTan; float LeftTan; float RightTan; } ovrFovPort;
+
+typedef enum ovrEyeType_
+{
+	ovrEye_Left = 0,
+	ovrEye_Right = 1,
+	ovrEye_Count = 2
+} ovrEyeType;
+
+typedef enum ovrHandType_
+{
+	ovrHand_Left = 0,
+	ovrHand_Right = 1,
+	ovrHand_Count = 2
+} ovrHandType;
+
+// Sessions and swapchains
+typedef struct ovrHmdStruct* ovrSession;
+typedef struct ovrTextureSwapChainData* ovrTextureSwapChain;
+typedef struct ovrMirrorTextureData* ovrMirrorTexture;
+
+typedef enum ovrTextureType_
+{
+	ovrTexture_2D,
+	ovrTexture_2D_External,
+	ovrTexture_Cube
+} ovrTextureType;
+
+typedef enum ovrTextureFormat_
+{
+	OVR_FORMAT_UNKNOWN = 0,
+	OVR_FORMAT_R8G8B8A8_UNORM = 4,
+	OVR_FORMAT_R8G8B8A8_UNORM_SRGB = 5
+} ovrTextureFormat;
+
+typedef struct ovrTextureSwapChainDesc_
+{
+	ovrTextureType Type;
+	ovrTextureFormat Format;
+	int ArraySize;
+	int Width;
+	int Height;
+	int MipLevels;
+	int SampleCount;
+	ovrBool StaticImage;
+	OVR_ALIGNAS(4) unsigned int MiscFlags;
+	OVR_ALIGNAS(4) unsigned int BindFlags;
+} ovrTextureSwapChainDesc;
+
+typedef struct ovrMirrorTextureDesc_
+{
+	ovrTextureFormat Format;
+	int Width;
+	int Height;
+	unsigned int MiscFlags;
+	unsigned int MirrorOptions;
+} ovrMirrorTextureDesc;
+
+// Input
+typedef enum ovrButton_
+{
+	ovrButton_A = 0x00000001,
+	ovrButton_B = 0x00000002,
+	ovrButton_RThumb = 0x00000004,
+	ovrButton_RShoulder = 0x00000008,
+	ovrButton_X = 0x00000100,
+	ovrButton_Y = 0x00000200,
+	ovrButton_LThumb = 0x00000400,
+	ovrButton_LShoulder = 0x00000800,
+	ovrButton_Up = 0x00010000,
+	ovrButton_Down = 0x00020000,
+	ovrButton_Left = 0x00040000,
+	ovrButton_Right = 0x00080000,
+	ovrButton_Enter = 0x00100000,
+	ovrButton_Back = 0x00200000,
+	ovrButton_VolUp = 0x00400000,
+	ovrButton_VolDown = 0x00800000,
+	ovrButton_Home = 0x01000000
+} ovrButton;
+
+typedef enum ovrTouch_
+{
+	ovrTouch_A = ovrButton_A,
+	ovrTouch_B = ovrButton_B,
+	ovrTouch_RThumb = ovrButton_RThumb,
+	ovrTouch_RThumbRest = 0x00000008,
+	ovrTouch_RIndexTrigger = 0x00000010,
+	ovrTouch_X = ovrButton_X,
+	ovrTouch_Y = ovrButton_Y,
+	ovrTouch_LThumb = ovrButton_LThumb,
+	ovrTouch_LThumbRest = 0x00000800,
+	ovrTouch_LIndexTrigger = 0x00001000,
+	ovrTouch_RIndexPointing = 0x00000020,
+	ovrTouch_RThumbUp = 0x00000040,
+	ovrTouch_LIndexPointing = 0x00002000,
+	ovrTouch_LThumbUp = 0x00004000
+} ovrTouch;
+
+typedef enum ovrControllerType_
+{
+	ovrControllerType_None = 0x0000,
+	ovrControllerType_LTouch = 0x0001,
+	ovrControllerType_RTouch = 0x0002,
+	ovrControllerType_Touch = (ovrControllerType_LTouch | ovrControllerType_RTouch),
+	ovrControllerType_Remote = 0x0004,
+	ovrControllerType_XBox = 0x0010
+} ovrControllerType;
+
+typedef struct ovrInputState_
+{
+	double TimeInSeconds;
+	unsigned int Buttons;
+	unsigned int Touches;
+	float IndexTrigger[ovrHand_Count];
+	float HandTrigger[ovrHand_Count];
+	ovrVector2f Thumbstick[ovrHand_Count];
+	ovrControllerType ControllerType;
+	float IndexTriggerNoDeadzone[ovrHand_Count];
+	float HandTriggerNoDeadzone[ovrHand_Count];
+	ovrVector2f ThumbstickNoDeadzone[ovrHand_Count];
+	float IndexTriggerRaw[ovrHand_Count];
+	float HandTriggerRaw[ovrHand_Count];
+	ovrVector2f ThumbstickRaw[ovrHand_Count];
+} ovrInputState;
+
+// Haptics
+#define OVR_HAPTICS_BUFFER_SAMPLES_MAX 256
+
+typedef enum ovrHapticsBufferSubmitMode_
+{
+	ovrHapticsBufferSubmit_Enqueue
+} ovrHapticsBufferSubmitMode;
+
+typedef struct ovrHapticsBuffer_
+{
+	const void* Samples;
+	int SamplesCount;
+	ovrHapticsBufferSubmitMode SubmitMode;
+} ovrHapticsBuffer;
+
+typedef struct ovrHapticsPlaybackState_
+{
+	int RemainingQueueSpace;
+	int SamplesQueued;
+} ovrHapticsPlaybackState;
+
+// Layers
+enum { ovrMaxLayerCount = 16 };
+
+typedef enum ovrLayerType_
+{
+	ovrLayerType_Disabled = 0,
+	ovrLayerType_EyeFov = 1,
+	ovrLayerType_EyeFovDepth = 2,
+	ovrLayerType_Quad = 3,
+	ovrLayerType_EyeMatrix = 5,
+	ovrLayerType_EyeFovMultires = 7,
+	ovrLayerType_Cylinder = 8,
+	ovrLayerType_Cube = 10
+} ovrLayerType;
+
+typedef enum ovrLayerFlags_
+{
+	ovrLayerFlag_HighQuality = 0x01,
+	ovrLayerFlag_TextureOriginAtBottomLeft = 0x02,
+	ovrLayerFlag_HeadLocked = 0x04
+} ovrLayerFlags;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerHeader_
+{
+	ovrLayerType Type;
+	unsigned Flags;
+	char Reserved[128];
+} ovrLayerHeader;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerEyeFov_
+{
+	ovrLayerHeader Header;
+	ovrTextureSwapChain ColorTexture[ovrEye_Count];
+	ovrRecti Viewport[ovrEye_Count];
+	ovrFovPort Fov[ovrEye_Count];
+	ovrPosef RenderPose[ovrEye_Count];
+	double SensorSampleTime;
+} ovrLayerEyeFov;
+
+typedef struct OVR_ALIGNAS(4) ovrTimewarpProjectionDesc_
+{
+	float Projection22;
+	float Projection23;
+	float Projection32;
+} ovrTimewarpProjectionDesc;
+
+typedef struct OVR_ALIGNAS(4) ovrViewScaleDesc_
+{
+	ovrPosef HmdToEyePose[ovrEye_Count];
+	float HmdSpaceToWorldScaleInMeters;
+} ovrViewScaleDesc;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerEyeFovDepth_
+{
+	ovrLayerHeader Header;
+	ovrTextureSwapChain ColorTexture[ovrEye_Count];
+	ovrRecti Viewport[ovrEye_Count];
+	ovrFovPort Fov[ovrEye_Count];
+	ovrPosef RenderPose[ovrEye_Count];
+	double SensorSampleTime;
+	ovrTextureSwapChain DepthTexture[ovrEye_Count];
+	ovrTimewarpProjectionDesc ProjectionDesc;
+} ovrLayerEyeFovDepth;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerEyeMatrix_
+{
+	ovrLayerHeader Header;
+	ovrTextureSwapChain ColorTexture[ovrEye_Count];
+	ovrRecti Viewport[ovrEye_Count];
+	ovrPosef RenderPose[ovrEye_Count];
+	ovrMatrix4f Matrix[ovrEye_Count];
+	double SensorSampleTime;
+} ovrLayerEyeMatrix;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerQuad_
+{
+	ovrLayerHeader Header;
+	ovrTextureSwapChain ColorTexture;
+	ovrRecti Viewport;
+	ovrPosef QuadPoseCenter;
+	ovrVector2f QuadSize;
+} ovrLayerQuad;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerCylinder_
+{
+	ovrLayerHeader Header;
+	ovrTextureSwapChain ColorTexture;
+	ovrRecti Viewport;
+	ovrPosef CylinderPoseCenter;
+	float CylinderRadius;
+	float CylinderAngle;
+	float CylinderAspectRatio;
+} ovrLayerCylinder;
+
+typedef struct OVR_ALIGNAS(OVR_PTR_SIZE) ovrLayerCube_
+{
+	ovrLayerHeader Header;
+	ovrQuatf Orientation;
+	ovrTextureSwapChain CubeMapTexture;
+} ovrLayerCube;
+
+typedef union ovrLayer_Union_
+{
+	ovrLayerHeader Header;
+	ovrLayerEyeFov EyeFov;
+	ovrLayerEyeFovDepth EyeFovDepth;
+	ovrLayerEyeMatrix EyeMatrix;
+	ovrLayerQuad Quad;
+	ovrLayerCylinder Cylinder;
+	ovrLayerCube Cube;
+} ovrLayer_Union;
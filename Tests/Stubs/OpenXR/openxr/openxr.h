@@ -0,0 +1,303 @@
+#pragma once
+
+// The subset of the OpenXR 1.0 declarations used by the units under test. The tests never load an
+// OpenXR runtime, the functions declared here are implemented by the mock runtime in Tests/.
+#include <stdint.h>
+
+#define XR_NULL_HANDLE nullptr
+#define XR_NULL_PATH 0
+#define XR_NO_DURATION 0
+#define XR_INFINITE_DURATION 0x7fffffffffffffffLL
+
+#define XR_SUCCEEDED(result) ((result) >= 0)
+#define XR_FAILED(result) ((result) < 0)
+#define XR_UNQUALIFIED_SUCCESS(result) ((result) == 0)
+
+#define XR_DEFINE_HANDLE(object) typedef struct object##_T* object;
+
+typedef uint32_t XrBool32;
+typedef uint64_t XrFlags64;
+typedef int64_t XrTime;
+typedef int64_t XrDuration;
+typedef uint64_t XrVersion;
+typedef uint64_t XrPath;
+typedef uint64_t XrSystemId;
+
+XR_DEFINE_HANDLE(XrInstance)
+XR_DEFINE_HANDLE(XrSession)
+XR_DEFINE_HANDLE(XrSpace)
+XR_DEFINE_HANDLE(XrSwapchain)
+XR_DEFINE_HANDLE(XrActionSet)
+XR_DEFINE_HANDLE(XrAction)
+
+typedef enum XrResult
+{
+	XR_SUCCESS = 0,
+	XR_TIMEOUT_EXPIRED = 1,
+	XR_SESSION_LOSS_PENDING = 3,
+	XR_EVENT_UNAVAILABLE = 4,
+	XR_SPACE_BOUNDS_UNAVAILABLE = 7,
+	XR_SESSION_NOT_FOCUSED = 8,
+	XR_FRAME_DISCARDED = 9,
+	XR_ERROR_VALIDATION_FAILURE = -1,
+	XR_ERROR_RUNTIME_FAILURE = -2,
+	XR_ERROR_OUT_OF_MEMORY = -3,
+	XR_ERROR_HANDLE_INVALID = -12,
+	XR_ERROR_SESSION_LOST = -17,
+	XR_ERROR_CALL_ORDER_INVALID = -37,
+	XR_ERROR_LAYER_INVALID = -23,
+	XR_ERROR_LAYER_LIMIT_EXCEEDED = -24,
+	XR_ERROR_SWAPCHAIN_RECT_INVALID = -25,
+	XR_RESULT_MAX_ENUM = 0x7FFFFFFF
+} XrResult;
+
+typedef enum XrStructureType
+{
+	XR_TYPE_UNKNOWN = 0,
+	XR_TYPE_SWAPCHAIN_CREATE_INFO = 9,
+	XR_TYPE_FRAME_END_INFO = 12,
+	XR_TYPE_FRAME_WAIT_INFO = 33,
+	XR_TYPE_COMPOSITION_LAYER_PROJECTION = 35,
+	XR_TYPE_COMPOSITION_LAYER_QUAD = 36,
+	XR_TYPE_SPACE_LOCATION = 42,
+	XR_TYPE_SPACE_VELOCITY = 43,
+	XR_TYPE_FRAME_STATE = 44,
+	XR_TYPE_FRAME_BEGIN_INFO = 46,
+	XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW = 48,
+	XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO = 55,
+	XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO = 56,
+	XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO = 57,
+	XR_TYPE_COMPOSITION_LAYER_CUBE_KHR = 1000006000,
+	XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR = 1000010000,
+	XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR = 1000017000,
+	XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR = 1000023000,
+	XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR = 1000027001,
+	XR_STRUCTURE_TYPE_MAX_ENUM = 0x7FFFFFFF
+} XrStructureType;
+
+typedef enum XrEyeVisibility
+{
+	XR_EYE_VISIBILITY_BOTH = 0,
+	XR_EYE_VISIBILITY_LEFT = 1,
+	XR_EYE_VISIBILITY_RIGHT = 2,
+	XR_EYE_VISIBILITY_MAX_ENUM = 0x7FFFFFFF
+} XrEyeVisibility;
+
+typedef enum XrEnvironmentBlendMode
+{
+	XR_ENVIRONMENT_BLEND_MODE_OPAQUE = 1,
+	XR_ENVIRONMENT_BLEND_MODE_ADDITIVE = 2,
+	XR_ENVIRONMENT_BLEND_MODE_ALPHA_BLEND = 3,
+	XR_ENVIRONMENT_BLEND_MODE_MAX_ENUM = 0x7FFFFFFF
+} XrEnvironmentBlendMode;
+
+typedef enum XrReferenceSpaceType
+{
+	XR_REFERENCE_SPACE_TYPE_VIEW = 1,
+	XR_REFERENCE_SPACE_TYPE_LOCAL = 2,
+	XR_REFERENCE_SPACE_TYPE_STAGE = 3,
+	XR_REFERENCE_SPACE_TYPE_MAX_ENUM = 0x7FFFFFFF
+} XrReferenceSpaceType;
+
+typedef XrFlags64 XrCompositionLayerFlags;
+static const XrCompositionLayerFlags XR_COMPOSITION_LAYER_CORRECT_CHROMATIC_ABERRATION_BIT = 0x00000001;
+static const XrCompositionLayerFlags XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT = 0x00000002;
+static const XrCompositionLayerFlags XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT = 0x00000004;
+
+typedef XrFlags64 XrSwapchainCreateFlags;
+static const XrSwapchainCreateFlags XR_SWAPCHAIN_CREATE_PROTECTED_CONTENT_BIT = 0x00000001;
+static const XrSwapchainCreateFlags XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT = 0x00000002;
+
+typedef XrFlags64 XrSwapchainUsageFlags;
+
+typedef XrFlags64 XrSpaceLocationFlags;
+static const XrSpaceLocationFlags XR_SPACE_LOCATION_ORIENTATION_VALID_BIT = 0x00000001;
+static const XrSpaceLocationFlags XR_SPACE_LOCATION_POSITION_VALID_BIT = 0x00000002;
+static const XrSpaceLocationFlags XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT = 0x00000004;
+static const XrSpaceLocationFlags XR_SPACE_LOCATION_POSITION_TRACKED_BIT = 0x00000008;
+
+// Math
+typedef struct XrVector2f { float x; float y; } XrVector2f;
+typedef struct XrVector3f { float x; float y; float z; } XrVector3f;
+typedef struct XrQuaternionf { float x; float y; float z; float w; } XrQuaternionf;
+typedef struct XrPosef { XrQuaternionf orientation; XrVector3f position; } XrPosef;
+typedef struct XrOffset2Di { int32_t x; int32_t y; } XrOffset2Di;
+typedef struct XrExtent2Di { int32_t width; int32_t height; } XrExtent2Di;
+typedef struct XrExtent2Df { float width; float height; } XrExtent2Df;
+typedef struct XrRect2Di { XrOffset2Di offset; XrExtent2Di extent; } XrRect2Di;
+typedef struct XrFovf { float angleLeft; float angleRight; float angleUp; float angleDown; } XrFovf;
+
+// Swapchains
+typedef struct XrSwapchainCreateInfo
+{
+	XrStructureType type;
+	const void* next;
+	XrSwapchainCreateFlags createFlags;
+	XrSwapchainUsageFlags usageFlags;
+	int64_t format;
+	uint32_t sampleCount;
+	uint32_t width;
+	uint32_t height;
+	uint32_t faceCount;
+	uint32_t arraySize;
+	uint32_t mipCount;
+} XrSwapchainCreateInfo;
+
+typedef struct XrSwapchainImageBaseHeader
+{
+	XrStructureType type;
+	void* next;
+} XrSwapchainImageBaseHeader;
+
+typedef struct XrSwapchainImageAcquireInfo
+{
+	XrStructureType type;
+	const void* next;
+} XrSwapchainImageAcquireInfo;
+
+typedef struct XrSwapchainImageWaitInfo
+{
+	XrStructureType type;
+	const void* next;
+	XrDuration timeout;
+} XrSwapchainImageWaitInfo;
+
+typedef struct XrSwapchainImageReleaseInfo
+{
+	XrStructureType type;
+	const void* next;
+} XrSwapchainImageReleaseInfo;
+
+typedef struct XrSwapchainSubImage
+{
+	XrSwapchain swapchain;
+	XrRect2Di imageRect;
+	uint32_t imageArrayIndex;
+} XrSwapchainSubImage;
+
+// Composition layers
+typedef struct XrCompositionLayerBaseHeader
+{
+	XrStructureType type;
+	const void* next;
+	XrCompositionLayerFlags layerFlags;
+	XrSpace space;
+} XrCompositionLayerBaseHeader;
+
+typedef struct XrCompositionLayerProjectionView
+{
+	XrStructureType type;
+	const void* next;
+	XrPosef pose;
+	XrFovf fov;
+	XrSwapchainSubImage subImage;
+} XrCompositionLayerProjectionView;
+
+typedef struct XrCompositionLayerProjection
+{
+	XrStructureType type;
+	const void* next;
+	XrCompositionLayerFlags layerFlags;
+	XrSpace space;
+	uint32_t viewCount;
+	const XrCompositionLayerProjectionView* views;
+} XrCompositionLayerProjection;
+
+typedef struct XrCompositionLayerQuad
+{
+	XrStructureType type;
+	const void* next;
+	XrCompositionLayerFlags layerFlags;
+	XrSpace space;
+	XrEyeVisibility eyeVisibility;
+	XrSwapchainSubImage subImage;
+	XrPosef pose;
+	XrExtent2Df size;
+} XrCompositionLayerQuad;
+
+typedef struct XrCompositionLayerCubeKHR
+{
+	XrStructureType type;
+	const void* next;
+	XrCompositionLayerFlags layerFlags;
+	XrSpace space;
+	XrEyeVisibility eyeVisibility;
+	XrSwapchain swapchain;
+	uint32_t imageArrayIndex;
+	XrQuaternionf orientation;
+} XrCompositionLayerCubeKHR;
+
+typedef struct XrCompositionLayerDepthInfoKHR
+{
+	XrStructureType type;
+	const void* next;
+	XrSwapchainSubImage subImage;
+	float minDepth;
+	float maxDepth;
+	float nearZ;
+	float farZ;
+} XrCompositionLayerDepthInfoKHR;
+
+typedef struct XrCompositionLayerCylinderKHR
+{
+	XrStructureType type;
+	const void* next;
+	XrCompositionLayerFlags layerFlags;
+	XrSpace space;
+	XrEyeVisibility eyeVisibility;
+	XrSwapchainSubImage subImage;
+	XrPosef pose;
+	float radius;
+	float centralAngle;
+	float aspectRatio;
+} XrCompositionLayerCylinderKHR;
+
+// Frames
+typedef struct XrFrameWaitInfo
+{
+	XrStructureType type;
+	const void* next;
+} XrFrameWaitInfo;
+
+typedef struct XrFrameState
+{
+	XrStructureType type;
+	void* next;
+	XrTime predictedDisplayTime;
+	XrDuration predictedDisplayPeriod;
+	XrBool32 shouldRender;
+} XrFrameState;
+
+typedef struct XrFrameBeginInfo
+{
+	XrStructureType type;
+	const void* next;
+} XrFrameBeginInfo;
+
+typedef struct XrFrameEndInfo
+{
+	XrStructureType type;
+	const void* next;
+	XrTime displayTime;
+	XrEnvironmentBlendMode environmentBlendMode;
+	uint32_t layerCount;
+	const XrCompositionLayerBaseHeader* const* layers;
+} XrFrameEndInfo;
+
+// Spaces
+typedef struct XrSpaceLocation
+{
+	XrStructureType type;
+	void* next;
+	XrSpaceLocationFlags locationFlags;
+	XrPosef pose;
+} XrSpaceLocation;
+
+XrResult xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images);
+XrResult xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index);
+XrResult xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo);
+XrResult xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo);
+XrResult xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState);
+XrResult xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo);
+XrResult xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo);
+XrResult xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location);
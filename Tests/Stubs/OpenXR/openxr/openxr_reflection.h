@@ -0,0 +1,4 @@
+#pragma once
+
+// The result names are only used in assertion messages, which the tests don't need
+#define XR_LIST_ENUM_XrResult(_)
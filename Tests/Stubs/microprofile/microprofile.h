@@ -0,0 +1,11 @@
+#pragma once
+
+// The tests don't link against microprofile, so the profiler macros used by the units under test
+// compile to nothing.
+#define MICROPROFILE_ENABLED 0
+#define MICROPROFILE_DEFINE(var, group, name, color)
+#define MICROPROFILE_SCOPE(var) do {} while (0)
+#define MICROPROFILE_SCOPEI(group, name, color) do {} while (0)
+#define MICROPROFILE_COUNTER_ADD(name, count) do {} while (0)
+#define MICROPROFILE_COUNTER_SET(name, count) do {} while (0)
+#define MicroProfileOnThreadCreate(name) do {} while (0)
@@ -0,0 +1,58 @@
+#pragma once
+
+// The subset of the OpenVR declarations used by the units under test, the tests never load a runtime
+#include <stdint.h>
+
+namespace vr
+{
+	typedef uint32_t TrackedDeviceIndex_t;
+	static const uint32_t k_unTrackedDeviceIndex_Hmd = 0;
+	static const uint32_t k_unMaxTrackedDeviceCount = 64;
+
+	enum ETrackedDeviceClass
+	{
+		TrackedDeviceClass_Invalid = 0,
+		TrackedDeviceClass_HMD = 1,
+		TrackedDeviceClass_Controller = 2,
+		TrackedDeviceClass_GenericTracker = 3,
+		TrackedDeviceClass_TrackingReference = 4,
+		TrackedDeviceClass_DisplayRedirect = 5,
+	};
+
+	enum EVREventType
+	{
+		VREvent_None = 0,
+		VREvent_TrackedDeviceActivated = 100,
+		VREvent_TrackedDeviceDeactivated = 101,
+		VREvent_TrackedDeviceUpdated = 102,
+		VREvent_TrackedDeviceUserInteractionStarted = 103,
+		VREvent_TrackedDeviceUserInteractionEnded = 104,
+		VREvent_TrackedDeviceRoleChanged = 108,
+		VREvent_SceneApplicationChanged = 404,
+		VREvent_InputFocusChanged = 406,
+		VREvent_DashboardActivated = 500,
+		VREvent_DashboardDeactivated = 501,
+		VREvent_Quit = 700,
+	};
+
+	struct VREvent_Process_t
+	{
+		uint32_t pid;
+		uint32_t oldPid;
+		bool bForced;
+	};
+
+	union VREvent_Data_t
+	{
+		VREvent_Process_t process;
+		uint8_t reserved[48];
+	};
+
+	struct VREvent_t
+	{
+		uint32_t eventType;
+		TrackedDeviceIndex_t trackedDeviceIndex;
+		float eventAgeSeconds;
+		VREvent_Data_t data;
+	};
+}
@@ -0,0 +1,132 @@
+#include "Test.h"
+#include "ReviveXR/SwapChainQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// The queue only stores pointers, so the tests use their own swapchain data
+struct TestChain
+{
+	uint32_t Producer;
+	uint32_t Sequence;
+};
+
+TEST(SwapChainQueue_FifoOrder)
+{
+	BoundedQueue<TestChain> queue;
+	TestChain chains[3] = {};
+	for (TestChain& chain : chains)
+		CHECK(queue.Push(&chain));
+
+	TestChain* chain;
+	for (TestChain& expected : chains)
+	{
+		CHECK(queue.Pop(&chain));
+		CHECK(chain == &expected);
+	}
+	CHECK(!queue.Pop(&chain));
+}
+
+TEST(SwapChainQueue_Bounded)
+{
+	BoundedQueue<TestChain> queue;
+	TestChain chain = {};
+	for (int i = 0; i < REV_MAX_ACQUIRED_CHAINS; i++)
+		CHECK(queue.Push(&chain));
+	CHECK(!queue.Push(&chain));
+
+	// A single pop makes room for a single push
+	TestChain* out;
+	CHECK(queue.Pop(&out));
+	CHECK(queue.Push(&chain));
+	CHECK(!queue.Push(&chain));
+
+	for (int i = 0; i < REV_MAX_ACQUIRED_CHAINS; i++)
+		CHECK(queue.Pop(&out));
+	CHECK(!queue.Pop(&out));
+}
+
+TEST(SwapChainQueue_WrapAround)
+{
+	BoundedQueue<TestChain> queue;
+	TestChain chains[5] = {};
+	TestChain* out;
+
+	// Cycle through the ring many times, so the sequence numbers wrap the cells repeatedly
+	for (int i = 0; i < REV_MAX_ACQUIRED_CHAINS * 10; i++)
+	{
+		TestChain* chain = &chains[i % 5];
+		CHECK(queue.Push(chain));
+		CHECK(queue.Pop(&out));
+		CHECK(out == chain);
+	}
+	CHECK(!queue.Pop(&out));
+}
+
+// Several committer threads push into the queue, while a single consumer drains it like the
+// wait thread does. Every chain has to arrive exactly once and in order per committer.
+TEST(SwapChainQueue_Stress)
+{
+	const uint32_t producers = 4;
+	const uint32_t commits = 200000;
+
+	BoundedQueue<TestChain> queue;
+	std::vector<TestChain> chains(producers * commits);
+	std::atomic_uint32_t pending(0);
+	std::atomic_bool done(false);
+
+	std::vector<std::thread> threads;
+	for (uint32_t p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&, p]()
+		{
+			for (uint32_t i = 0; i < commits; i++)
+			{
+				TestChain* chain = &chains[p * commits + i];
+				chain->Producer = p;
+				chain->Sequence = i;
+				pending++;
+
+				// A full ring makes the committer back off, like it waits on the image itself
+				while (!queue.Push(chain))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	std::vector<uint32_t> next(producers, 0);
+	uint32_t received = 0;
+	bool ordered = true;
+	std::thread consumer([&]()
+	{
+		TestChain* chain;
+		while (!done || received < producers * commits)
+		{
+			if (!queue.Pop(&chain))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			if (chain->Sequence != next[chain->Producer])
+				ordered = false;
+			next[chain->Producer] = chain->Sequence + 1;
+			received++;
+			pending--;
+		}
+	});
+
+	for (std::thread& thread : threads)
+		thread.join();
+	done = true;
+	consumer.join();
+
+	TestChain* chain;
+	CHECK(ordered);
+	CHECK(received == producers * commits);
+	CHECK(pending == 0);
+	CHECK(!queue.Pop(&chain));
+	for (uint32_t p = 0; p < producers; p++)
+		CHECK(next[p] == commits);
+}
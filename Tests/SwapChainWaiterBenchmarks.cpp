@@ -0,0 +1,69 @@
+#include "Benchmark.h"
+#include "MockRuntime.h"
+#include "ReviveXR/SwapChain.h"
+#include "ReviveXR/SwapChainWaiter.h"
+
+#include <memory>
+
+// Mock swapchains with images that are ready immediately, so only the handshake itself is measured
+struct BenchmarkChains
+{
+	std::unique_ptr<ovrTextureSwapChainData> Chains[4];
+
+	BenchmarkChains()
+	{
+		MockRuntime::Reset();
+		for (auto& chain : Chains)
+		{
+			chain.reset(new ovrTextureSwapChainData());
+			chain->Swapchain = MockRuntime::CreateSwapchain();
+			chain->ImageReady = true;
+		}
+	}
+
+	~BenchmarkChains()
+	{
+		for (auto& chain : Chains)
+			MockRuntime::DestroySwapchain(chain->Swapchain);
+	}
+};
+
+// The same handshake as ovr_CommitTextureSwapChain
+static void Commit(SwapChainWaiter& waiter, ovrTextureSwapChainData* chain)
+{
+	waiter.WaitReady(chain);
+
+	XrSwapchainImageReleaseInfo releaseInfo = XR_TYPE(SWAPCHAIN_IMAGE_RELEASE_INFO);
+	xrReleaseSwapchainImage(chain->Swapchain, &releaseInfo);
+
+	XrSwapchainImageAcquireInfo acquireInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
+	xrAcquireSwapchainImage(chain->Swapchain, &acquireInfo, &chain->CurrentIndex);
+
+	waiter.Submit(chain);
+}
+
+// A commit of the same swapchain every iteration, which waits for the previous image of that swapchain
+BENCHMARK(SwapChainWaiter_Commit, 200000)
+{
+	BenchmarkChains chains;
+	SwapChainWaiter waiter;
+	waiter.Start();
+	for (uint64_t i = 0; i < iterations; i++)
+		Commit(waiter, chains.Chains[0].get());
+	waiter.Stop();
+}
+
+// A frame committing four swapchains, followed by the wait in ovr_BeginFrame
+BENCHMARK(SwapChainWaiter_Frame, 50000)
+{
+	BenchmarkChains chains;
+	SwapChainWaiter waiter;
+	waiter.Start();
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		for (auto& chain : chains.Chains)
+			Commit(waiter, chain.get());
+		DoNotOptimize(waiter.WaitAll());
+	}
+	waiter.Stop();
+}
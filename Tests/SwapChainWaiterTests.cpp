@@ -0,0 +1,184 @@
+#include "Test.h"
+#include "MockRuntime.h"
+#include "ReviveXR/SwapChain.h"
+#include "ReviveXR/SwapChainWaiter.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Swapchains backed by the mock runtime, in the state ReviveXR creates them in
+struct MockChains
+{
+	std::vector<std::unique_ptr<ovrTextureSwapChainData>> Chains;
+
+	MockChains(size_t count)
+	{
+		MockRuntime::Reset();
+		for (size_t i = 0; i < count; i++)
+		{
+			ovrTextureSwapChainData* chain = new ovrTextureSwapChainData();
+			chain->Swapchain = MockRuntime::CreateSwapchain();
+			chain->ImageReady = true;
+			Chains.emplace_back(chain);
+		}
+	}
+
+	~MockChains()
+	{
+		for (auto& chain : Chains)
+			MockRuntime::DestroySwapchain(chain->Swapchain);
+	}
+
+	ovrTextureSwapChainData* operator[](size_t i) const { return Chains[i].get(); }
+};
+
+// The same handshake as ovr_CommitTextureSwapChain
+static void Commit(SwapChainWaiter& waiter, ovrTextureSwapChainData* chain)
+{
+	waiter.WaitReady(chain);
+
+	XrSwapchainImageReleaseInfo releaseInfo = XR_TYPE(SWAPCHAIN_IMAGE_RELEASE_INFO);
+	xrReleaseSwapchainImage(chain->Swapchain, &releaseInfo);
+
+	XrSwapchainImageAcquireInfo acquireInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
+	xrAcquireSwapchainImage(chain->Swapchain, &acquireInfo, &chain->CurrentIndex);
+
+	waiter.Submit(chain);
+}
+
+TEST(SwapChainWaiter_Commit)
+{
+	MockChains chains(2);
+	SwapChainWaiter waiter;
+	waiter.Start();
+
+	for (int frame = 0; frame < 10; frame++)
+	{
+		Commit(waiter, chains[0]);
+		Commit(waiter, chains[1]);
+		CHECK(waiter.WaitAll() == XR_SUCCESS);
+		CHECK(waiter.GetPending() == 0);
+		CHECK(chains[0]->ImageReady && chains[1]->ImageReady);
+	}
+	waiter.Stop();
+
+	MockRuntime::SwapchainStats stats = MockRuntime::GetSwapchainStats(chains[0]->Swapchain);
+	CHECK(stats.Acquired == 11);
+	CHECK(stats.Waited == 11);
+	CHECK(stats.Released == 10);
+	CHECK(MockRuntime::GetErrors() == 0);
+}
+
+// Without the wait thread the queue fills up, after which a commit waits on its own image
+TEST(SwapChainWaiter_FullQueue)
+{
+	MockChains chains(REV_MAX_ACQUIRED_CHAINS + 1);
+	SwapChainWaiter waiter;
+
+	for (size_t i = 0; i < REV_MAX_ACQUIRED_CHAINS; i++)
+	{
+		Commit(waiter, chains[i]);
+		CHECK(!chains[i]->ImageReady);
+	}
+	CHECK(waiter.GetPending() == REV_MAX_ACQUIRED_CHAINS);
+
+	Commit(waiter, chains[REV_MAX_ACQUIRED_CHAINS]);
+	CHECK(chains[REV_MAX_ACQUIRED_CHAINS]->ImageReady);
+	CHECK(MockRuntime::GetSwapchainStats(chains[REV_MAX_ACQUIRED_CHAINS]->Swapchain).Waited == 2);
+	CHECK(waiter.GetPending() == REV_MAX_ACQUIRED_CHAINS);
+
+	// Starting the thread drains the queue
+	waiter.Start();
+	CHECK(waiter.WaitAll() == XR_SUCCESS);
+	for (size_t i = 0; i <= REV_MAX_ACQUIRED_CHAINS; i++)
+	{
+		CHECK(chains[i]->ImageReady);
+		CHECK(MockRuntime::GetSwapchainStats(chains[i]->Swapchain).Waited == 2);
+	}
+	waiter.Stop();
+	CHECK(MockRuntime::GetErrors() == 0);
+}
+
+// Images still queued when the session ends are never waited on, nothing may block on them
+TEST(SwapChainWaiter_StopReleasesQueued)
+{
+	MockChains chains(3);
+	SwapChainWaiter waiter;
+	for (size_t i = 0; i < 3; i++)
+		Commit(waiter, chains[i]);
+
+	waiter.Stop();
+	CHECK(waiter.GetPending() == 0);
+	for (size_t i = 0; i < 3; i++)
+	{
+		CHECK(chains[i]->ImageReady);
+		CHECK(MockRuntime::GetSwapchainStats(chains[i]->Swapchain).Waited == 1);
+	}
+	CHECK(waiter.WaitAll() == XR_SUCCESS);
+}
+
+// Several committers against a BeginFrame-style consumer. There are more chains than queue slots, so
+// commits also take the full-queue path. The mock runtime flags any image that's released before it
+// was waited on, or any call that overlaps with the wait thread on the same swapchain.
+TEST(SwapChainWaiter_Stress)
+{
+	const size_t committers = 4;
+	const size_t chainsPerCommitter = 24;
+	const int rounds = 200;
+
+	MockChains chains(committers * chainsPerCommitter);
+	MockRuntime::SetImageWaitTime(0, 5);
+	SwapChainWaiter waiter;
+	waiter.Start();
+
+	std::atomic_size_t finished(0);
+	std::atomic_uint32_t failures(0);
+	std::vector<std::thread> threads;
+	for (size_t c = 0; c < committers; c++)
+	{
+		threads.emplace_back([&, c]()
+		{
+			for (int round = 0; round < rounds; round++)
+			{
+				for (size_t i = 0; i < chainsPerCommitter; i++)
+					Commit(waiter, chains[c * chainsPerCommitter + i]);
+			}
+			finished++;
+		});
+	}
+
+	// Begins frames until all committers are done, every frame has to see all earlier images ready
+	uint64_t frames = 0;
+	std::thread consumer([&]()
+	{
+		while (finished < committers)
+		{
+			if (waiter.WaitAll() != XR_SUCCESS)
+				failures++;
+			frames++;
+			std::this_thread::yield();
+		}
+	});
+
+	for (std::thread& thread : threads)
+		thread.join();
+	consumer.join();
+
+	CHECK(waiter.WaitAll() == XR_SUCCESS);
+	CHECK(waiter.GetPending() == 0);
+	waiter.Stop();
+
+	CHECK(failures == 0);
+	CHECK(frames > 0);
+	CHECK(MockRuntime::GetErrors() == 0);
+	for (size_t i = 0; i < committers * chainsPerCommitter; i++)
+	{
+		MockRuntime::SwapchainStats stats = MockRuntime::GetSwapchainStats(chains[i]->Swapchain);
+		CHECK(chains[i]->ImageReady);
+		CHECK(stats.Released == (uint64_t)rounds);
+		CHECK(stats.Acquired == (uint64_t)rounds + 1);
+		CHECK(stats.Waited == (uint64_t)rounds + 1);
+	}
+}
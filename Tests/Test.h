@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+// Minimal test harness, tests register themselves at startup and a failed check ends the current test.
+// Checks must only be used on the test thread, worker threads should report their results back to it.
+typedef void (*TestFunc)();
+
+struct TestCase
+{
+	const char* Name;
+	TestFunc Func;
+	TestCase* Next;
+};
+
+bool RegisterTest(TestCase* test);
+void FailTest(const char* file, int line, const char* expression);
+
+// Number of heap allocations made by all threads so far, so a test can check a hot path doesn't allocate
+uint64_t GetAllocationCount();
+
+#define TEST(name) \
+	static void name(); \
+	static TestCase name##Case = { #name, name, nullptr }; \
+	static const bool name##Registered = RegisterTest(&name##Case); \
+	static void name()
+
+#define CHECK(x) do { if (!(x)) { FailTest(__FILE__, __LINE__, #x); return; } } while (0)
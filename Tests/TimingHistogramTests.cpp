@@ -0,0 +1,57 @@
+#include "Test.h"
+#include "TimingHistogram.h"
+
+TEST(TimingHistogram_Buckets)
+{
+	CHECK(TimingHistogram::GetBucket(0) == 0);
+	CHECK(TimingHistogram::GetBucket(1) == 1);
+	CHECK(TimingHistogram::GetBucket(2) == 2);
+	CHECK(TimingHistogram::GetBucket(3) == 2);
+	CHECK(TimingHistogram::GetBucket(4) == 3);
+	CHECK(TimingHistogram::GetBucket(1000) == 10);
+	CHECK(TimingHistogram::GetBucket(1ll << 40) == REV_HISTOGRAM_BUCKETS - 1);
+
+	// Every duration is below the limit of its own bucket and not below the limit of the previous one
+	for (int64_t us = 1; us < (1 << 20); us = us * 3 / 2 + 1)
+	{
+		int bucket = TimingHistogram::GetBucket(us);
+		CHECK(us < TimingHistogram::GetBucketLimit(bucket));
+		CHECK(us >= TimingHistogram::GetBucketLimit(bucket - 1));
+	}
+}
+
+TEST(TimingHistogram_Percentiles)
+{
+	TimingHistogram histogram;
+	CHECK(histogram.GetTotal() == 0);
+
+	for (int i = 0; i < 98; i++)
+		histogram.Add(0);
+	histogram.Add(100);
+	histogram.Add(5000);
+
+	CHECK(histogram.GetTotal() == 100);
+	CHECK(histogram.GetCount(0) == 98);
+	CHECK(histogram.GetPercentile(50.0) == 1);
+	CHECK(histogram.GetPercentile(98.0) == 128);
+	CHECK(histogram.GetPercentile(99.0) == 8192);
+
+	histogram.Reset();
+	CHECK(histogram.GetTotal() == 0);
+}
+
+TEST(TimingHistogram_Format)
+{
+	TimingHistogram histogram;
+	histogram.Add(3);
+	histogram.Add(12);
+
+	// Only the buckets from the first to the last sample are listed
+	std::string text = histogram.Format("Wait");
+	CHECK(text.find("Wait: 2 samples") == 0);
+	CHECK(text.find("<        4 us: 1") != std::string::npos);
+	CHECK(text.find("<        8 us: 0") != std::string::npos);
+	CHECK(text.find("<       16 us: 1") != std::string::npos);
+	CHECK(text.find("<        2 us") == std::string::npos);
+	CHECK(text.find("<       32 us") == std::string::npos);
+}
@@ -0,0 +1,284 @@
+#include "Test.h"
+#include "ReviveXR/TouchInput.h"
+
+#include <math.h>
+#include <random>
+#include <string.h>
+
+// The action values of both hands, queried the same way the InputManager actions are
+struct TestActions
+{
+	struct Action
+	{
+		bool Digital[ovrHand_Count];
+		float Analog[ovrHand_Count];
+		ovrVector2f Vector[ovrHand_Count];
+
+		bool GetDigital(int, ovrHandType hand = ovrHand_Left) const { return Digital[hand]; }
+		float GetAnalog(int, ovrHandType hand = ovrHand_Left) const { return Analog[hand]; }
+		ovrVector2f GetVector(int, ovrHandType hand = ovrHand_Left) const { return Vector[hand]; }
+	};
+
+	bool WmrProfile;
+	Action m_Button_AX;
+	Action m_Button_BY;
+	Action m_Button_Thumb;
+	Action m_Button_Enter;
+	Action m_Button_Home;
+	Action m_Touch_AX;
+	Action m_Touch_BY;
+	Action m_Touch_Thumb;
+	Action m_Touch_ThumbRest;
+	Action m_Touch_IndexTrigger;
+	Action m_IndexTrigger;
+	Action m_HandTrigger;
+	Action m_Thumbstick;
+	Action m_Trackpad_Buttons;
+
+	// Same as OculusTouch::UpdateState
+	TouchActionSnapshot Snapshot(int session) const
+	{
+		TouchActionSnapshot snapshot;
+		snapshot.Button_Enter = m_Button_Enter.GetDigital(session);
+		snapshot.Button_Home = m_Button_Home.GetDigital(session);
+
+		for (int i = 0; i < ovrHand_Count; i++)
+		{
+			ovrHandType hand = (ovrHandType)i;
+			snapshot.Button_AX[i] = m_Button_AX.GetDigital(session, hand);
+			snapshot.Button_BY[i] = m_Button_BY.GetDigital(session, hand);
+			snapshot.Button_Thumb[i] = m_Button_Thumb.GetDigital(session, hand);
+			snapshot.Touch_AX[i] = m_Touch_AX.GetDigital(session, hand);
+			snapshot.Touch_BY[i] = m_Touch_BY.GetDigital(session, hand);
+			snapshot.Touch_Thumb[i] = m_Touch_Thumb.GetDigital(session, hand);
+			snapshot.Touch_ThumbRest[i] = m_Touch_ThumbRest.GetDigital(session, hand);
+			snapshot.Touch_IndexTrigger[i] = m_Touch_IndexTrigger.GetDigital(session, hand);
+			snapshot.IndexTrigger[i] = m_IndexTrigger.GetAnalog(session, hand);
+			snapshot.HandTrigger[i] = m_HandTrigger.GetAnalog(session, hand);
+			snapshot.Trackpad_Buttons[i] = WmrProfile ? m_Trackpad_Buttons.GetAnalog(session, hand) : 0.0f;
+			snapshot.Thumbstick[i] = m_Thumbstick.GetVector(session, hand);
+		}
+		return snapshot;
+	}
+
+	// OculusTouch::GetInputState before the snapshot, which queried every action on every call
+	void GetInputState(int session, ovrInputState* inputState) const
+	{
+		if (m_Button_Enter.GetDigital(session))
+			inputState->Buttons |= ovrButton_Enter;
+
+		if (m_Button_Home.GetDigital(session))
+			inputState->Buttons |= ovrButton_Home;
+
+		for (int i = 0; i < ovrHand_Count; i++)
+		{
+			ovrHandType hand = (ovrHandType)i;
+			unsigned int buttons = 0, touches = 0;
+
+			if (WmrProfile)
+			{
+				if (m_Button_AX.GetDigital(session, hand) || m_Button_BY.GetDigital(session, hand))
+				{
+					if (m_Trackpad_Buttons.GetAnalog(session, hand) > 0.0f)
+						buttons |= ovrButton_B;
+					else
+						buttons |= ovrButton_A;
+				}
+
+				if (m_Touch_AX.GetDigital(session, hand) || m_Touch_BY.GetDigital(session, hand))
+				{
+					if (m_Trackpad_Buttons.GetAnalog(session, hand) > 0.0f)
+						touches |= ovrTouch_B;
+					else
+						touches |= ovrTouch_A;
+				}
+			}
+			else
+			{
+				if (m_Button_AX.GetDigital(session, hand))
+					buttons |= ovrButton_A;
+
+				if (m_Touch_AX.GetDigital(session, hand))
+					touches |= ovrTouch_A;
+
+				if (m_Button_BY.GetDigital(session, hand))
+					buttons |= ovrButton_B;
+
+				if (m_Touch_BY.GetDigital(session, hand))
+					touches |= ovrTouch_B;
+			}
+
+			if (m_Button_Thumb.GetDigital(session, hand))
+				buttons |= ovrButton_RThumb;
+
+			if (m_Touch_Thumb.GetDigital(session, hand))
+				touches |= ovrTouch_RThumb;
+
+			if (m_Touch_ThumbRest.GetDigital(session, hand))
+				touches |= ovrTouch_RThumbRest;
+
+			if (m_Touch_IndexTrigger.GetDigital(session, hand))
+				touches |= ovrTouch_RIndexTrigger;
+
+			inputState->ThumbstickNoDeadzone[i] = m_Thumbstick.GetVector(session, hand);
+			inputState->IndexTriggerNoDeadzone[i] = m_IndexTrigger.GetAnalog(session, hand);
+			inputState->HandTriggerNoDeadzone[i] = m_HandTrigger.GetAnalog(session, hand);
+
+			if (inputState->HandTriggerNoDeadzone[i] > 0.5f)
+			{
+				if (!(touches & ovrTouch_RIndexTrigger))
+					touches |= ovrTouch_RIndexPointing;
+
+				if (!(touches & ~(ovrTouch_RIndexTrigger | ovrTouch_RIndexPointing)))
+					touches |= ovrTouch_RThumbUp;
+			}
+
+			inputState->Thumbstick[i] = ApplyDeadzone(inputState->ThumbstickNoDeadzone[i], 0.24f);
+			inputState->IndexTrigger[i] = inputState->IndexTriggerNoDeadzone[i];
+			inputState->HandTrigger[i] = inputState->HandTriggerNoDeadzone[i];
+
+			inputState->ThumbstickRaw[i] = inputState->ThumbstickNoDeadzone[i];
+			inputState->IndexTriggerRaw[i] = inputState->IndexTriggerNoDeadzone[i];
+			inputState->HandTriggerRaw[i] = inputState->HandTriggerNoDeadzone[i];
+
+			inputState->Buttons |= (hand == ovrHand_Left) ? buttons << 8 : buttons;
+			inputState->Touches |= (hand == ovrHand_Left) ? touches << 8 : touches;
+		}
+	}
+};
+
+// Converts the actions both ways and checks the states are identical, returns the snapshot state
+static bool Compare(const TestActions& actions, ovrInputState* out_State)
+{
+	ovrInputState expected, actual;
+	memset(&expected, 0, sizeof(expected));
+	memset(&actual, 0, sizeof(actual));
+
+	actions.GetInputState(0, &expected);
+	TouchSnapshotToInputState(actions.Snapshot(0), actions.WmrProfile, &actual);
+	if (out_State)
+		*out_State = actual;
+	return memcmp(&expected, &actual, sizeof(actual)) == 0;
+}
+
+// One hand of a test case, the other hand is left idle
+struct TouchCase
+{
+	const char* Name;
+	bool WmrProfile;
+	ovrHandType Hand;
+	bool ButtonAX, ButtonBY, ButtonThumb;
+	bool TouchAX, TouchBY, TouchThumb, TouchThumbRest, TouchIndexTrigger;
+	float IndexTrigger, HandTrigger, Trackpad;
+	ovrVector2f Thumbstick;
+	unsigned int Buttons, Touches;
+};
+
+static const TouchCase s_TouchCases[] =
+{
+	// Name                 WMR    Hand           AX     BY     Thumb  tAX    tBY    tThumb tRest  tIndex Index Hand  Pad   Stick           Buttons                     Touches
+	{ "Idle",               false, ovrHand_Right, false, false, false, false, false, false, false, false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.0f }, 0,                          0 },
+	{ "A",                  false, ovrHand_Right, true,  false, false, true,  false, false, false, false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.0f }, ovrButton_A,                ovrTouch_A },
+	{ "Y",                  false, ovrHand_Left,  false, true,  false, false, true,  false, false, false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.0f }, ovrButton_Y,                ovrTouch_Y },
+	{ "Both face buttons",  false, ovrHand_Right, true,  true,  false, true,  true,  false, false, false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.0f }, ovrButton_A | ovrButton_B,  ovrTouch_A | ovrTouch_B },
+	{ "Thumbstick click",   false, ovrHand_Left,  false, false, true,  false, false, true,  false, false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.9f }, ovrButton_LThumb,           ovrTouch_LThumb },
+	{ "Thumb rest",         false, ovrHand_Right, false, false, false, false, false, false, true,  false, 0.0f, 0.0f, 0.0f, { 0.0f, 0.0f }, 0,                          ovrTouch_RThumbRest },
+	{ "Pointing",           false, ovrHand_Right, false, false, false, false, false, false, true,  false, 0.0f, 0.8f, 0.0f, { 0.0f, 0.0f }, 0,                          ovrTouch_RThumbRest | ovrTouch_RIndexPointing },
+	{ "Thumbs up",          false, ovrHand_Left,  false, false, false, false, false, false, false, true,  0.3f, 0.8f, 0.0f, { 0.0f, 0.0f }, 0,                          ovrTouch_LIndexTrigger | ovrTouch_LThumbUp },
+	{ "Fist",               false, ovrHand_Right, false, false, false, false, false, true,  false, false, 0.0f, 0.8f, 0.0f, { 0.0f, 0.0f }, 0,                          ovrTouch_RThumb | ovrTouch_RIndexPointing },
+	{ "Half hand trigger",  false, ovrHand_Right, false, false, false, false, false, false, false, false, 0.0f, 0.5f, 0.0f, { 0.0f, 0.0f }, 0,                          0 },
+	{ "Deadzone",           false, ovrHand_Left,  false, false, false, false, false, false, false, false, 0.0f, 0.0f, 0.0f, { 0.2f, 0.1f }, 0,                          0 },
+	{ "WMR upper trackpad", true,  ovrHand_Right, true,  false, false, true,  false, false, false, false, 0.0f, 0.0f, 0.5f, { 0.0f, 0.0f }, ovrButton_B,                ovrTouch_B },
+	{ "WMR lower trackpad", true,  ovrHand_Right, false, true,  false, false, true,  false, false, false, 0.0f, 0.0f,-0.5f, { 0.0f, 0.0f }, ovrButton_A,                ovrTouch_A },
+	{ "WMR left upper",     true,  ovrHand_Left,  true,  true,  false, true,  false, false, false, false, 0.0f, 0.0f, 0.7f, { 0.0f, 0.0f }, ovrButton_Y,                ovrTouch_Y },
+	{ "WMR trackpad only",  true,  ovrHand_Left,  false, false, false, false, false, false, false, false, 0.0f, 0.0f, 0.7f, { 0.0f, 0.0f }, 0,                          0 },
+	{ "WMR pointing",       true,  ovrHand_Right, false, false, false, false, false, false, false, false, 0.9f, 0.9f, 0.0f, { 0.5f, 0.5f }, 0,                          ovrTouch_RIndexPointing | ovrTouch_RThumbUp },
+};
+
+TEST(TouchInput_Table)
+{
+	for (const TouchCase& test : s_TouchCases)
+	{
+		TestActions actions = {};
+		actions.WmrProfile = test.WmrProfile;
+		actions.m_Button_AX.Digital[test.Hand] = test.ButtonAX;
+		actions.m_Button_BY.Digital[test.Hand] = test.ButtonBY;
+		actions.m_Button_Thumb.Digital[test.Hand] = test.ButtonThumb;
+		actions.m_Touch_AX.Digital[test.Hand] = test.TouchAX;
+		actions.m_Touch_BY.Digital[test.Hand] = test.TouchBY;
+		actions.m_Touch_Thumb.Digital[test.Hand] = test.TouchThumb;
+		actions.m_Touch_ThumbRest.Digital[test.Hand] = test.TouchThumbRest;
+		actions.m_Touch_IndexTrigger.Digital[test.Hand] = test.TouchIndexTrigger;
+		actions.m_IndexTrigger.Analog[test.Hand] = test.IndexTrigger;
+		actions.m_HandTrigger.Analog[test.Hand] = test.HandTrigger;
+		actions.m_Trackpad_Buttons.Analog[test.Hand] = test.Trackpad;
+		actions.m_Thumbstick.Vector[test.Hand] = test.Thumbstick;
+
+		ovrInputState state;
+		if (!Compare(actions, &state))
+		{
+			FailTest(__FILE__, __LINE__, test.Name);
+			return;
+		}
+		CHECK(state.Buttons == test.Buttons);
+		CHECK(state.Touches == test.Touches);
+		CHECK(state.IndexTrigger[test.Hand] == test.IndexTrigger);
+		CHECK(state.HandTriggerRaw[test.Hand] == test.HandTrigger);
+		CHECK(state.ThumbstickNoDeadzone[test.Hand].y == test.Thumbstick.y);
+	}
+}
+
+TEST(TouchInput_SystemButtons)
+{
+	TestActions actions = {};
+	actions.m_Button_Enter.Digital[ovrHand_Left] = true;
+	actions.m_Button_Home.Digital[ovrHand_Left] = true;
+
+	ovrInputState state;
+	CHECK(Compare(actions, &state));
+	CHECK(state.Buttons == (ovrButton_Enter | ovrButton_Home));
+}
+
+TEST(TouchInput_Deadzone)
+{
+	ovrVector2f inner = ApplyDeadzone(ovrVector2f{ 0.2f, 0.0f }, 0.24f);
+	CHECK(inner.x == 0.0f && inner.y == 0.0f);
+
+	ovrVector2f full = ApplyDeadzone(ovrVector2f{ 0.0f, 1.0f }, 0.24f);
+	CHECK(full.x == 0.0f && fabsf(full.y - 1.0f) < 1e-6f);
+
+	ovrVector2f half = ApplyDeadzone(ovrVector2f{ 0.62f, 0.0f }, 0.24f);
+	CHECK(fabsf(half.x - 0.5f) < 1e-6f);
+}
+
+// Random action states for both profiles, the snapshot has to match the per-query conversion exactly
+TEST(TouchInput_MatchesPerQuery)
+{
+	std::minstd_rand random(1234);
+	std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+	auto digital = [&]() { return (random() & 1) != 0; };
+
+	for (int i = 0; i < 10000; i++)
+	{
+		TestActions actions = {};
+		actions.WmrProfile = (i & 1) != 0;
+		actions.m_Button_Enter.Digital[ovrHand_Left] = digital();
+		actions.m_Button_Home.Digital[ovrHand_Left] = digital();
+		for (int hand = 0; hand < ovrHand_Count; hand++)
+		{
+			actions.m_Button_AX.Digital[hand] = digital();
+			actions.m_Button_BY.Digital[hand] = digital();
+			actions.m_Button_Thumb.Digital[hand] = digital();
+			actions.m_Touch_AX.Digital[hand] = digital();
+			actions.m_Touch_BY.Digital[hand] = digital();
+			actions.m_Touch_Thumb.Digital[hand] = digital();
+			actions.m_Touch_ThumbRest.Digital[hand] = digital();
+			actions.m_Touch_IndexTrigger.Digital[hand] = digital();
+			actions.m_IndexTrigger.Analog[hand] = fabsf(axis(random));
+			actions.m_HandTrigger.Analog[hand] = fabsf(axis(random));
+			actions.m_Trackpad_Buttons.Analog[hand] = axis(random);
+			actions.m_Thumbstick.Vector[hand] = ovrVector2f{ axis(random), axis(random) };
+		}
+		CHECK(Compare(actions, nullptr));
+	}
+}
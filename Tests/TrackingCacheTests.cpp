@@ -0,0 +1,96 @@
+#include "Test.h"
+#include "TrackingCache.h"
+
+#include <atomic>
+#include <thread>
+
+// Large enough to span many words, so a torn copy would show up as mismatched fields
+struct TestState
+{
+	uint64_t Values[32];
+};
+
+static TestState MakeState(uint64_t value)
+{
+	TestState state;
+	for (uint64_t& v : state.Values)
+		v = value;
+	return state;
+}
+
+TEST(TrackingCache_HitAndMiss)
+{
+	TrackingCache<TestState> cache;
+	TestState state;
+	CHECK(!cache.Get(10, 1, &state));
+
+	cache.Put(cache.Epoch(), 10, 1, MakeState(42));
+	CHECK(cache.Get(10, 1, &state));
+	CHECK(state.Values[0] == 42 && state.Values[31] == 42);
+
+	// Different time or space is a miss
+	CHECK(!cache.Get(11, 1, &state));
+	CHECK(!cache.Get(10, 2, &state));
+}
+
+TEST(TrackingCache_Invalidate)
+{
+	TrackingCache<TestState> cache;
+	TestState state;
+	uint32_t epoch = cache.Epoch();
+	cache.Put(epoch, 10, 1, MakeState(1));
+	cache.Invalidate();
+	CHECK(!cache.Get(10, 1, &state));
+
+	// A state computed before the invalidation must not be served afterwards
+	cache.Put(epoch, 10, 1, MakeState(2));
+	CHECK(!cache.Get(10, 1, &state));
+
+	cache.Put(cache.Epoch(), 10, 1, MakeState(3));
+	CHECK(cache.Get(10, 1, &state));
+	CHECK(state.Values[0] == 3);
+}
+
+// Writers keep replacing the entry while readers query it, a hit must never return a torn state
+TEST(TrackingCache_Stress)
+{
+	const uint64_t iterations = 200000;
+
+	TrackingCache<TestState> cache;
+	std::atomic_bool done(false);
+	std::atomic_uint64_t torn(0);
+
+	auto writer = [&](uint64_t offset)
+	{
+		for (uint64_t i = 0; i < iterations; i++)
+			cache.Put(cache.Epoch(), 10, 1, MakeState(offset + i));
+	};
+
+	auto reader = [&]()
+	{
+		TestState state;
+		while (!done)
+		{
+			if (!cache.Get(10, 1, &state))
+				continue;
+
+			for (uint64_t v : state.Values)
+			{
+				if (v != state.Values[0])
+					torn++;
+			}
+		}
+	};
+
+	std::thread readers[2] = { std::thread(reader), std::thread(reader) };
+	std::thread writers[2] = { std::thread(writer, 0), std::thread(writer, iterations) };
+	for (std::thread& thread : writers)
+		thread.join();
+	done = true;
+	for (std::thread& thread : readers)
+		thread.join();
+
+	CHECK(torn == 0);
+	TestState state;
+	CHECK(cache.Get(10, 1, &state));
+}
@@ -0,0 +1,80 @@
+#include "Test.h"
+
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static TestCase* s_Tests = nullptr;
+static bool s_Failed = false;
+static std::atomic_uint64_t s_Allocations(0);
+
+void* operator new(size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+uint64_t GetAllocationCount()
+{
+	return s_Allocations.load();
+}
+
+bool RegisterTest(TestCase* test)
+{
+	test->Next = s_Tests;
+	s_Tests = test;
+	return true;
+}
+
+void FailTest(const char* file, int line, const char* expression)
+{
+	printf("  %s(%d): CHECK(%s) failed\n", file, line, expression);
+	s_Failed = true;
+}
+
+int main(int argc, char** argv)
+{
+	// Tests register in reverse order, so run them back to front
+	TestCase* tests = nullptr;
+	while (s_Tests)
+	{
+		TestCase* next = s_Tests->Next;
+		s_Tests->Next = tests;
+		tests = s_Tests;
+		s_Tests = next;
+	}
+
+	// The optional argument only runs the tests that contain it in their name
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	int run = 0, failed = 0;
+	for (TestCase* test = tests; test; test = test->Next)
+	{
+		if (filter && !strstr(test->Name, filter))
+			continue;
+
+		s_Failed = false;
+		test->Func();
+		printf("[%s] %s\n", s_Failed ? "FAIL" : " OK ", test->Name);
+		run++;
+		if (s_Failed)
+			failed++;
+	}
+
+	printf("%d of %d tests passed\n", run - failed, run);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+#include "ReviveXR/CallRecorder.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+static const char* CallNames[] =
+{
+	"ovr_WaitToBeginFrame",
+	"ovr_BeginFrame",
+	"ovr_EndFrame",
+	"ovr_CommitTextureSwapChain",
+	"ovr_GetTrackingState",
+	"ovr_GetInputState",
+};
+static const size_t CallCount = sizeof(CallNames) / sizeof(CallNames[0]);
+
+struct CallStats
+{
+	uint64_t Count;
+	uint64_t Bytes;
+	std::vector<int64_t> Intervals;
+	int64_t Last;
+};
+
+static double Percentile(std::vector<int64_t>& values, double percentile, double scale)
+{
+	if (values.empty())
+		return 0.0;
+	size_t rank = std::min((size_t)(values.size() * percentile / 100.0), values.size() - 1);
+	std::nth_element(values.begin(), values.begin() + rank, values.end());
+	return values[rank] * scale;
+}
+
+// Reads a recording written by the ReviveXR call recorder (REVIVE_RECORD_FILE) and reports how often
+// each call was made, the time between consecutive calls and the layers submitted per frame.
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <recording>\n", argv[0]);
+		return 1;
+	}
+
+	FILE* file = fopen(argv[1], "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	RecordFileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != REV_RECORD_FILE_MAGIC)
+	{
+		fprintf(stderr, "%s is not a call recording\n", argv[1]);
+		fclose(file);
+		return 1;
+	}
+
+	if (header.Version != REV_RECORD_FILE_VERSION || header.Frequency <= 0 ||
+		(header.PointerSize != 4 && header.PointerSize != 8))
+	{
+		fprintf(stderr, "Unsupported recording version %u\n", header.Version);
+		fclose(file);
+		return 1;
+	}
+
+	CallStats calls[CallCount] = {};
+	std::vector<uint32_t> layers;
+	std::vector<char> data;
+	int64_t first = 0, last = 0;
+	bool truncated = false;
+
+	RecordHeader record;
+	while (fread(&record, sizeof(record), 1, file) == 1)
+	{
+		data.resize(record.Size);
+		if (record.Size > 0 && fread(data.data(), record.Size, 1, file) != 1)
+		{
+			truncated = true;
+			break;
+		}
+
+		if (!first)
+			first = record.Timestamp;
+		last = record.Timestamp;
+
+		if (record.Call >= CallCount)
+			continue;
+
+		CallStats& stats = calls[record.Call];
+		stats.Count++;
+		stats.Bytes += record.Size;
+		if (stats.Last)
+			stats.Intervals.push_back(record.Timestamp - stats.Last);
+		stats.Last = record.Timestamp;
+
+		if (record.Call == RECORD_END_FRAME && record.Size >= sizeof(long long) + sizeof(uint32_t))
+		{
+			uint32_t layerCount;
+			memcpy(&layerCount, data.data() + sizeof(long long), sizeof(layerCount));
+			layers.push_back(layerCount);
+		}
+	}
+	fclose(file);
+
+	printf("Version %u recording of a LibOVR 1.%u app with %u-bit pointers, %.1f s\n", header.Version,
+		header.MinorVersion, header.PointerSize * 8, (last - first) / (double)header.Frequency);
+	// The intervals are the times between consecutive calls of the same function
+	printf("%-28s %10s %12s %16s %16s %16s\n", "call", "count", "bytes", "p50_interval_us", "p99_interval_us", "max_interval_us");
+
+	double scale = 1000000.0 / header.Frequency;
+	for (size_t i = 0; i < CallCount; i++)
+	{
+		CallStats& stats = calls[i];
+		if (!stats.Count)
+			continue;
+
+		printf("%-28s %10llu %12llu %16.1f %16.1f %16.1f\n", CallNames[i], (unsigned long long)stats.Count,
+			(unsigned long long)stats.Bytes, Percentile(stats.Intervals, 50.0, scale),
+			Percentile(stats.Intervals, 99.0, scale), Percentile(stats.Intervals, 100.0, scale));
+	}
+
+	if (!layers.empty())
+	{
+		uint64_t total = 0;
+		for (uint32_t count : layers)
+			total += count;
+		printf("Layers per frame: mean %.2f, max %u\n", total / (double)layers.size(),
+			*std::max_element(layers.begin(), layers.end()));
+	}
+
+	if (truncated)
+	{
+		fprintf(stderr, "Recording is truncated\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,392 @@
+#include "MockRuntime.h"
+#include "ReviveXR/CallRecorder.h"
+#include "ReviveXR/CompositionLayers.h"
+#include "ReviveXR/SwapChain.h"
+#include "ReviveXR/SwapChainWaiter.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+static const char* CallNames[] =
+{
+	"ovr_WaitToBeginFrame",
+	"ovr_BeginFrame",
+	"ovr_EndFrame",
+	"ovr_CommitTextureSwapChain",
+	"ovr_GetTrackingState",
+	"ovr_GetInputState",
+};
+static const size_t CallCount = sizeof(CallNames) / sizeof(CallNames[0]);
+
+static double Percentile(std::vector<int64_t>& values, double percentile)
+{
+	if (values.empty())
+		return 0.0;
+	size_t rank = std::min((size_t)(values.size() * percentile / 100.0), values.size() - 1);
+	std::nth_element(values.begin(), values.begin() + rank, values.end());
+	return values[rank] / 1000.0;
+}
+
+// Replays the calls of a recording through the ReviveXR frame loop against the mock runtime. The
+// recorded swapchain handles are mapped to mock swapchains the first time they're seen.
+class CallReplay
+{
+public:
+	CallReplay(uint32_t minorVersion, int64_t displayPeriod)
+		: m_Session(MockRuntime::CreateSession(displayPeriod))
+		, m_ViewSpace(MockRuntime::CreateSpace())
+		, m_WorldSpace(MockRuntime::CreateSpace())
+		, m_Image{ XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR, nullptr }
+		, m_Arena(new LayerArena())
+		, m_SkippedLayers(0)
+		, m_Failed(0)
+	{
+		LayerTranslationInfo info = { minorVersion, true, true, true, m_ViewSpace, m_WorldSpace };
+		m_Info = info;
+		m_Waiter.Start();
+	}
+
+	~CallReplay()
+	{
+		m_Waiter.Stop();
+		for (auto& chain : m_Chains)
+			MockRuntime::DestroySwapchain(chain.second->Swapchain);
+		MockRuntime::DestroySpace(m_ViewSpace);
+		MockRuntime::DestroySpace(m_WorldSpace);
+		MockRuntime::DestroySession(m_Session);
+	}
+
+	// Returns the time spent in the replayed call in nanoseconds, or -1 if the call isn't replayed
+	int64_t Replay(uint16_t call, const char* data, uint32_t size)
+	{
+		switch (call)
+		{
+		case RECORD_WAIT_TO_BEGIN_FRAME:
+		{
+			auto start = std::chrono::steady_clock::now();
+			XrFrameWaitInfo waitInfo = XR_TYPE(FRAME_WAIT_INFO);
+			XrFrameState frameState = XR_TYPE(FRAME_STATE);
+			Check(xrWaitFrame(m_Session, &waitInfo, &frameState));
+			return Elapsed(start);
+		}
+		case RECORD_BEGIN_FRAME:
+		{
+			auto start = std::chrono::steady_clock::now();
+			Check(m_Waiter.WaitAll());
+			XrFrameBeginInfo beginInfo = XR_TYPE(FRAME_BEGIN_INFO);
+			Check(xrBeginFrame(m_Session, &beginInfo));
+			return Elapsed(start);
+		}
+		case RECORD_END_FRAME:
+			return ReplayEndFrame(data, size);
+		case RECORD_COMMIT_SWAP_CHAIN:
+		{
+			uint64_t handle;
+			if (size < sizeof(handle))
+				return -1;
+			memcpy(&handle, data, sizeof(handle));
+			ovrTextureSwapChainData* chain = GetChain(handle);
+			if (!chain)
+				return -1;
+
+			auto start = std::chrono::steady_clock::now();
+			m_Waiter.WaitReady(chain);
+			XrSwapchainImageReleaseInfo releaseInfo = XR_TYPE(SWAPCHAIN_IMAGE_RELEASE_INFO);
+			Check(xrReleaseSwapchainImage(chain->Swapchain, &releaseInfo));
+			XrSwapchainImageAcquireInfo acquireInfo = XR_TYPE(SWAPCHAIN_IMAGE_ACQUIRE_INFO);
+			Check(xrAcquireSwapchainImage(chain->Swapchain, &acquireInfo, &chain->CurrentIndex));
+			m_Waiter.Submit(chain);
+			return Elapsed(start);
+		}
+		case RECORD_GET_TRACKING_STATE:
+		{
+			double absTime;
+			if (size < sizeof(absTime))
+				return -1;
+			memcpy(&absTime, data, sizeof(absTime));
+
+			auto start = std::chrono::steady_clock::now();
+			XrSpaceLocation location = XR_TYPE(SPACE_LOCATION);
+			XrTime time = absTime > 0.0 ? (XrTime)(absTime * 1.0e9) : 1;
+			Check(xrLocateSpace(m_ViewSpace, m_WorldSpace, time, &location));
+			return Elapsed(start);
+		}
+		default:
+			// The input state depends on the action system, which the mock runtime doesn't implement
+			return -1;
+		}
+	}
+
+	void Finish() { Check(m_Waiter.WaitAll()); }
+
+	uint64_t GetSkippedLayers() const { return m_SkippedLayers; }
+	uint64_t GetFailed() const { return m_Failed; }
+	const LayerArena& GetArena() const { return *m_Arena; }
+	size_t GetChainCount() const { return m_Chains.size(); }
+
+private:
+	static int64_t Elapsed(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void Check(XrResult result)
+	{
+		if (XR_FAILED(result))
+			m_Failed++;
+	}
+
+	ovrTextureSwapChainData* GetChain(uint64_t handle)
+	{
+		if (!handle)
+			return nullptr;
+
+		std::unique_ptr<ovrTextureSwapChainData>& chain = m_Chains[handle];
+		if (!chain)
+		{
+			// The recording doesn't contain the swapchain descriptions, so the viewports are never clamped
+			chain.reset(new ovrTextureSwapChainData());
+			chain->Desc.Width = 16384;
+			chain->Desc.Height = 16384;
+			chain->Swapchain = MockRuntime::CreateSwapchain();
+			chain->Images = &m_Image;
+			chain->ImageReady = true;
+		}
+		return chain.get();
+	}
+
+	// Replaces the recorded swapchain handle at the offset with the mock swapchain
+	bool MapTexture(char* base, size_t offset, const char* end)
+	{
+		if (base + offset + sizeof(uint64_t) > end)
+			return false;
+
+		uint64_t handle;
+		memcpy(&handle, base + offset, sizeof(handle));
+		ovrTextureSwapChain chain = GetChain(handle);
+		memcpy(base + offset, &chain, sizeof(chain));
+		return true;
+	}
+
+	bool MapTextures(char* layer, uint32_t size)
+	{
+		ovrLayerType type = ((ovrLayerHeader*)layer)->Type;
+
+		// The layer data of older versions starts within the reserved header data, see TranslateLayers
+		char* base = layer - (m_Info.MinorVersion < 25 ? sizeof(ovrLayerHeader::Reserved) : 0);
+		const char* end = layer + size;
+
+		size_t eye = sizeof(ovrTextureSwapChain);
+		switch (type)
+		{
+		case ovrLayerType_EyeFov:
+			return MapTexture(base, offsetof(ovrLayerEyeFov, ColorTexture), end) &&
+				MapTexture(base, offsetof(ovrLayerEyeFov, ColorTexture) + eye, end);
+		case ovrLayerType_EyeMatrix:
+			return MapTexture(base, offsetof(ovrLayerEyeMatrix, ColorTexture), end) &&
+				MapTexture(base, offsetof(ovrLayerEyeMatrix, ColorTexture) + eye, end);
+		case ovrLayerType_EyeFovDepth:
+			return MapTexture(base, offsetof(ovrLayerEyeFovDepth, ColorTexture), end) &&
+				MapTexture(base, offsetof(ovrLayerEyeFovDepth, ColorTexture) + eye, end) &&
+				MapTexture(base, offsetof(ovrLayerEyeFovDepth, DepthTexture), end) &&
+				MapTexture(base, offsetof(ovrLayerEyeFovDepth, DepthTexture) + eye, end);
+		case ovrLayerType_Quad:
+			return MapTexture(base, offsetof(ovrLayerQuad, ColorTexture), end);
+		case ovrLayerType_Cylinder:
+			return MapTexture(base, offsetof(ovrLayerCylinder, ColorTexture), end);
+		case ovrLayerType_Cube:
+			return MapTexture(base, offsetof(ovrLayerCube, CubeMapTexture), end);
+		case ovrLayerType_Disabled:
+			return true;
+		default:
+			// Multi-resolution layers aren't translated by ReviveXR
+			return false;
+		}
+	}
+
+	int64_t ReplayEndFrame(const char* data, uint32_t size)
+	{
+		long long frameIndex;
+		uint32_t layerCount;
+		if (size < sizeof(frameIndex) + sizeof(layerCount))
+			return -1;
+		memcpy(&frameIndex, data, sizeof(frameIndex));
+		memcpy(&layerCount, data + sizeof(frameIndex), sizeof(layerCount));
+
+		const char* read = data + sizeof(frameIndex) + sizeof(layerCount);
+		const char* end = data + size;
+		size_t reserved = m_Info.MinorVersion < 25 ? sizeof(ovrLayerHeader::Reserved) : 0;
+		const ovrLayerHeader* layerPtrs[ovrMaxLayerCount] = {};
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < layerCount; i++)
+		{
+			uint32_t layerSize;
+			if (read + sizeof(layerSize) > end)
+				return -1;
+			memcpy(&layerSize, read, sizeof(layerSize));
+			read += sizeof(layerSize);
+			if (read + layerSize > end)
+				return -1;
+
+			const char* source = read;
+			read += layerSize;
+			if (count >= ovrMaxLayerCount)
+			{
+				m_SkippedLayers++;
+				continue;
+			}
+
+			if (layerSize < sizeof(ovrLayerHeader) - reserved || layerSize + reserved > sizeof(ovrLayer_Union))
+			{
+				if (layerSize > 0)
+					m_SkippedLayers++;
+				count++;
+				continue;
+			}
+
+			char* layer = (char*)&m_Layers[count] + reserved;
+			memcpy(layer, source, layerSize);
+			if (MapTextures(layer, layerSize))
+				layerPtrs[count] = (const ovrLayerHeader*)layer;
+			else
+				m_SkippedLayers++;
+			count++;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		double sampleTime = 0.0;
+		uint32_t numLayers = TranslateLayers(*m_Arena, m_Info, nullptr, layerPtrs, count, &sampleTime);
+
+		XrFrameEndInfo endInfo = XR_TYPE(FRAME_END_INFO);
+		endInfo.displayTime = 1;
+		endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+		endInfo.layerCount = numLayers;
+		endInfo.layers = m_Arena->Headers;
+		Check(xrEndFrame(m_Session, &endInfo));
+		return Elapsed(start);
+	}
+
+	XrSession m_Session;
+	XrSpace m_ViewSpace;
+	XrSpace m_WorldSpace;
+	XrSwapchainImageBaseHeader m_Image;
+	std::map<uint64_t, std::unique_ptr<ovrTextureSwapChainData>> m_Chains;
+
+	SwapChainWaiter m_Waiter;
+	std::unique_ptr<LayerArena> m_Arena;
+	LayerTranslationInfo m_Info;
+	ovrLayer_Union m_Layers[ovrMaxLayerCount];
+
+	uint64_t m_SkippedLayers;
+	uint64_t m_Failed;
+};
+
+// Replays a recording written by the ReviveXR call recorder (REVIVE_RECORD_FILE) through the layer
+// translation, the swapchain wait thread and the frame loop against the headless mock runtime, and
+// reports the latency of each replayed call. The calls are replayed back to back unless a refresh
+// rate is given, in which case xrWaitFrame blocks until the next display period.
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <recording> [refresh rate]\n", argv[0]);
+		return 1;
+	}
+
+	FILE* file = fopen(argv[1], "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	RecordFileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != REV_RECORD_FILE_MAGIC)
+	{
+		fprintf(stderr, "%s is not a call recording\n", argv[1]);
+		fclose(file);
+		return 1;
+	}
+
+	if (header.Version != REV_RECORD_FILE_VERSION)
+	{
+		fprintf(stderr, "Unsupported recording version %u\n", header.Version);
+		fclose(file);
+		return 1;
+	}
+
+	// The layers contain the texture handles as they were passed by the app
+	if (header.PointerSize != sizeof(void*))
+	{
+		fprintf(stderr, "Recording has %u-bit pointers, replay it with a %u-bit build\n",
+			header.PointerSize * 8, (uint32_t)sizeof(void*) * 8);
+		fclose(file);
+		return 1;
+	}
+
+	double refreshRate = argc > 2 ? atof(argv[2]) : 0.0;
+	int64_t displayPeriod = refreshRate > 0.0 ? (int64_t)(1.0e9 / refreshRate) : 0;
+
+	std::vector<int64_t> times[CallCount];
+	uint64_t skipped = 0;
+	bool truncated = false;
+	{
+		CallReplay replay(header.MinorVersion, displayPeriod);
+		std::vector<char> data;
+		RecordHeader record;
+		while (fread(&record, sizeof(record), 1, file) == 1)
+		{
+			data.resize(record.Size);
+			if (record.Size > 0 && fread(data.data(), record.Size, 1, file) != 1)
+			{
+				truncated = true;
+				break;
+			}
+
+			int64_t time = replay.Replay(record.Call, data.data(), record.Size);
+			if (time >= 0 && record.Call < CallCount)
+				times[record.Call].push_back(time);
+			else
+				skipped++;
+		}
+		replay.Finish();
+
+		const LayerArena& arena = replay.GetArena();
+		printf("Replayed a LibOVR 1.%u recording with %zu swapchains%s\n", header.MinorVersion,
+			replay.GetChainCount(), displayPeriod ? "" : ", without waiting for the display");
+		printf("Layer cache: %llu hits, %llu misses, %llu layers skipped\n", (unsigned long long)arena.CacheHits,
+			(unsigned long long)arena.CacheMisses, (unsigned long long)replay.GetSkippedLayers());
+		if (replay.GetFailed() || MockRuntime::GetErrors())
+		{
+			printf("%llu calls failed, %llu of them were rejected by the mock runtime\n",
+				(unsigned long long)replay.GetFailed(), (unsigned long long)MockRuntime::GetErrors());
+		}
+	}
+	fclose(file);
+
+	printf("%-28s %10s %12s %12s %12s\n", "call", "count", "p50_us", "p99_us", "max_us");
+	for (size_t i = 0; i < CallCount; i++)
+	{
+		if (times[i].empty())
+			continue;
+
+		printf("%-28s %10zu %12.2f %12.2f %12.2f\n", CallNames[i], times[i].size(),
+			Percentile(times[i], 50.0), Percentile(times[i], 99.0), Percentile(times[i], 100.0));
+	}
+	if (skipped)
+		printf("%llu calls were not replayed, the mock runtime has no input actions for ovr_GetInputState\n", (unsigned long long)skipped);
+
+	if (truncated)
+	{
+		fprintf(stderr, "Recording is truncated\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include "SpikeDetector.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Decodes a capture written by the spike detector to CSV, one line per frame, oldest frame first.
+// Frames that exceed the spike threshold are flagged in the last column.
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <capture file> [output file]\n", argv[0]);
+		return 1;
+	}
+
+	FILE* file = fopen(argv[1], "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Failed to open %s\n", argv[1]);
+		return 1;
+	}
+
+	SpikeFileHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != REV_SPIKE_FILE_MAGIC)
+	{
+		fprintf(stderr, "%s is not a spike capture\n", argv[1]);
+		fclose(file);
+		return 1;
+	}
+
+	// Newer versions may only append fields to the frame records
+	if (header.Version > REV_SPIKE_FILE_VERSION || header.FrameSize < sizeof(SpikeFrame))
+	{
+		fprintf(stderr, "Unsupported capture version %u with %u byte frames\n", header.Version, header.FrameSize);
+		fclose(file);
+		return 1;
+	}
+
+	FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "Failed to open %s\n", argv[2]);
+		fclose(file);
+		return 1;
+	}
+
+	fprintf(out, "frame,interval_us,wait_us,begin_us,end_us,layers,commits,tracking_queries,input_queries,spike\n");
+
+	char record[UINT16_MAX];
+	uint32_t frames = 0;
+	for (; frames < header.FrameCount; frames++)
+	{
+		if (fread(record, header.FrameSize, 1, file) != 1)
+			break;
+
+		SpikeFrame frame;
+		memcpy(&frame, record, sizeof(frame));
+		bool spike = header.Threshold > 0 && frame.Interval > header.Threshold * REV_SPIKE_MARGIN;
+		fprintf(out, "%lld,%u,%u,%u,%u,%u,%u,%u,%u,%d\n", (long long)frame.FrameIndex, frame.Interval,
+			frame.WaitTime, frame.BeginTime, frame.EndTime, frame.Layers, frame.Commits,
+			frame.TrackingQueries, frame.InputQueries, spike);
+	}
+	fclose(file);
+	if (out != stdout)
+		fclose(out);
+
+	if (frames < header.FrameCount)
+	{
+		fprintf(stderr, "Capture is truncated, decoded %u of %u frames\n", frames, header.FrameCount);
+		return 1;
+	}
+	fprintf(stderr, "Decoded %u frames, spike threshold %u us\n", frames, header.Threshold);
+	return 0;
+}